@@ -28,6 +28,27 @@ west build -b native_sim "${APP_DIR}/tests/persist_state" -p auto \
     --build-dir build/tests/persist_state
 west build -t run --build-dir build/tests/persist_state
 
+info "Running native_sim benchmark: tests/persist_bench"
+west build -b native_sim "${APP_DIR}/tests/persist_bench" -p auto \
+    --build-dir build/tests/persist_bench
+west build -t run --build-dir build/tests/persist_bench
+
+info "Running native_sim benchmark: tests/persist_backend (nvs)"
+west build -b native_sim "${APP_DIR}/tests/persist_backend" -p auto \
+    --build-dir build/tests/persist_backend
+west build -t run --build-dir build/tests/persist_backend
+
+info "Running native_sim benchmark: tests/persist_backend (zms)"
+west build -b native_sim "${APP_DIR}/tests/persist_backend" -p auto \
+    --build-dir build/tests/persist_backend_zms \
+    -DOVERLAY_CONFIG=prj_zms.conf
+west build -t run --build-dir build/tests/persist_backend_zms
+
+info "Running native_sim tests: tests/event_log"
+west build -b native_sim "${APP_DIR}/tests/event_log" -p auto \
+    --build-dir build/tests/event_log
+west build -t run --build-dir build/tests/event_log
+
 info "Running native_sim tests: tests/supervisor"
 west build -b native_sim "${APP_DIR}/tests/supervisor" -p auto \
     --build-dir build/tests/supervisor
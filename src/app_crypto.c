@@ -21,16 +21,47 @@ LOG_MODULE_REGISTER(app_crypto, LOG_LEVEL_INF);
 #define APP_CRYPTO_MAX_KEY_BYTES 32U
 #define APP_CRYPTO_MAX_HEX_CHARS (APP_CRYPTO_MAX_KEY_BYTES * 2U)
 
+#if IS_ENABLED(CONFIG_APP_CRYPTO_REKEY)
+#define CRYPTO_SESSION_SLOTS 2U
+#define REKEY_FLAG_BUSY 0
+#define REKEY_FLAG_READY 1
+/* A pinned shadow slot is re-checked every millisecond, up to this often,
+ * then every REKEY_SLOT_BACKOFF_MS until it is released.
+ */
+#define REKEY_SLOT_RETRIES 100U
+#define REKEY_SLOT_BACKOFF_MS 100U
+#else
+#define CRYPTO_SESSION_SLOTS 1U
+#endif
+
+/* One AES schedule + MAC key per session. With runtime rekey enabled the
+ * second slot is the shadow that the background derivation writes into.
+ */
+struct crypto_session {
+	struct simple_aes_ctx aes;
+	uint8_t mac_key[16];
+	uint32_t counter;
+	uint32_t salt;
+};
+
 static uint8_t key_buf[APP_CRYPTO_MAX_KEY_BYTES];
 static size_t key_len;
 static uint8_t iv_seed[APP_CRYPTO_IV_LEN];
 static bool crypto_ready;
 static atomic_t iv_counter = ATOMIC_INIT(0);
 static atomic_t prng_state = ATOMIC_INIT(0x6d5a56a1);
-static struct simple_aes_ctx aes_ctx;
-static uint8_t session_mac_key[16];
-static uint32_t session_counter;
-static uint32_t session_salt;
+static struct crypto_session sessions[CRYPTO_SESSION_SLOTS];
+static atomic_t active_slot = ATOMIC_INIT(0);
+
+#if IS_ENABLED(CONFIG_APP_CRYPTO_REKEY)
+static atomic_t slot_users[CRYPTO_SESSION_SLOTS];
+static atomic_t rekey_flags = ATOMIC_INIT(0);
+static uint8_t shared_secret[CURVE25519_KEY_SIZE];
+static uint32_t rekey_msg_count;
+static uint32_t rekey_slot_waits; /* only touched by rekey_work */
+static struct k_work_delayable rekey_work;
+static struct k_work_delayable rekey_timer_work;
+#endif
 
 static enum app_crypto_backend_type active_backend = APP_CRYPTO_BACKEND_TYPE_NONE;
 
@@ -128,7 +159,38 @@ static void increment_counter(uint8_t *counter)
 	}
 }
 
-static void ctr_process(const uint8_t *input, uint8_t *output, size_t len,
+/* Pin the active session for the duration of one encrypt/decrypt/MAC call.
+ * The user count is re-checked against the active index so the rekey worker
+ * never rewrites a slot that a concurrent caller is still reading.
+ */
+static const struct crypto_session *session_acquire(void)
+{
+#if IS_ENABLED(CONFIG_APP_CRYPTO_REKEY)
+	while (true) {
+		atomic_val_t slot = atomic_get(&active_slot);
+
+		(void)atomic_inc(&slot_users[slot]);
+		if (atomic_get(&active_slot) == slot) {
+			return &sessions[slot];
+		}
+		(void)atomic_dec(&slot_users[slot]);
+	}
+#else
+	return &sessions[0];
+#endif
+}
+
+static void session_release(const struct crypto_session *session)
+{
+#if IS_ENABLED(CONFIG_APP_CRYPTO_REKEY)
+	(void)atomic_dec(&slot_users[session - sessions]);
+#else
+	ARG_UNUSED(session);
+#endif
+}
+
+static void ctr_process(const struct crypto_session *session,
+			const uint8_t *input, uint8_t *output, size_t len,
 			const uint8_t iv[APP_CRYPTO_IV_LEN])
 {
 	uint8_t counter[APP_CRYPTO_AES_BLOCK_BYTES] = {0};
@@ -137,7 +199,7 @@ static void ctr_process(const uint8_t *input, uint8_t *output, size_t len,
 	safe_memcpy(counter, sizeof(counter), iv, APP_CRYPTO_IV_LEN);
 
 	while (len > 0U) {
-		simple_aes_encrypt_block(&aes_ctx, counter, stream);
+		simple_aes_encrypt_block(&session->aes, counter, stream);
 
 		size_t chunk = MIN(len, (size_t)APP_CRYPTO_AES_BLOCK_BYTES);
 		for (size_t i = 0U; i < chunk; i++) {
@@ -160,27 +222,93 @@ static uint32_t fallback_session_salt(void)
 	return seed;
 }
 
-static void derive_session_material(const uint8_t *shared, size_t shared_len)
+/* Returns -EIO without touching key_buf when no counter could be leased:
+ * a key derived from counter 0 could repeat one from an earlier boot.
+ */
+static int derive_session_material(const uint8_t *shared, size_t shared_len,
+				   struct crypto_session *session)
 {
-	session_counter = persist_state_next_session_counter();
-	session_salt = fallback_session_salt();
+	uint32_t counter = persist_state_next_session_counter();
+
+	if (counter == 0U) {
+		LOG_EVT(ERR, "PQC", "SESSION_FAIL", "reason=no_counter");
+		return -EIO;
+	}
+
+	session->counter = counter;
+	session->salt = fallback_session_salt();
 
 	for (size_t i = 0U; i < APP_CRYPTO_MAX_KEY_BYTES; i++) {
-		uint8_t ctr = (uint8_t)((session_counter >> ((i % 4U) * 8U)) & 0xFFU);
-		uint8_t saltb = (uint8_t)((session_salt >> (((i + 1U) % 4U) * 8U)) & 0xFFU);
+		uint8_t ctr = (uint8_t)((session->counter >> ((i % 4U) * 8U)) & 0xFFU);
+		uint8_t saltb = (uint8_t)((session->salt >> (((i + 1U) % 4U) * 8U)) & 0xFFU);
 		key_buf[i] = shared[i % shared_len] ^ ctr ^ saltb;
 	}
 
-	for (size_t i = 0U; i < sizeof(session_mac_key); i++) {
-		uint8_t ctr = (uint8_t)((session_counter >> (((i + 2U) % 4U) * 8U)) & 0xFFU);
-		uint8_t saltb = (uint8_t)((session_salt >> (((i + 3U) % 4U) * 8U)) & 0xFFU);
-		session_mac_key[i] = shared[(i + 8U) % shared_len] ^ ctr ^ saltb;
+	for (size_t i = 0U; i < sizeof(session->mac_key); i++) {
+		uint8_t ctr = (uint8_t)((session->counter >> (((i + 2U) % 4U) * 8U)) & 0xFFU);
+		uint8_t saltb = (uint8_t)((session->salt >> (((i + 3U) % 4U) * 8U)) & 0xFFU);
+		session->mac_key[i] = shared[(i + 8U) % shared_len] ^ ctr ^ saltb;
 	}
 
 	LOG_EVT(INF, "PQC", "SESSION", "counter=%" PRIu32 ",salt=0x%08X",
-		session_counter, session_salt);
+		session->counter, session->salt);
+	return 0;
 }
 
+#if IS_ENABLED(CONFIG_APP_CRYPTO_REKEY)
+static void rekey_work_handler(struct k_work *work)
+{
+	ARG_UNUSED(work);
+
+	atomic_val_t shadow = 1 - atomic_get(&active_slot);
+	struct crypto_session *next = &sessions[shadow];
+
+	/* A caller pinned this slot before the previous swap. It may have a
+	 * lower priority than the workqueue, so come back later instead of
+	 * spinning here. No counter is drawn until the slot is free, so the
+	 * wait never burns one.
+	 */
+	if (atomic_get(&slot_users[shadow]) != 0) {
+		if (rekey_slot_waits < REKEY_SLOT_RETRIES) {
+			rekey_slot_waits++;
+			k_work_schedule_for_queue(&k_sys_work_q, &rekey_work, K_MSEC(1));
+			return;
+		}
+		if (rekey_slot_waits == REKEY_SLOT_RETRIES) {
+			rekey_slot_waits++;
+			LOG_EVT(WRN, "PQC", "REKEY_DEFER", "reason=slot_busy");
+		}
+		k_work_schedule_for_queue(&k_sys_work_q, &rekey_work,
+					  K_MSEC(REKEY_SLOT_BACKOFF_MS));
+		return;
+	}
+	rekey_slot_waits = 0U;
+
+	if (derive_session_material(shared_secret, sizeof(shared_secret), next) != 0 ||
+	    simple_aes_setkey_enc(&next->aes, key_buf, key_len) != 0) {
+		LOG_EVT(ERR, "PQC", "REKEY_FAIL", "counter=%" PRIu32, next->counter);
+		atomic_clear_bit(&rekey_flags, REKEY_FLAG_BUSY);
+		return;
+	}
+
+	atomic_set_bit(&rekey_flags, REKEY_FLAG_READY);
+	LOG_DBG("Rekey staged in slot %ld (counter=%" PRIu32 ")", (long)shadow, next->counter);
+}
+
+static void rekey_timer_handler(struct k_work *work)
+{
+	ARG_UNUSED(work);
+
+	int rc = app_crypto_request_rekey();
+	if (rc != 0 && rc != -EALREADY) {
+		LOG_WRN("Scheduled rekey skipped: %d", rc);
+	}
+
+	k_work_schedule_for_queue(&k_sys_work_q, &rekey_timer_work,
+				  K_MSEC(CONFIG_APP_CRYPTO_REKEY_INTERVAL_MS));
+}
+#endif
+
 bool app_crypto_is_enabled(void)
 {
 	return crypto_ready && (active_backend != APP_CRYPTO_BACKEND_TYPE_NONE);
@@ -193,12 +321,53 @@ enum app_crypto_backend_type app_crypto_get_backend(void)
 
 uint32_t app_crypto_get_session_counter(void)
 {
-	return session_counter;
+	return sessions[atomic_get(&active_slot)].counter;
 }
 
 uint32_t app_crypto_get_session_salt(void)
 {
-	return session_salt;
+	return sessions[atomic_get(&active_slot)].salt;
+}
+
+int app_crypto_request_rekey(void)
+{
+#if IS_ENABLED(CONFIG_APP_CRYPTO_REKEY)
+	if (!crypto_ready || active_backend != APP_CRYPTO_BACKEND_TYPE_CURVE25519) {
+		return -EACCES;
+	}
+
+	if (atomic_test_and_set_bit(&rekey_flags, REKEY_FLAG_BUSY)) {
+		return -EALREADY;
+	}
+
+	k_work_schedule_for_queue(&k_sys_work_q, &rekey_work, K_NO_WAIT);
+	return 0;
+#else
+	return -ENOTSUP;
+#endif
+}
+
+void app_crypto_message_boundary(void)
+{
+#if IS_ENABLED(CONFIG_APP_CRYPTO_REKEY)
+	if (atomic_test_and_clear_bit(&rekey_flags, REKEY_FLAG_READY)) {
+		atomic_val_t next = 1 - atomic_get(&active_slot);
+
+		atomic_set(&active_slot, next);
+		rekey_msg_count = 0U;
+		atomic_clear_bit(&rekey_flags, REKEY_FLAG_BUSY);
+		LOG_EVT(INF, "PQC", "REKEY", "counter=%" PRIu32 ",salt=0x%08X",
+			sessions[next].counter, sessions[next].salt);
+	}
+
+	if (CONFIG_APP_CRYPTO_REKEY_SAMPLE_COUNT > 0) {
+		rekey_msg_count++;
+		if (rekey_msg_count >= (uint32_t)CONFIG_APP_CRYPTO_REKEY_SAMPLE_COUNT) {
+			rekey_msg_count = 0U;
+			(void)app_crypto_request_rekey();
+		}
+	}
+#endif
 }
 
 int app_crypto_init(void)
@@ -242,7 +411,15 @@ int app_crypto_init(void)
 	}
 
 	key_len = CURVE25519_KEY_SIZE;
-	derive_session_material(shared, CURVE25519_KEY_SIZE);
+	rc = derive_session_material(shared, CURVE25519_KEY_SIZE, &sessions[0]);
+	if (rc != 0) {
+		return rc;
+	}
+#if IS_ENABLED(CONFIG_APP_CRYPTO_REKEY)
+	safe_memcpy(shared_secret, sizeof(shared_secret), shared, sizeof(shared));
+	k_work_init_delayable(&rekey_work, rekey_work_handler);
+	k_work_init_delayable(&rekey_timer_work, rekey_timer_handler);
+#endif
 
 	uint8_t local_pub[CURVE25519_KEY_SIZE];
 	curve25519_ref10_scalarmult_base(local_pub, secret);
@@ -266,9 +443,9 @@ int app_crypto_init(void)
 		LOG_ERR("Unsupported AES key length: %zu", key_len);
 		return -EINVAL;
 	}
-	session_counter = 0U;
-	session_salt = 0U;
-	memset(session_mac_key, 0, sizeof(session_mac_key));
+	sessions[0].counter = 0U;
+	sessions[0].salt = 0U;
+	memset(sessions[0].mac_key, 0, sizeof(sessions[0].mac_key));
 	LOG_INF("AES-only backend active (static key from config)");
 #else
 	active_backend = APP_CRYPTO_BACKEND_TYPE_NONE;
@@ -277,13 +454,20 @@ int app_crypto_init(void)
 	return 0;
 #endif
 
-	rc = simple_aes_setkey_enc(&aes_ctx, key_buf, key_len);
+	rc = simple_aes_setkey_enc(&sessions[0].aes, key_buf, key_len);
 	if (rc != 0) {
 		LOG_ERR("AES key setup failed");
 		return -EINVAL;
 	}
 
 	crypto_ready = true;
+#if IS_ENABLED(CONFIG_APP_CRYPTO_REKEY)
+	if (active_backend == APP_CRYPTO_BACKEND_TYPE_CURVE25519 &&
+	    CONFIG_APP_CRYPTO_REKEY_INTERVAL_MS > 0) {
+		k_work_schedule_for_queue(&k_sys_work_q, &rekey_timer_work,
+					  K_MSEC(CONFIG_APP_CRYPTO_REKEY_INTERVAL_MS));
+	}
+#endif
 	LOG_INF("AES helper initialized (key_len=%zu, backend=%s)", key_len,
 		active_backend == APP_CRYPTO_BACKEND_TYPE_CURVE25519 ? "curve25519" : "aes");
 	return 0;
@@ -306,10 +490,12 @@ int app_crypto_encrypt_buffer(const uint8_t *input, size_t input_len,
 	}
 
 	uint8_t iv_tmp[APP_CRYPTO_IV_LEN];
+	const struct crypto_session *session = session_acquire();
 
 	generate_iv(iv_tmp);
 
-	ctr_process(input, cipher_out, input_len, iv_tmp);
+	ctr_process(session, input, cipher_out, input_len, iv_tmp);
+	session_release(session);
 	safe_memcpy(iv_out, APP_CRYPTO_IV_LEN, iv_tmp, APP_CRYPTO_IV_LEN);
 	if (cipher_len != NULL) {
 		*cipher_len = input_len;
@@ -335,7 +521,10 @@ int app_crypto_decrypt_buffer(const uint8_t *cipher, size_t cipher_len,
 		return -ENOSPC;
 	}
 
-	ctr_process(cipher, plain_out, cipher_len, iv);
+	const struct crypto_session *session = session_acquire();
+
+	ctr_process(session, cipher, plain_out, cipher_len, iv);
+	session_release(session);
 
 	if (plain_len != NULL) {
 		*plain_len = cipher_len;
@@ -369,10 +558,49 @@ uint32_t app_crypto_compute_sample_mac(const uint8_t iv[APP_CRYPTO_IV_LEN],
 		return 0U;
 	}
 
-	uint32_t crc = crc32_ieee(session_mac_key, sizeof(session_mac_key));
+	const struct crypto_session *session = session_acquire();
+	uint32_t crc = crc32_ieee(session->mac_key, sizeof(session->mac_key));
 	crc = crc32_ieee_update(crc, iv, APP_CRYPTO_IV_LEN);
 	crc = crc32_ieee_update(crc, cipher, cipher_len);
-	crc = crc32_ieee_update(crc, (uint8_t *)&session_counter, sizeof(session_counter));
-	crc ^= session_salt;
+	crc = crc32_ieee_update(crc, (const uint8_t *)&session->counter,
+				sizeof(session->counter));
+	crc ^= session->salt;
+	session_release(session);
 	return crc;
 }
+
+#if defined(CONFIG_ZTEST)
+static const struct crypto_session *test_pinned;
+
+void app_crypto_test_pin_session(void)
+{
+	test_pinned = session_acquire();
+}
+
+void app_crypto_test_unpin_session(void)
+{
+	if (test_pinned != NULL) {
+		session_release(test_pinned);
+		test_pinned = NULL;
+	}
+}
+
+void app_crypto_test_forget(void)
+{
+	crypto_ready = false;
+#if IS_ENABLED(CONFIG_APP_CRYPTO_REKEY)
+	(void)k_work_cancel_delayable(&rekey_work);
+	(void)k_work_cancel_delayable(&rekey_timer_work);
+	atomic_clear(&rekey_flags);
+	rekey_msg_count = 0U;
+	rekey_slot_waits = 0U;
+	for (size_t i = 0U; i < CRYPTO_SESSION_SLOTS; i++) {
+		atomic_clear(&slot_users[i]);
+	}
+#endif
+	test_pinned = NULL;
+	atomic_set(&active_slot, 0);
+	safe_memset(sessions, sizeof(sessions), 0, sizeof(sessions));
+	safe_memset(key_buf, sizeof(key_buf), 0, sizeof(key_buf));
+}
+#endif
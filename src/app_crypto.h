@@ -21,6 +21,13 @@ enum app_crypto_backend_type app_crypto_get_backend(void);
 uint32_t app_crypto_get_session_counter(void);
 uint32_t app_crypto_get_session_salt(void);
 
+/* Runtime rekey (CONFIG_APP_CRYPTO_REKEY). The request derives the next
+ * session in the background; the swap happens at the next message boundary
+ * so a frame is never sealed and MAC'd under two different sessions.
+ */
+int app_crypto_request_rekey(void);
+void app_crypto_message_boundary(void);
+
 int app_crypto_encrypt_buffer(const uint8_t *input, size_t input_len,
 			      uint8_t *cipher_out, size_t cipher_capacity,
 			      size_t *cipher_len, uint8_t iv_out[APP_CRYPTO_IV_LEN]);
@@ -36,4 +43,14 @@ int app_crypto_bytes_to_hex(const uint8_t *src, size_t src_len,
 uint32_t app_crypto_compute_sample_mac(const uint8_t iv[APP_CRYPTO_IV_LEN],
 				       const uint8_t *cipher, size_t cipher_len);
 
+#if defined(CONFIG_ZTEST)
+/* Holds the active session as an encrypt call in progress would. */
+void app_crypto_test_pin_session(void);
+void app_crypto_test_unpin_session(void);
+/* Drops the session keys as a reset would; app_crypto_init() derives new
+ * ones from a fresh counter.
+ */
+void app_crypto_test_forget(void);
+#endif
+
 #endif /* APP_CRYPTO_H */
@@ -0,0 +1,347 @@
+#include "event_log.h"
+#include "log_utils.h"
+
+#include <errno.h>
+
+#include <zephyr/drivers/flash.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/storage/flash_map.h>
+#include <zephyr/sys/atomic.h>
+
+LOG_MODULE_REGISTER(event_log, LOG_LEVEL_INF);
+
+#define EVENT_LOG_NODE DT_NODELABEL(event_log_partition)
+#define EVENT_LOG_ERASED 0xFFFFFFFFU
+#define EVENT_LOG_REC_SIZE sizeof(struct event_log_record)
+/* Let the deferred log backend drain during a bulk dump. */
+#define EVENT_LOG_DUMP_BATCH 8U
+
+BUILD_ASSERT((sizeof(struct event_log_record) % 4U) == 0U,
+	     "event log records must stay word aligned");
+
+struct event_log_pending {
+	uint32_t uptime_ms;
+	uint32_t arg;
+	uint16_t id;
+};
+
+/* The log is a ring of erase sectors. write_off is the next free slot;
+ * entering a sector erases it, which drops that sector's oldest records.
+ */
+static struct {
+	const struct flash_area *fa;
+	uint32_t sector_size;
+	uint32_t sector_count;
+	uint32_t write_off;
+	uint32_t next_seq;
+	uint16_t boot;
+	bool ready;
+} g_log;
+
+static atomic_t dropped = ATOMIC_INIT(0);
+
+K_MSGQ_DEFINE(event_log_q, sizeof(struct event_log_pending),
+	      CONFIG_APP_EVENT_LOG_QUEUE_DEPTH, 4);
+static K_MUTEX_DEFINE(log_lock);
+
+static void event_log_work_handler(struct k_work *work);
+static K_WORK_DEFINE(event_log_work, event_log_work_handler);
+
+static const char *const event_names[EVENT_LOG_ID_COUNT] = {
+	[EVENT_LOG_BOOT] = "BOOT",
+	[EVENT_LOG_SAFE_MODE_ENTER] = "SAFE_MODE",
+	[EVENT_LOG_RECOVERY_REBOOT] = "RECOVERY",
+	[EVENT_LOG_WATCHDOG_FEED_FAIL] = "FEED_FAIL",
+	[EVENT_LOG_WATCHDOG_OVERRIDE] = "OVERRIDE",
+	[EVENT_LOG_PROVISION_SECRET] = "PROV_SECRET",
+	[EVENT_LOG_PROVISION_PEER] = "PROV_PEER",
+	[EVENT_LOG_PERSIST_TAMPER] = "TAMPER",
+	[EVENT_LOG_WATCHDOG_PREEMPT] = "PREEMPT",
+};
+
+static const char *event_name(uint16_t id)
+{
+	if (id < EVENT_LOG_ID_COUNT && event_names[id] != NULL) {
+		return event_names[id];
+	}
+	return "UNKNOWN";
+}
+
+static uint32_t slots_per_sector(void)
+{
+	return g_log.sector_size / EVENT_LOG_REC_SIZE;
+}
+
+static int read_slot(uint32_t off, struct event_log_record *rec)
+{
+	return flash_area_read(g_log.fa, (off_t)off, rec, sizeof(*rec));
+}
+
+/* Find the newest sector by the sequence number of its first record, then
+ * the first erased slot inside it.
+ */
+static int event_log_scan_locked(void)
+{
+	struct event_log_record rec;
+	uint32_t head = 0U;
+	uint32_t head_seq = 0U;
+	bool found = false;
+
+	for (uint32_t s = 0U; s < g_log.sector_count; s++) {
+		int rc = read_slot(s * g_log.sector_size, &rec);
+
+		if (rc != 0) {
+			return rc;
+		}
+		if (rec.seq != EVENT_LOG_ERASED &&
+		    (!found || (int32_t)(rec.seq - head_seq) > 0)) {
+			head = s;
+			head_seq = rec.seq;
+			found = true;
+		}
+	}
+
+	g_log.write_off = 0U;
+	g_log.next_seq = 1U;
+	g_log.boot = 1U;
+	if (!found) {
+		return 0;
+	}
+
+	struct event_log_record last = {0};
+	uint32_t base = head * g_log.sector_size;
+	uint32_t slot;
+
+	for (slot = 0U; slot < slots_per_sector(); slot++) {
+		int rc = read_slot(base + (slot * EVENT_LOG_REC_SIZE), &rec);
+
+		if (rc != 0) {
+			return rc;
+		}
+		if (rec.seq == EVENT_LOG_ERASED) {
+			break;
+		}
+		last = rec;
+	}
+
+	g_log.write_off = base + (slot * EVENT_LOG_REC_SIZE);
+	g_log.next_seq = last.seq + 1U;
+	g_log.boot = (uint16_t)(last.boot + 1U);
+	return 0;
+}
+
+/* One word-aligned program operation per record; the only other flash
+ * operation is the sector erase when the ring moves on.
+ */
+static int event_log_write_locked(const struct event_log_pending *pending)
+{
+	uint32_t size = g_log.sector_size * g_log.sector_count;
+	int rc;
+
+	if (g_log.write_off >= size) {
+		g_log.write_off = 0U;
+	}
+
+	if ((g_log.write_off % g_log.sector_size) == 0U) {
+		rc = flash_area_erase(g_log.fa, (off_t)g_log.write_off, g_log.sector_size);
+		if (rc != 0) {
+			return rc;
+		}
+	}
+
+	struct event_log_record rec = {
+		.seq = g_log.next_seq,
+		.uptime_ms = pending->uptime_ms,
+		.arg = pending->arg,
+		.id = pending->id,
+		.boot = g_log.boot,
+	};
+
+	rc = flash_area_write(g_log.fa, (off_t)g_log.write_off, &rec, sizeof(rec));
+	if (rc != 0) {
+		return rc;
+	}
+
+	g_log.write_off += EVENT_LOG_REC_SIZE;
+	g_log.next_seq++;
+	return 0;
+}
+
+static void event_log_drain(void)
+{
+	struct event_log_pending pending;
+
+	k_mutex_lock(&log_lock, K_FOREVER);
+
+	while (g_log.ready && k_msgq_get(&event_log_q, &pending, K_NO_WAIT) == 0) {
+		int rc = event_log_write_locked(&pending);
+
+		if (rc != 0) {
+			LOG_EVT(ERR, "EVLOG", "WRITE_FAIL", "rc=%d,id=%u", rc, pending.id);
+			break;
+		}
+	}
+
+	k_mutex_unlock(&log_lock);
+}
+
+static void event_log_work_handler(struct k_work *work)
+{
+	ARG_UNUSED(work);
+	event_log_drain();
+}
+
+int event_log_init(void)
+{
+	struct flash_pages_info page_info;
+	int rc;
+
+	k_mutex_lock(&log_lock, K_FOREVER);
+
+	if (g_log.ready) {
+		k_mutex_unlock(&log_lock);
+		return 0;
+	}
+
+	rc = flash_area_open(DT_FIXED_PARTITION_ID(EVENT_LOG_NODE), &g_log.fa);
+	if (rc == 0) {
+		rc = flash_get_page_info_by_offs(g_log.fa->fa_dev, g_log.fa->fa_off, &page_info);
+	}
+	if (rc == 0 && (EVENT_LOG_REC_SIZE % flash_area_align(g_log.fa)) != 0U) {
+		rc = -EINVAL;
+	}
+	if (rc == 0) {
+		g_log.sector_size = page_info.size;
+		g_log.sector_count = g_log.fa->fa_size / page_info.size;
+		rc = (g_log.sector_count >= 2U) ? event_log_scan_locked() : -ENOSPC;
+	}
+
+	if (rc != 0) {
+		LOG_EVT(ERR, "EVLOG", "INIT_FAIL", "rc=%d", rc);
+		k_mutex_unlock(&log_lock);
+		return rc;
+	}
+
+	g_log.ready = true;
+	LOG_EVT(INF, "EVLOG", "READY", "boot=%u,seq=%u,sectors=%ux%u", g_log.boot,
+		g_log.next_seq, g_log.sector_count, g_log.sector_size);
+	k_mutex_unlock(&log_lock);
+
+	/* Records appended before init were queued; write them now. */
+	(void)k_work_submit(&event_log_work);
+	return 0;
+}
+
+void event_log_append(enum event_log_id id, uint32_t arg)
+{
+	struct event_log_pending pending = {
+		.uptime_ms = k_uptime_get_32(),
+		.arg = arg,
+		.id = (uint16_t)id,
+	};
+
+	if (k_msgq_put(&event_log_q, &pending, K_NO_WAIT) != 0) {
+		(void)atomic_inc(&dropped);
+		return;
+	}
+
+	(void)k_work_submit(&event_log_work);
+}
+
+void event_log_flush(void)
+{
+	event_log_drain();
+}
+
+/* Only the ring position is taken under log_lock. Records are read and
+ * handed to cb without it, so a slow callback never stalls the drain on
+ * the system workqueue. Anything appended meanwhile carries a sequence
+ * number at or past the snapshot and is skipped; a record whose sector
+ * is erased meanwhile reads back as erased and is skipped too.
+ */
+int event_log_walk(event_log_walk_cb cb, void *user_data)
+{
+	struct event_log_record rec;
+	int count = 0;
+
+	k_mutex_lock(&log_lock, K_FOREVER);
+
+	if (!g_log.ready) {
+		k_mutex_unlock(&log_lock);
+		return -EAGAIN;
+	}
+
+	/* Oldest data starts at the next sector boundary at or after the write
+	 * position: that sector is the next one to be erased.
+	 */
+	uint32_t total = g_log.sector_count * slots_per_sector();
+	uint32_t write_slot = (g_log.write_off / EVENT_LOG_REC_SIZE) % total;
+	uint32_t first = ROUND_UP(write_slot, slots_per_sector()) % total;
+	uint32_t end_seq = g_log.next_seq;
+
+	k_mutex_unlock(&log_lock);
+
+	for (uint32_t i = 0U; i < total; i++) {
+		uint32_t slot = (first + i) % total;
+
+		if (i > 0U && slot == write_slot) {
+			break;
+		}
+
+		uint32_t off = slot * EVENT_LOG_REC_SIZE;
+
+		if (read_slot(off, &rec) != 0 || rec.seq == EVENT_LOG_ERASED ||
+		    (int32_t)(rec.seq - end_seq) >= 0) {
+			continue;
+		}
+
+		cb(&rec, user_data);
+		count++;
+	}
+
+	return count;
+}
+
+static void dump_record(const struct event_log_record *rec, void *user_data)
+{
+	uint32_t *count = user_data;
+
+	LOG_EVT(INF, "EVLOG", "REC", "seq=%u,boot=%u,ms=%u,id=%s,arg=0x%08x",
+		rec->seq, rec->boot, rec->uptime_ms, event_name(rec->id), rec->arg);
+
+	if ((++(*count) % EVENT_LOG_DUMP_BATCH) == 0U) {
+		k_msleep(1);
+	}
+}
+
+void event_log_dump(void)
+{
+	uint32_t count = 0U;
+
+	event_log_flush();
+	LOG_EVT(INF, "EVLOG", "BEGIN", "boot=%u,next_seq=%u,dropped=%u", g_log.boot,
+		g_log.next_seq, (uint32_t)atomic_get(&dropped));
+	int rc = event_log_walk(dump_record, &count);
+
+	LOG_EVT(INF, "EVLOG", "END", "rc=%d,count=%u", (rc < 0) ? rc : 0, count);
+}
+
+#if defined(CONFIG_ZTEST)
+void event_log_test_erase(void)
+{
+	event_log_init();
+	k_mutex_lock(&log_lock, K_FOREVER);
+	k_msgq_purge(&event_log_q);
+	(void)flash_area_erase(g_log.fa, 0, g_log.fa->fa_size);
+	(void)event_log_scan_locked();
+	k_mutex_unlock(&log_lock);
+}
+
+void event_log_test_reload(void)
+{
+	k_mutex_lock(&log_lock, K_FOREVER);
+	(void)event_log_scan_locked();
+	k_mutex_unlock(&log_lock);
+}
+#endif
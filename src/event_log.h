@@ -0,0 +1,66 @@
+#ifndef EVENT_LOG_H
+#define EVENT_LOG_H
+
+#include <stdint.h>
+
+#include <zephyr/sys/util.h>
+
+/* Persistent append-only event log (CONFIG_APP_EVENT_LOG). IDs are stored on
+ * flash; only append new values.
+ */
+enum event_log_id {
+	EVENT_LOG_BOOT = 1,          /* arg: hwinfo reset cause */
+	EVENT_LOG_SAFE_MODE_ENTER,   /* arg: consecutive watchdog resets */
+	EVENT_LOG_RECOVERY_REBOOT,   /* arg: enum recovery_reason */
+	EVENT_LOG_WATCHDOG_FEED_FAIL,/* arg: errno (negated) */
+	EVENT_LOG_WATCHDOG_OVERRIDE, /* arg: timeout ms (0 = cleared) */
+	EVENT_LOG_PROVISION_SECRET,
+	EVENT_LOG_PROVISION_PEER,
+	EVENT_LOG_PERSIST_TAMPER,    /* arg: record ID that failed to decrypt */
+	EVENT_LOG_WATCHDOG_PREEMPT,  /* arg: ms since the last feed */
+	EVENT_LOG_ID_COUNT
+};
+
+/* On-flash record: 16 bytes, a multiple of every supported write block. */
+struct event_log_record {
+	uint32_t seq;       /* 0xFFFFFFFF = erased slot */
+	uint32_t uptime_ms;
+	uint32_t arg;
+	uint16_t id;
+	uint16_t boot;
+};
+
+typedef void (*event_log_walk_cb)(const struct event_log_record *rec, void *user_data);
+
+#if IS_ENABLED(CONFIG_APP_EVENT_LOG)
+int event_log_init(void);
+/* Safe from any context, including ISRs: only queues the record. */
+void event_log_append(enum event_log_id id, uint32_t arg);
+/* Write all queued records now (pre-reboot paths). */
+void event_log_flush(void);
+/* Visit stored records oldest to newest; returns the number visited. */
+int event_log_walk(event_log_walk_cb cb, void *user_data);
+void event_log_dump(void);
+
+#if defined(CONFIG_ZTEST)
+void event_log_test_erase(void);
+void event_log_test_reload(void);
+#endif
+#else
+static inline int event_log_init(void)
+{
+	return 0;
+}
+
+static inline void event_log_append(enum event_log_id id, uint32_t arg)
+{
+	ARG_UNUSED(id);
+	ARG_UNUSED(arg);
+}
+
+static inline void event_log_flush(void)
+{
+}
+#endif
+
+#endif /* EVENT_LOG_H */
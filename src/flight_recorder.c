@@ -0,0 +1,198 @@
+#include <errno.h>
+#include <stddef.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/sys/crc.h>
+#include <zephyr/sys/util.h>
+
+#if defined(CONFIG_ARM)
+#include <zephyr/linker/linker-defs.h>
+#endif
+
+#include "flight_recorder.h"
+#include "log_utils.h"
+#include "safe_memory.h"
+
+LOG_MODULE_REGISTER(flight_recorder, LOG_LEVEL_INF);
+
+#define FLIGHT_ENTRIES CONFIG_APP_FLIGHT_RECORDER_ENTRIES
+#define FLIGHT_MAGIC 0x464C4954u /* 'FLIT' */
+
+BUILD_ASSERT(IS_POWER_OF_TWO(FLIGHT_ENTRIES), "flight recorder size must be a power of two");
+
+/* Tag and status are string literals; entries store them as offsets from
+ * this anchor so they fit 32 bits on every target. The anchor address also
+ * identifies the image that wrote the ring.
+ */
+static const char flight_anchor[] = "FLIGHT";
+
+/* 24 bytes. check is an XOR of the other words: a full CRC per entry would
+ * cost far more than the few cycles recording is allowed, and a torn entry
+ * (reset or preemption mid-write) still fails it.
+ */
+struct flight_entry {
+	uint32_t uptime_ms;
+	int32_t tag;
+	int32_t status;
+	uint32_t arg[2];
+	uint32_t check;
+};
+
+BUILD_ASSERT(sizeof(struct flight_entry) == 24, "flight entry size is documented as 24 B");
+
+struct flight_ring {
+	uint32_t magic;
+	uint32_t image;
+	uint32_t hdr_crc;
+	atomic_t head; /* entries ever written; slot = head % FLIGHT_ENTRIES */
+	struct flight_entry entries[FLIGHT_ENTRIES];
+};
+
+/* Survives warm and IWDG resets; validated before use. */
+static __noinit struct flight_ring ring;
+static atomic_t armed = ATOMIC_INIT(0);
+
+static uint32_t image_tag(void)
+{
+	return (uint32_t)(uintptr_t)flight_anchor;
+}
+
+static uint32_t header_crc(void)
+{
+	return crc32_ieee((const uint8_t *)&ring, offsetof(struct flight_ring, hdr_crc));
+}
+
+static uint32_t entry_check(const struct flight_entry *e)
+{
+	return FLIGHT_MAGIC ^ e->uptime_ms ^ (uint32_t)e->tag ^ (uint32_t)e->status ^
+	       e->arg[0] ^ e->arg[1];
+}
+
+static int32_t to_offset(const char *str)
+{
+	return (int32_t)((intptr_t)str - (intptr_t)flight_anchor);
+}
+
+/* NULL unless the offset points into this image's read-only data. */
+static const char *from_offset(int32_t offset)
+{
+	const char *str = flight_anchor + offset;
+
+#if defined(CONFIG_ARM)
+	if (str < __rodata_region_start || str >= __rodata_region_end) {
+		return NULL;
+	}
+#endif
+	return str;
+}
+
+void flight_record(const char *tag, const char *status, uint32_t arg0, uint32_t arg1)
+{
+	if (atomic_get(&armed) == 0) {
+		return;
+	}
+
+	uint32_t slot = (uint32_t)atomic_inc(&ring.head) & (FLIGHT_ENTRIES - 1U);
+	struct flight_entry *e = &ring.entries[slot];
+
+	e->uptime_ms = k_uptime_get_32();
+	e->tag = to_offset(tag);
+	e->status = to_offset(status);
+	e->arg[0] = arg0;
+	e->arg[1] = arg1;
+	e->check = entry_check(e);
+}
+
+int flight_recorder_walk(flight_walk_cb cb, void *user_data)
+{
+	uint32_t head = (uint32_t)atomic_get(&ring.head);
+	uint32_t count = MIN(head, FLIGHT_ENTRIES);
+	int visited = 0;
+
+	for (uint32_t i = head - count; i != head; i++) {
+		const struct flight_entry *e = &ring.entries[i & (FLIGHT_ENTRIES - 1U)];
+		struct flight_event ev = {
+			.uptime_ms = e->uptime_ms,
+			.tag = from_offset(e->tag),
+			.status = from_offset(e->status),
+			.arg = { e->arg[0], e->arg[1] },
+		};
+
+		if (e->check != entry_check(e) || ev.tag == NULL || ev.status == NULL) {
+			continue;
+		}
+
+		if (cb != NULL) {
+			cb(&ev, user_data);
+		}
+		visited++;
+	}
+
+	return visited;
+}
+
+static void dump_event(const struct flight_event *ev, void *user_data)
+{
+	ARG_UNUSED(user_data);
+
+	LOG_EVT(INF, "FLIGHT", "REC", "t=%u,evt=%s/%s,a0=0x%08x,a1=0x%08x", ev->uptime_ms,
+		ev->tag, ev->status, ev->arg[0], ev->arg[1]);
+}
+
+/* Recording pauses while dumping so the dump does not overwrite itself. */
+static int dump_ring(const char *origin)
+{
+	LOG_EVT(INF, "FLIGHT", "BEGIN", "origin=%s,written=%u,slots=%u", origin,
+		(uint32_t)atomic_get(&ring.head), FLIGHT_ENTRIES);
+	int count = flight_recorder_walk(dump_event, NULL);
+
+	LOG_EVT(INF, "FLIGHT", "END", "count=%d", count);
+	return count;
+}
+
+void flight_recorder_dump(void)
+{
+	atomic_val_t was_armed = atomic_set(&armed, 0);
+
+	(void)dump_ring("this_boot");
+	atomic_set(&armed, was_armed);
+}
+
+static int flight_recorder_boot(void)
+{
+	int count = -ENOENT;
+
+	atomic_set(&armed, 0);
+	if (ring.magic == FLIGHT_MAGIC && ring.image == image_tag() &&
+	    ring.hdr_crc == header_crc()) {
+		count = dump_ring("last_boot");
+	}
+
+	safe_memset(&ring, sizeof(ring), 0, sizeof(ring));
+	ring.magic = FLIGHT_MAGIC;
+	ring.image = image_tag();
+	ring.hdr_crc = header_crc();
+	atomic_set(&armed, 1);
+	return count;
+}
+
+void flight_recorder_init(void)
+{
+	(void)flight_recorder_boot();
+}
+
+#if defined(CONFIG_ZTEST)
+int flight_recorder_test_reboot(void)
+{
+	return flight_recorder_boot();
+}
+
+void flight_recorder_test_corrupt(uint32_t age)
+{
+	uint32_t head = (uint32_t)atomic_get(&ring.head);
+
+	ring.entries[(head - 1U - age) & (FLIGHT_ENTRIES - 1U)].arg[0] ^= BIT(7);
+}
+#endif
@@ -0,0 +1,44 @@
+#ifndef FLIGHT_RECORDER_H
+#define FLIGHT_RECORDER_H
+
+#include <stdint.h>
+
+#include <zephyr/sys/util.h>
+
+/* In-RAM flight recorder (CONFIG_APP_FLIGHT_RECORDER): every LOG_EVT also
+ * lands in a .noinit ring as (uptime, tag, status, first two args), so the
+ * last events before a warm or watchdog reset are still there on the next
+ * boot. Recording is lock-free and ISR-safe.
+ */
+struct flight_event {
+	uint32_t uptime_ms;
+	const char *tag;
+	const char *status;
+	uint32_t arg[2];
+};
+
+typedef void (*flight_walk_cb)(const struct flight_event *ev, void *user_data);
+
+#if IS_ENABLED(CONFIG_APP_FLIGHT_RECORDER)
+/* Dumps what the previous boot left behind once, then starts recording.
+ * LOG_EVT calls made before this are not recorded.
+ */
+void flight_recorder_init(void);
+void flight_record(const char *tag, const char *status, uint32_t arg0, uint32_t arg1);
+/* Visit intact entries oldest first; returns the number visited. */
+int flight_recorder_walk(flight_walk_cb cb, void *user_data);
+/* EVT,FLIGHT,BEGIN / REC / END for the current ring. */
+void flight_recorder_dump(void);
+
+#if defined(CONFIG_ZTEST)
+/* Re-run the boot validation as if the board had just warm-reset. */
+int flight_recorder_test_reboot(void);
+void flight_recorder_test_corrupt(uint32_t age);
+#endif
+#else
+static inline void flight_recorder_init(void)
+{
+}
+#endif
+
+#endif /* FLIGHT_RECORDER_H */
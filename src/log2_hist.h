@@ -0,0 +1,82 @@
+#ifndef LOG2_HIST_H
+#define LOG2_HIST_H
+
+#include <stdint.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/sys/util.h>
+
+/* Fixed-bucket log2 histogram of millisecond values. Bucket 0 holds 0 ms,
+ * bucket b holds [2^(b-1), 2^b - 1] ms and the last bucket everything above.
+ * Buckets are atomics so producers in any context, ISRs included, record
+ * without locks; a concurrent reader may see one sample in flight.
+ */
+#define LOG2_HIST_BUCKETS 16U
+
+struct log2_hist {
+	atomic_t bucket[LOG2_HIST_BUCKETS];
+	atomic_t max;
+};
+
+static inline void log2_hist_add(struct log2_hist *hist, uint32_t value)
+{
+	uint32_t b = MIN((uint32_t)find_msb_set(value), LOG2_HIST_BUCKETS - 1U);
+	atomic_val_t prev;
+
+	(void)atomic_inc(&hist->bucket[b]);
+	do {
+		prev = atomic_get(&hist->max);
+	} while (((uint32_t)prev < value) && !atomic_cas(&hist->max, prev, (atomic_val_t)value));
+}
+
+static inline uint32_t log2_hist_count(const struct log2_hist *hist)
+{
+	uint32_t total = 0U;
+
+	for (uint32_t b = 0U; b < LOG2_HIST_BUCKETS; b++) {
+		total += (uint32_t)atomic_get(&hist->bucket[b]);
+	}
+	return total;
+}
+
+static inline uint32_t log2_hist_max(const struct log2_hist *hist)
+{
+	return (uint32_t)atomic_get(&hist->max);
+}
+
+/* Upper bound of the bucket holding the pct-th percentile, capped at the
+ * recorded maximum; 0 when empty.
+ */
+static inline uint32_t log2_hist_percentile(const struct log2_hist *hist, uint32_t pct)
+{
+	uint32_t total = log2_hist_count(hist);
+	uint32_t target = (uint32_t)DIV_ROUND_UP((uint64_t)total * pct, 100U);
+	uint32_t seen = 0U;
+
+	if (total == 0U) {
+		return 0U;
+	}
+
+	for (uint32_t b = 0U; b < LOG2_HIST_BUCKETS; b++) {
+		seen += (uint32_t)atomic_get(&hist->bucket[b]);
+		if (seen >= MAX(target, 1U)) {
+			uint32_t upper = (b == 0U) ? 0U : (uint32_t)(BIT(b) - 1U);
+
+			return (b == (LOG2_HIST_BUCKETS - 1U)) ? log2_hist_max(hist)
+							      : MIN(upper, log2_hist_max(hist));
+		}
+	}
+
+	return log2_hist_max(hist);
+}
+
+static inline void log2_hist_reset(struct log2_hist *hist)
+{
+	for (uint32_t b = 0U; b < LOG2_HIST_BUCKETS; b++) {
+		atomic_set(&hist->bucket[b], 0);
+	}
+	atomic_set(&hist->max, 0);
+}
+
+#endif /* LOG2_HIST_H */
@@ -0,0 +1,573 @@
+#include <errno.h>
+#include <string.h>
+
+#include <zephyr/device.h>
+#include <zephyr/drivers/uart.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log_backend.h>
+#include <zephyr/logging/log_backend_std.h>
+#include <zephyr/logging/log_core.h>
+#include <zephyr/logging/log_output.h>
+#include <zephyr/spinlock.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/sys/printk.h>
+#include <zephyr/sys/util.h>
+
+#include "log_tx.h"
+
+BUILD_ASSERT(!IS_ENABLED(CONFIG_LOG_BACKEND_UART),
+	     "CONFIG_APP_LOG_TX replaces the UART log backend; set CONFIG_LOG_BACKEND_UART=n");
+
+#define TX_RING_SIZE CONFIG_APP_LOG_TX_RING_SIZE
+#define TX_LINE_MAX CONFIG_APP_LOG_TX_LINE_MAX
+#define TX_HIGH_WATER ((TX_RING_SIZE * CONFIG_APP_LOG_TX_HIGH_WATER_PERCENT) / 100U)
+#define TX_LOW_WATER (TX_HIGH_WATER / 2U)
+
+BUILD_ASSERT(IS_POWER_OF_TWO(TX_RING_SIZE), "log TX ring size must be a power of two");
+
+/* Tests drain an emulated UART; boards use the console. */
+#if DT_HAS_CHOSEN(app_log_uart)
+#define TX_UART_NODE DT_CHOSEN(app_log_uart)
+#else
+#define TX_UART_NODE DT_CHOSEN(zephyr_console)
+#endif
+
+/* The command CLI receives on the console with the interrupt API. */
+#define TX_SHARES_CLI_UART \
+	(IS_ENABLED(CONFIG_APP_ENABLE_UART_COMMANDS) && !DT_HAS_CHOSEN(app_command_uart) && \
+	 !DT_HAS_CHOSEN(app_log_uart))
+
+enum tx_mode {
+	TX_MODE_POLL,
+	TX_MODE_ASYNC,
+	TX_MODE_IRQ,
+};
+
+static const struct device *const tx_dev = DEVICE_DT_GET(TX_UART_NODE);
+
+/* Producers serialise on tx_lock and publish tx_head once a message is
+ * complete; the drain is the only writer of tx_tail. Indices run free and
+ * are masked on access. A message that does not fit is dropped whole, so
+ * the UART never sees half a line.
+ */
+static uint8_t tx_ring[TX_RING_SIZE];
+static atomic_t tx_head;
+static atomic_t tx_tail;
+static struct k_spinlock tx_lock;
+static uint32_t tx_wr; /* under tx_lock: end of the message being copied in */
+static uint32_t tx_msg_len; /* under tx_lock */
+static bool tx_msg_overflow; /* under tx_lock */
+static uint32_t tx_unreported; /* under tx_lock: drops not yet announced */
+static atomic_t tx_busy; /* async transfer in flight, or poll drain running */
+static atomic_t tx_congested;
+static enum tx_mode tx_mode;
+static bool tx_panic;
+static uart_irq_callback_user_data_t tx_rx_isr;
+
+static atomic_t stat_msgs;
+static atomic_t stat_bytes;
+static atomic_t stat_dropped_msgs;
+static atomic_t stat_dropped_bytes;
+static atomic_t stat_max_fill;
+static atomic_t stat_congested;
+static atomic_t stat_truncated;
+
+/* Readers take no lock, so the high-water mark only ever moves by CAS. */
+static void stat_raise_max(atomic_t *stat, uint32_t value)
+{
+	atomic_val_t cur = atomic_get(stat);
+
+	while ((uint32_t)cur < value && !atomic_cas(stat, cur, (atomic_val_t)value)) {
+		cur = atomic_get(stat);
+	}
+}
+
+static void update_congestion(uint32_t fill)
+{
+	if (fill >= TX_HIGH_WATER) {
+		if (atomic_cas(&tx_congested, 0, 1)) {
+			atomic_inc(&stat_congested);
+		}
+	} else if (fill <= TX_LOW_WATER) {
+		atomic_clear(&tx_congested);
+	}
+}
+
+static void kick(void);
+
+static void drain_poll(void)
+{
+	while (atomic_cas(&tx_busy, 0, 1)) {
+		uint32_t tail = (uint32_t)atomic_get(&tx_tail);
+
+		while (tail != (uint32_t)atomic_get(&tx_head)) {
+			uart_poll_out(tx_dev, tx_ring[tail & (TX_RING_SIZE - 1U)]);
+			tail++;
+			atomic_set(&tx_tail, (atomic_val_t)tail);
+		}
+		update_congestion(0U);
+		atomic_clear(&tx_busy);
+		/* A producer that found us busy left its bytes to this loop. */
+		if ((uint32_t)atomic_get(&tx_head) == tail) {
+			return;
+		}
+	}
+}
+
+#if IS_ENABLED(CONFIG_UART_ASYNC_API)
+static void fall_back(void);
+
+static void start_async(void)
+{
+	while (atomic_cas(&tx_busy, 0, 1)) {
+		uint32_t tail = (uint32_t)atomic_get(&tx_tail);
+		uint32_t head = (uint32_t)atomic_get(&tx_head);
+
+		if (head != tail) {
+			uint32_t offset = tail & (TX_RING_SIZE - 1U);
+			size_t span = MIN(head - tail, TX_RING_SIZE - offset);
+
+			if (uart_tx(tx_dev, &tx_ring[offset], span, SYS_FOREVER_US) == 0) {
+				return;
+			}
+			/* No DMA channel for this UART: drain another way. */
+			atomic_clear(&tx_busy);
+			fall_back();
+			kick();
+			return;
+		}
+
+		atomic_clear(&tx_busy);
+		if ((uint32_t)atomic_get(&tx_head) == tail) {
+			return;
+		}
+	}
+}
+
+static void async_cb(const struct device *dev, struct uart_event *evt, void *user_data)
+{
+	ARG_UNUSED(dev);
+	ARG_UNUSED(user_data);
+
+	if (evt->type != UART_TX_DONE && evt->type != UART_TX_ABORTED) {
+		return;
+	}
+
+	uint32_t tail = (uint32_t)atomic_add(&tx_tail, (atomic_val_t)evt->data.tx.len) +
+			evt->data.tx.len;
+
+	update_congestion((uint32_t)atomic_get(&tx_head) - tail);
+	atomic_clear(&tx_busy);
+	if (!tx_panic) {
+		start_async();
+	}
+}
+#endif
+
+#if IS_ENABLED(CONFIG_UART_INTERRUPT_DRIVEN)
+static void service_tx(const struct device *dev)
+{
+	if (!uart_irq_tx_ready(dev)) {
+		return;
+	}
+
+	uint32_t tail = (uint32_t)atomic_get(&tx_tail);
+	uint32_t head = (uint32_t)atomic_get(&tx_head);
+
+	if (head == tail) {
+		uart_irq_tx_disable(dev);
+		/* Re-arm if a producer committed between the check and here. */
+		if ((uint32_t)atomic_get(&tx_head) != tail) {
+			uart_irq_tx_enable(dev);
+		}
+		return;
+	}
+
+	uint32_t offset = tail & (TX_RING_SIZE - 1U);
+	int n = uart_fifo_fill(dev, &tx_ring[offset], (int)MIN(head - tail, TX_RING_SIZE - offset));
+
+	if (n > 0) {
+		tail += (uint32_t)n;
+		atomic_set(&tx_tail, (atomic_val_t)tail);
+		update_congestion(head - tail);
+	}
+}
+
+static void irq_cb(const struct device *dev, void *user_data)
+{
+	uart_irq_callback_user_data_t rx_isr = tx_rx_isr;
+
+	if (rx_isr != NULL) {
+		/* Updates the interrupt status for both handlers. */
+		rx_isr(dev, user_data);
+	} else if (!uart_irq_update(dev)) {
+		return;
+	}
+
+	if (!tx_panic) {
+		service_tx(dev);
+	}
+}
+#endif
+
+#if IS_ENABLED(CONFIG_UART_ASYNC_API)
+static void fall_back(void)
+{
+#if IS_ENABLED(CONFIG_UART_INTERRUPT_DRIVEN)
+	if (uart_irq_callback_user_data_set(tx_dev, irq_cb, NULL) == 0) {
+		tx_mode = TX_MODE_IRQ;
+		return;
+	}
+#endif
+	tx_mode = TX_MODE_POLL;
+}
+#endif
+
+static void kick(void)
+{
+	switch (tx_mode) {
+#if IS_ENABLED(CONFIG_UART_ASYNC_API)
+	case TX_MODE_ASYNC:
+		start_async();
+		break;
+#endif
+#if IS_ENABLED(CONFIG_UART_INTERRUPT_DRIVEN)
+	case TX_MODE_IRQ:
+		uart_irq_tx_enable(tx_dev);
+		break;
+#endif
+	default:
+		drain_poll();
+		break;
+	}
+}
+
+/* Under tx_lock. Appends to the message being queued. */
+static void ring_put(const uint8_t *data, size_t len)
+{
+	tx_msg_len += len;
+	if (tx_msg_overflow) {
+		return;
+	}
+
+	uint32_t fill = tx_wr - (uint32_t)atomic_get(&tx_tail);
+
+	if (len > TX_RING_SIZE - fill) {
+		tx_msg_overflow = true;
+		return;
+	}
+
+	uint32_t offset = tx_wr & (TX_RING_SIZE - 1U);
+	size_t first = MIN(len, TX_RING_SIZE - offset);
+
+	memcpy(&tx_ring[offset], data, first);
+	memcpy(tx_ring, data + first, len - first);
+	tx_wr += len;
+}
+
+/* Under tx_lock. Publishes the message, or rolls it back if it overflowed. */
+static void ring_commit(void)
+{
+	uint32_t head = (uint32_t)atomic_get(&tx_head);
+
+	if (tx_msg_overflow) {
+		tx_wr = head;
+		tx_unreported++;
+		atomic_inc(&stat_dropped_msgs);
+		atomic_add(&stat_dropped_bytes, (atomic_val_t)tx_msg_len);
+	} else if (tx_wr != head) {
+		uint32_t fill = tx_wr - (uint32_t)atomic_get(&tx_tail);
+
+		atomic_set(&tx_head, (atomic_val_t)tx_wr);
+		atomic_inc(&stat_msgs);
+		atomic_add(&stat_bytes, (atomic_val_t)tx_msg_len);
+		stat_raise_max(&stat_max_fill, fill);
+		update_congestion(fill);
+	}
+
+	tx_msg_len = 0U;
+	tx_msg_overflow = false;
+}
+
+/* Under tx_lock. Forgets the message being queued without counting it. */
+static void ring_abandon(void)
+{
+	tx_wr = (uint32_t)atomic_get(&tx_head);
+	tx_msg_len = 0U;
+	tx_msg_overflow = false;
+}
+
+/* One formatted message, at most TX_LINE_MAX bytes. The normal path
+ * formats into the single static stage with interrupts enabled, then takes
+ * tx_lock only to copy it into the ring. A producer that finds the stage
+ * taken (an ISR or a thread that preempted its owner) formats straight
+ * into the ring under tx_lock instead. No line buffer ever sits on a
+ * logging thread's or ISR's stack.
+ */
+struct tx_line {
+	uint8_t *buf; /* NULL: straight into the ring, under tx_lock */
+	size_t len;
+	bool truncated;
+};
+
+static uint8_t stage_buf[TX_LINE_MAX];
+static atomic_t stage_claimed;
+
+static int line_out(uint8_t *data, size_t length, void *ctx)
+{
+	struct tx_line *line = ctx;
+	size_t n = MIN(length, TX_LINE_MAX - line->len);
+
+	if (line->buf != NULL) {
+		memcpy(&line->buf[line->len], data, n);
+	} else if (tx_panic) {
+		for (size_t i = 0U; i < n; i++) {
+			uart_poll_out(tx_dev, data[i]);
+		}
+	} else {
+		ring_put(data, n);
+	}
+	line->len += n;
+	if (n < length) {
+		line->truncated = true;
+	}
+	return (int)length;
+}
+
+/* Keep the line ending of a cut message so the next one starts a line. */
+static void line_end(struct tx_line *line)
+{
+	if (!line->truncated) {
+		return;
+	}
+
+	atomic_inc(&stat_truncated);
+	if (line->buf != NULL) {
+		line->buf[TX_LINE_MAX - 2U] = '\r';
+		line->buf[TX_LINE_MAX - 1U] = '\n';
+	} else if (tx_panic) {
+		uart_poll_out(tx_dev, '\r');
+		uart_poll_out(tx_dev, '\n');
+	} else if (!tx_msg_overflow) {
+		/* Still unpublished: the message ends at tx_wr. */
+		tx_ring[(tx_wr - 2U) & (TX_RING_SIZE - 1U)] = '\r';
+		tx_ring[(tx_wr - 1U) & (TX_RING_SIZE - 1U)] = '\n';
+	}
+}
+
+/* Formats msg, or the dropped notice when msg is NULL, into line. */
+static void line_format(struct tx_line *line, struct log_msg *msg, uint32_t dropped)
+{
+	uint8_t fmt_buf[16];
+	struct log_output_control_block ctrl = { .ctx = line };
+	const struct log_output out = {
+		.func = line_out,
+		.control_block = &ctrl,
+		.buf = fmt_buf,
+		.size = sizeof(fmt_buf),
+	};
+
+	if (msg != NULL) {
+		log_output_msg_process(&out, msg, log_backend_std_get_flags());
+	} else {
+		log_output_dropped_process(&out, dropped);
+	}
+	line_end(line);
+}
+
+/* Under tx_lock. Says how many messages were lost once there is room. */
+static void report_drops(void)
+{
+	char line[48];
+	int len = snprintk(line, sizeof(line), "--- %u log messages dropped ---\r\n",
+			   tx_unreported);
+
+	ring_put((const uint8_t *)line, MIN((size_t)len, sizeof(line) - 1U));
+	if (!tx_msg_overflow) {
+		tx_unreported = 0U;
+		ring_commit();
+	} else {
+		/* Still full: keep the count for the next attempt. */
+		ring_abandon();
+	}
+}
+
+static void emit(struct log_msg *msg, uint32_t dropped)
+{
+	struct tx_line line = { 0 };
+	k_spinlock_key_t key;
+
+	if (atomic_cas(&stage_claimed, 0, 1)) {
+		line.buf = stage_buf;
+		line_format(&line, msg, dropped);
+
+		key = k_spin_lock(&tx_lock);
+		if (tx_panic) {
+			for (size_t i = 0U; i < line.len; i++) {
+				uart_poll_out(tx_dev, stage_buf[i]);
+			}
+		} else {
+			if (tx_unreported != 0U) {
+				report_drops();
+			}
+			ring_put(stage_buf, line.len);
+			ring_commit();
+		}
+		k_spin_unlock(&tx_lock, key);
+		atomic_clear(&stage_claimed);
+	} else {
+		key = k_spin_lock(&tx_lock);
+		if (!tx_panic && tx_unreported != 0U) {
+			report_drops();
+		}
+		line_format(&line, msg, dropped);
+		if (!tx_panic) {
+			ring_commit();
+		}
+		k_spin_unlock(&tx_lock, key);
+	}
+
+	if (!tx_panic) {
+		kick();
+	}
+}
+
+static void backend_process(const struct log_backend *const backend, union log_msg_generic *msg)
+{
+	ARG_UNUSED(backend);
+	emit(&msg->log, 0U);
+}
+
+static void backend_dropped(const struct log_backend *const backend, uint32_t cnt)
+{
+	ARG_UNUSED(backend);
+	emit(NULL, cnt);
+}
+
+/* Fault or explicit log_panic(): stop the background drain, print what is
+ * queued and write synchronously from now on.
+ */
+static void backend_panic(struct log_backend const *const backend)
+{
+	ARG_UNUSED(backend);
+
+	tx_panic = true;
+#if IS_ENABLED(CONFIG_UART_ASYNC_API)
+	if (tx_mode == TX_MODE_ASYNC) {
+		(void)uart_tx_abort(tx_dev);
+	}
+#endif
+#if IS_ENABLED(CONFIG_UART_INTERRUPT_DRIVEN)
+	if (tx_mode == TX_MODE_IRQ) {
+		uart_irq_tx_disable(tx_dev);
+	}
+#endif
+	tx_mode = TX_MODE_POLL;
+	atomic_clear(&tx_busy);
+	drain_poll();
+}
+
+static void backend_init(struct log_backend const *const backend)
+{
+	ARG_UNUSED(backend);
+
+	tx_mode = TX_MODE_POLL;
+	if (!device_is_ready(tx_dev)) {
+		return;
+	}
+
+#if IS_ENABLED(CONFIG_UART_ASYNC_API)
+	if (!TX_SHARES_CLI_UART && uart_callback_set(tx_dev, async_cb, NULL) == 0) {
+		tx_mode = TX_MODE_ASYNC;
+		return;
+	}
+#endif
+#if IS_ENABLED(CONFIG_UART_INTERRUPT_DRIVEN)
+	if (uart_irq_callback_user_data_set(tx_dev, irq_cb, NULL) == 0) {
+		tx_mode = TX_MODE_IRQ;
+	}
+#endif
+}
+
+static const struct log_backend_api log_tx_api = {
+	.process = backend_process,
+	.dropped = IS_ENABLED(CONFIG_LOG_MODE_IMMEDIATE) ? NULL : backend_dropped,
+	.panic = backend_panic,
+	.init = backend_init,
+};
+
+LOG_BACKEND_DEFINE(log_backend_app_tx, log_tx_api, true);
+
+bool log_tx_congested(void)
+{
+	return atomic_get(&tx_congested) != 0;
+}
+
+bool log_tx_pending(void)
+{
+	return atomic_get(&tx_head) != atomic_get(&tx_tail);
+}
+
+void log_tx_get_stats(struct log_tx_stats *out)
+{
+	out->msgs = (uint32_t)atomic_get(&stat_msgs);
+	out->bytes = (uint32_t)atomic_get(&stat_bytes);
+	out->dropped_msgs = (uint32_t)atomic_get(&stat_dropped_msgs);
+	out->dropped_bytes = (uint32_t)atomic_get(&stat_dropped_bytes);
+	out->max_fill = (uint32_t)atomic_get(&stat_max_fill);
+	out->congested = (uint32_t)atomic_get(&stat_congested);
+	out->truncated = (uint32_t)atomic_get(&stat_truncated);
+}
+
+int log_tx_attach_rx(const struct device *dev, uart_irq_callback_user_data_t isr)
+{
+	if (dev != tx_dev) {
+		return -ENODEV;
+	}
+	if (tx_mode == TX_MODE_ASYNC) {
+		return -EBUSY;
+	}
+	if (tx_mode != TX_MODE_IRQ) {
+		return -ENODEV;
+	}
+
+	tx_rx_isr = isr;
+	return 0;
+}
+
+int log_tx_write(const struct device *dev, const uint8_t *data, size_t len)
+{
+	if (dev != tx_dev) {
+		return -ENODEV;
+	}
+
+	if (tx_panic) {
+		for (size_t i = 0U; i < len; i++) {
+			uart_poll_out(tx_dev, data[i]);
+		}
+		return 0;
+	}
+
+	k_spinlock_key_t key = k_spin_lock(&tx_lock);
+
+	ring_put(data, len);
+
+	bool fit = !tx_msg_overflow;
+
+	if (fit) {
+		ring_commit();
+	} else {
+		ring_abandon();
+	}
+	k_spin_unlock(&tx_lock, key);
+
+	kick();
+	return fit ? 0 : -ENOSPC;
+}
+
+#if defined(CONFIG_ZTEST)
+void log_tx_test_hold_stage(bool hold)
+{
+	atomic_set(&stage_claimed, hold ? 1 : 0);
+}
+#endif
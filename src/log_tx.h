@@ -0,0 +1,80 @@
+#ifndef LOG_TX_H
+#define LOG_TX_H
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <zephyr/device.h>
+#include <zephyr/drivers/uart.h>
+#include <zephyr/sys/util.h>
+
+/* Buffered UART log backend (CONFIG_APP_LOG_TX). Log messages are
+ * formatted into a RAM ring and the caller returns; the UART async API or
+ * the TX interrupt drains the ring in the background.
+ */
+struct log_tx_stats {
+	uint32_t msgs; /* messages queued whole */
+	uint32_t bytes; /* bytes queued */
+	uint32_t dropped_msgs; /* messages that did not fit */
+	uint32_t dropped_bytes;
+	uint32_t max_fill; /* ring high-water mark, bytes */
+	uint32_t congested; /* times the backpressure threshold was crossed */
+	uint32_t truncated; /* messages cut to CONFIG_APP_LOG_TX_LINE_MAX */
+};
+
+#if IS_ENABLED(CONFIG_APP_LOG_TX)
+/* Backpressure: true from CONFIG_APP_LOG_TX_HIGH_WATER_PERCENT full until
+ * the ring has drained to half of that. Producers of optional output
+ * should skip it rather than have it dropped.
+ */
+bool log_tx_congested(void);
+/* True while queued bytes have not been handed to the UART yet. */
+bool log_tx_pending(void);
+void log_tx_get_stats(struct log_tx_stats *out);
+/* A UART serves one interrupt callback. When the backend drains dev by
+ * interrupt, isr is chained in front of the TX handler and 0 is returned.
+ * -ENODEV: the backend does not use dev's interrupt, set your own
+ * callback. -EBUSY: dev is on the async API.
+ */
+int log_tx_attach_rx(const struct device *dev, uart_irq_callback_user_data_t isr);
+/* Queue raw bytes for dev in one piece, never split by a log message.
+ * -ENODEV: the backend does not write to dev, use uart_poll_out().
+ * -ENOSPC: the ring has no room for all of it right now.
+ */
+int log_tx_write(const struct device *dev, const uint8_t *data, size_t len);
+
+#if defined(CONFIG_ZTEST)
+/* Holds the static stage as a preempted producer would, so messages take
+ * the format-into-the-ring path.
+ */
+void log_tx_test_hold_stage(bool hold);
+#endif
+#else
+static inline bool log_tx_congested(void)
+{
+	return false;
+}
+
+static inline bool log_tx_pending(void)
+{
+	return false;
+}
+
+static inline int log_tx_attach_rx(const struct device *dev, uart_irq_callback_user_data_t isr)
+{
+	ARG_UNUSED(dev);
+	ARG_UNUSED(isr);
+	return -ENODEV;
+}
+
+static inline int log_tx_write(const struct device *dev, const uint8_t *data, size_t len)
+{
+	ARG_UNUSED(dev);
+	ARG_UNUSED(data);
+	ARG_UNUSED(len);
+	return -ENODEV;
+}
+#endif
+
+#endif /* LOG_TX_H */
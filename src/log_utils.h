@@ -1,15 +1,68 @@
 #ifndef LOG_UTILS_H
 #define LOG_UTILS_H
 
+#include <stdint.h>
+
 #include <zephyr/logging/log.h>
+#include <zephyr/sys/util.h>
 
 /* Compact structured logging helpers.
  * Format: EVT,<tag>,<status>[,<kv pairs...>]
+ * With the flight recorder, every event is also recorded with its first
+ * two arguments.
  */
-#define LOG_EVT_SIMPLE(level, tag, status) \
-	LOG_##level("EVT,%s,%s", tag, status)
+#if IS_ENABLED(CONFIG_APP_FLIGHT_RECORDER)
+#include "flight_recorder.h"
+
+#define LOG_EVT_U32(x) ((uint32_t)(uintptr_t)(x))
+
+/* Records an event with no arguments, one, or two and more. The first two
+ * arguments are bound to locals and handed to both flight_record() and the
+ * log call, so each argument is evaluated exactly once. __auto_type lets an
+ * array argument decay to the pointer its %s expects.
+ */
+#define LOG_EVT_0(level, tag, status, fmt)                  \
+	do {                                                \
+		flight_record(tag, status, 0U, 0U);         \
+		LOG_##level("EVT,%s,%s," fmt, tag, status); \
+	} while (0)
+
+#define LOG_EVT_1(level, tag, status, fmt, a)                        \
+	do {                                                         \
+		__auto_type _evt_a = (a);                            \
+		flight_record(tag, status, LOG_EVT_U32(_evt_a), 0U); \
+		LOG_##level("EVT,%s,%s," fmt, tag, status, _evt_a);  \
+	} while (0)
+
+#define LOG_EVT_N(level, tag, status, fmt, a, b, ...)                                      \
+	do {                                                                               \
+		__auto_type _evt_a = (a);                                                  \
+		__auto_type _evt_b = (b);                                                  \
+		flight_record(tag, status, LOG_EVT_U32(_evt_a), LOG_EVT_U32(_evt_b));      \
+		LOG_##level("EVT,%s,%s," fmt, tag, status, _evt_a, _evt_b, ##__VA_ARGS__); \
+	} while (0)
+
+#define LOG_EVT_SIMPLE(level, tag, status)             \
+	do {                                           \
+		flight_record(tag, status, 0U, 0U);    \
+		LOG_##level("EVT,%s,%s", tag, status); \
+	} while (0)
+
+#define LOG_EVT_PICK(n) COND_CODE_0(n, (LOG_EVT_0), (COND_CODE_1(n, (LOG_EVT_1), (LOG_EVT_N))))
+
+#define LOG_EVT(level, tag, status, fmt, ...)              \
+	LOG_EVT_PICK(NUM_VA_ARGS_LESS_1(_, ##__VA_ARGS__)) \
+	(level, tag, status, fmt, ##__VA_ARGS__)
+#else
+#define LOG_EVT_SIMPLE(level, tag, status)             \
+	do {                                           \
+		LOG_##level("EVT,%s,%s", tag, status); \
+	} while (0)
 
-#define LOG_EVT(level, tag, status, fmt, ...) \
-	LOG_##level("EVT,%s,%s," fmt, tag, status, ##__VA_ARGS__)
+#define LOG_EVT(level, tag, status, fmt, ...)                              \
+	do {                                                               \
+		LOG_##level("EVT,%s,%s," fmt, tag, status, ##__VA_ARGS__); \
+	} while (0)
+#endif
 
 #endif /* LOG_UTILS_H */
@@ -8,8 +8,11 @@
 #include <ctype.h>
 
 #include "app_crypto.h"
+#include "event_log.h"
+#include "flight_recorder.h"
 #include "log_utils.h"
 #include "persist_state.h"
+#include "prewatchdog.h"
 #include "recovery.h"
 #include "sensor_hts221.h"
 #include "supervisor.h"
@@ -100,6 +103,7 @@ static uint32_t log_reset_cause(void)
 void main(void)
 {
 	k_thread_name_set(k_current_get(), "main");
+	flight_recorder_init();
 	LOG_EVT_SIMPLE(INF, "APP", "START");
 
 	int ret = app_crypto_init();
@@ -116,8 +120,15 @@ void main(void)
 	autoload_curve_keys();
 #endif
 
+	ret = event_log_init();
+	if (ret) {
+		LOG_ERR("Event log init failed: %d", ret);
+	}
+
 	uint32_t reset_cause = log_reset_cause();
 	bool watchdog_reset = (reset_cause & RESET_WATCHDOG) != 0U;
+	event_log_append(EVENT_LOG_BOOT, reset_cause);
+	prewatchdog_report_last_boot(watchdog_reset);
 	persist_state_record_boot(watchdog_reset);
 
 	uint32_t consecutive = persist_state_get_consecutive_watchdog();
@@ -129,6 +140,7 @@ void main(void)
 	bool safe_mode_active = persist_state_is_fallback_active();
 	if (safe_mode_active) {
 		LOG_EVT_SIMPLE(ERR, "SAFE_MODE", "ENTERED");
+		event_log_append(EVENT_LOG_SAFE_MODE_ENTER, consecutive);
 		persist_state_clear_watchdog_counter();
 		LOG_EVT_SIMPLE(INF, "WATCHDOG", "COUNTER_CLEARED");
 	}
@@ -174,6 +186,11 @@ void main(void)
 	ret = sensor_hts221_start(safe_mode_active);
 	if (ret) {
 		LOG_EVT(ERR, "SENSOR", "HTS221_INIT_FAIL", "rc=%d", ret);
+	} else {
+		/* The sensor work item feeds both built-in heartbeats. */
+		(void)recovery_register_actions(BIT(SUPERVISOR_HANDLE_SYSTEM) |
+						BIT(SUPERVISOR_HANDLE_LED),
+						sensor_hts221_restart, sensor_hts221_reinit);
 	}
 #else
 	LOG_INF("Skipping HTS221 sensor thread while provisioning build is enabled");
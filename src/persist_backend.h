@@ -0,0 +1,43 @@
+#ifndef PERSIST_BACKEND_H
+#define PERSIST_BACKEND_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+#include <zephyr/device.h>
+
+/* Small key-value store used by persist_state.c. Exactly one implementation
+ * is linked, selected by CONFIG_APP_PERSIST_BACKEND_*. Read/write return
+ * byte counts with the same semantics as nvs_read()/nvs_write(): a write of
+ * unchanged data returns 0 and touches no flash.
+ */
+int persist_backend_configure(const struct device *flash_dev, off_t offset,
+			      uint32_t sector_size, uint32_t sector_count);
+int persist_backend_mount(void);
+ssize_t persist_backend_read(uint32_t id, void *data, size_t len);
+ssize_t persist_backend_write(uint32_t id, const void *data, size_t len);
+int persist_backend_delete(uint32_t id);
+int persist_backend_clear(void);
+ssize_t persist_backend_free_space(void);
+
+/* GC cycles since the backend was configured. Inferred from the public
+ * free-space call for the active sector: that space only grows when a
+ * write or delete moved to a freshly collected sector.
+ */
+uint32_t persist_backend_gc_count(void);
+
+/* True if a len-byte record still fits in the current write sector, i.e.
+ * writing it will not roll over into a GC/erase cycle. Conservative: the
+ * record is padded to the widest write block we run on.
+ */
+bool persist_backend_fits_in_sector(size_t len);
+uint32_t persist_backend_sector_size(void);
+uint32_t persist_backend_sector_count(void);
+const char *persist_backend_name(void);
+
+/* Drop the mounted state so the next configure/mount starts cold. */
+void persist_backend_forget(void);
+
+#endif /* PERSIST_BACKEND_H */
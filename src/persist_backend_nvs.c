@@ -0,0 +1,111 @@
+#include "persist_backend.h"
+#include "safe_memory.h"
+
+#include <errno.h>
+
+#include <zephyr/fs/nvs.h>
+#include <zephyr/kernel.h>
+
+/* Widest flash write block we run on; records are padded to it. */
+#define NVS_ALIGN 8U
+
+static struct nvs_fs nvs;
+static uint32_t gc_count;
+
+/* Data bytes the active sector still takes, 0 when unmounted or full. */
+static size_t sector_free(void)
+{
+	ssize_t free_bytes = (ssize_t)nvs_sector_max_data_size(&nvs);
+
+	return (free_bytes > 0) ? (size_t)free_bytes : 0U;
+}
+
+static void note_gc(size_t free_before)
+{
+	if (sector_free() > free_before) {
+		gc_count++;
+	}
+}
+
+int persist_backend_configure(const struct device *flash_dev, off_t offset,
+			      uint32_t sector_size, uint32_t sector_count)
+{
+	if (sector_size > UINT16_MAX || sector_count > UINT16_MAX) {
+		return -EINVAL;
+	}
+
+	nvs.flash_device = flash_dev;
+	nvs.offset = offset;
+	nvs.sector_size = (uint16_t)sector_size;
+	nvs.sector_count = (uint16_t)sector_count;
+	return 0;
+}
+
+int persist_backend_mount(void)
+{
+	return nvs_mount(&nvs);
+}
+
+ssize_t persist_backend_read(uint32_t id, void *data, size_t len)
+{
+	return nvs_read(&nvs, (uint16_t)id, data, len);
+}
+
+ssize_t persist_backend_write(uint32_t id, const void *data, size_t len)
+{
+	size_t free_before = sector_free();
+	ssize_t rc = nvs_write(&nvs, (uint16_t)id, data, len);
+
+	note_gc(free_before);
+	return rc;
+}
+
+int persist_backend_delete(uint32_t id)
+{
+	size_t free_before = sector_free();
+	int rc = nvs_delete(&nvs, (uint16_t)id);
+
+	note_gc(free_before);
+	return rc;
+}
+
+int persist_backend_clear(void)
+{
+	return nvs_clear(&nvs);
+}
+
+ssize_t persist_backend_free_space(void)
+{
+	return nvs_calc_free_space(&nvs);
+}
+
+uint32_t persist_backend_gc_count(void)
+{
+	return gc_count;
+}
+
+bool persist_backend_fits_in_sector(size_t len)
+{
+	return ROUND_UP(len, NVS_ALIGN) <= sector_free();
+}
+
+uint32_t persist_backend_sector_size(void)
+{
+	return nvs.sector_size;
+}
+
+uint32_t persist_backend_sector_count(void)
+{
+	return nvs.sector_count;
+}
+
+const char *persist_backend_name(void)
+{
+	return "nvs";
+}
+
+void persist_backend_forget(void)
+{
+	safe_memset(&nvs, sizeof(nvs), 0, sizeof(nvs));
+	gc_count = 0U;
+}
@@ -0,0 +1,108 @@
+#include "persist_backend.h"
+#include "safe_memory.h"
+
+#include <errno.h>
+
+#include <zephyr/fs/zms.h>
+#include <zephyr/kernel.h>
+
+/* Widest flash write block we run on; records are padded to it. */
+#define ZMS_ALIGN 8U
+
+static struct zms_fs zms;
+static uint32_t gc_count;
+
+/* Bytes left in the active sector, 0 when unmounted or full. */
+static size_t sector_free(void)
+{
+	ssize_t free_bytes = zms_active_sector_free_space(&zms);
+
+	return (free_bytes > 0) ? (size_t)free_bytes : 0U;
+}
+
+static void note_gc(size_t free_before)
+{
+	if (sector_free() > free_before) {
+		gc_count++;
+	}
+}
+
+int persist_backend_configure(const struct device *flash_dev, off_t offset,
+			      uint32_t sector_size, uint32_t sector_count)
+{
+	zms.flash_device = flash_dev;
+	zms.offset = offset;
+	zms.sector_size = sector_size;
+	zms.sector_count = sector_count;
+	return 0;
+}
+
+int persist_backend_mount(void)
+{
+	return zms_mount(&zms);
+}
+
+ssize_t persist_backend_read(uint32_t id, void *data, size_t len)
+{
+	return zms_read(&zms, id, data, len);
+}
+
+ssize_t persist_backend_write(uint32_t id, const void *data, size_t len)
+{
+	size_t free_before = sector_free();
+	ssize_t rc = zms_write(&zms, id, data, len);
+
+	note_gc(free_before);
+	return rc;
+}
+
+int persist_backend_delete(uint32_t id)
+{
+	size_t free_before = sector_free();
+	int rc = zms_delete(&zms, id);
+
+	note_gc(free_before);
+	return rc;
+}
+
+int persist_backend_clear(void)
+{
+	return zms_clear(&zms);
+}
+
+ssize_t persist_backend_free_space(void)
+{
+	return zms_calc_free_space(&zms);
+}
+
+uint32_t persist_backend_gc_count(void)
+{
+	return gc_count;
+}
+
+bool persist_backend_fits_in_sector(size_t len)
+{
+	/* Small values live in the allocation entry; padding them is harmless. */
+	return ROUND_UP(len, ZMS_ALIGN) <= sector_free();
+}
+
+uint32_t persist_backend_sector_size(void)
+{
+	return zms.sector_size;
+}
+
+uint32_t persist_backend_sector_count(void)
+{
+	return zms.sector_count;
+}
+
+const char *persist_backend_name(void)
+{
+	return "zms";
+}
+
+void persist_backend_forget(void)
+{
+	safe_memset(&zms, sizeof(zms), 0, sizeof(zms));
+	gc_count = 0U;
+}
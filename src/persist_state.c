@@ -1,6 +1,8 @@
 #include "persist_state.h"
+#include "persist_backend.h"
 #include "log_utils.h"
 #include "app_crypto.h"
+#include "event_log.h"
 #include "safe_memory.h"
 #include "persist_state_priv.h"
 #if defined(CONFIG_ZTEST)
@@ -8,28 +10,72 @@
 #endif
 
 #include <errno.h>
+#include <stddef.h>
 #include <string.h>
 
 #include <zephyr/device.h>
 #include <zephyr/drivers/flash.h>
 #include <zephyr/drivers/hwinfo.h>
+#include <zephyr/drivers/retained_mem.h>
 #include <zephyr/kernel.h>
 #include <zephyr/logging/log.h>
 #include <zephyr/storage/flash_map.h>
-#include <zephyr/fs/nvs.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/sys/crc.h>
 
 LOG_MODULE_REGISTER(persist_state, LOG_LEVEL_INF);
 
 #define PERSIST_MAGIC 0x4C454453u /* 'LEDS' */
-#define PERSIST_RECORD_ID 1
+#define PERSIST_RECORD_ID 1 /* legacy single-blob record, migrated on mount */
 #define PERSIST_CURVE_SECRET_ID 2
 #define PERSIST_CURVE_SECRET_MAGIC 0x43555256u /* 'CURV' */
 #define PERSIST_CURVE_PEER_ID 3
 #define PERSIST_CURVE_PEER_MAGIC 0x43555250u /* 'CURP' */
 
+#define PERSIST_SCHEMA_ID 4
+#define PERSIST_WEAR_ID 9
+#define PERSIST_WEAR_MAGIC 0x57454152u /* 'WEAR' */
+#define PERSIST_TASK_FAULT_ID 10
+#define PERSIST_TASK_FAULT_MAGIC 0x5441534Bu /* 'TASK' */
+#define PERSIST_ESCALATION_ID 11
+#define PERSIST_ESCALATION_MAGIC 0x45534341u /* 'ESCA' */
+#define PERSIST_MAX_ID PERSIST_ESCALATION_ID
+#define PERSIST_SCHEMA_VERSION 1U
+#define PERSIST_FIELD_ID_BASE 5
+#define PERSIST_FIELD_ID(tag) ((uint16_t)(PERSIST_FIELD_ID_BASE + (tag)))
+#define PERSIST_TAG_SCHEMA 0xFFU
+
 #define STORAGE_PARTITION_NODE DT_NODELABEL(storage_partition)
+#define PERSIST_RETAINED_NODE DT_NODELABEL(persist_retained)
+#define PERSIST_WARM_MAGIC 0x5741524Du /* 'WARM' */
+#define PERSIST_WARM_ARMED 0xA5C3F00Du
 #define PERSIST_RETRY_LIMIT 3
 #define PERSIST_RETRY_DELAY_MS 10
+#define PERSIST_SESSION_LEASE ((uint32_t)CONFIG_APP_PERSIST_SESSION_LEASE)
+
+#define PERSIST_FIELD_RECORD_LEN sizeof(struct persist_field)
+
+/* Hot counters (session, consecutive watchdog) and cold config (override)
+ * each get their own record; see PERSIST_FIELD_ID().
+ */
+enum persist_field_tag {
+	PERSIST_FIELD_SESSION = 0,
+	PERSIST_FIELD_CONSECUTIVE_WDT,
+	PERSIST_FIELD_TOTAL_WDT,
+	PERSIST_FIELD_OVERRIDE,
+	PERSIST_FIELD_COUNT
+};
+
+#define PERSIST_FIELDS_ALL BIT_MASK(PERSIST_FIELD_COUNT)
+
+/* Plain records cached in g_state. Their dirty bits follow the field tags
+ * so they share the commit path: write-behind, GC gating and flush.
+ */
+enum persist_record_dirty {
+	PERSIST_DIRTY_TASK_FAULTS = PERSIST_FIELD_COUNT,
+	PERSIST_DIRTY_ESCALATION,
+	PERSIST_DIRTY_COUNT
+};
 
 struct persist_curve_secret {
 	uint32_t magic;
@@ -41,12 +87,80 @@ struct persist_curve_peer {
 	uint8_t peer[CURVE25519_KEY_SIZE];
 };
 
+/* Lifetime flash usage, stored in plain text: it is telemetry, not state. */
+struct persist_wear_rollup {
+	uint32_t magic;
+	uint32_t writes;
+	uint32_t bytes;
+	uint32_t erases;
+	uint32_t uptime_s;
+};
+
+/* Supervisor heartbeat faults per registry slot; plain text like the wear
+ * rollup. A size change (CONFIG_APP_SUPERVISOR_MAX_TASKS) restarts the counts.
+ */
+struct persist_task_faults {
+	uint32_t magic;
+	uint16_t count[CONFIG_APP_SUPERVISOR_MAX_TASKS];
+};
+
+/* Open recovery incident; plain text, changed once per escalation step. */
+struct persist_escalation {
+	uint32_t magic;
+	uint8_t stage;
+	uint8_t reserved[3];
+	uint32_t task_mask;
+	uint32_t elapsed_ms;
+};
+
+/* blob.session_counter is the persisted lease high-water mark: every value
+ * up to it may already have been handed out. session_next is the last
+ * value issued from the current lease and only lives in RAM.
+ */
 static struct {
-	struct nvs_fs fs;
 	struct persist_blob blob;
+	struct persist_task_faults task_faults;
+	struct persist_escalation escalation;
+	uint32_t session_next;
+	uint32_t dirty_fields;
+	bool mounted;
 	bool loaded;
 } g_state;
 
+static struct persist_state_stats g_stats = {
+	.gc_min_margin_ms = INT32_MAX,
+};
+
+/* Last watchdog feed reported by the supervisor and the timeout it armed.
+ * A zero timeout means no feed has been reported yet (boot, provisioning
+ * builds, tests), in which case there is no deadline to protect.
+ */
+static atomic_t feed_uptime_ms = ATOMIC_INIT(0);
+static atomic_t feed_timeout_ms = ATOMIC_INIT(0);
+
+#if IS_ENABLED(CONFIG_APP_PERSIST_WEAR_TELEMETRY)
+/* base is the rollup loaded at mount; the rest counts this boot only. */
+static struct {
+	struct persist_wear_rollup base;
+	uint32_t writes_by_id[PERSIST_MAX_ID + 1];
+	uint32_t writes;
+	uint32_t bytes;
+	uint32_t erases;
+	uint32_t saved_writes; /* this boot's writes at the last save */
+	uint32_t saved_uptime_s;
+	bool save_pending;
+} g_wear;
+
+#define PERSIST_WEAR_SAVE_UPTIME_S 3600U
+#endif
+
+/* Reader-side copy of g_state.blob published under a sequence counter so
+ * getters never wait behind a writer that holds state_lock across flash
+ * I/O. Odd sequence = publish in progress.
+ */
+static struct persist_blob g_snapshot;
+static atomic_t snapshot_seq = ATOMIC_INIT(0);
+
 #if IS_ENABLED(CONFIG_APP_PROVISION_GDB_HELPERS)
 /* Tiny staging buffers that the provisioning GDB script pokes. */
 __attribute__((used, externally_visible, visibility("default")))
@@ -57,6 +171,31 @@ uint8_t gdb_curve_peer_buf[CURVE25519_KEY_SIZE];
 
 static K_MUTEX_DEFINE(state_lock);
 
+#if defined(CONFIG_ZTEST)
+static int test_write_error; /* under state_lock; see persist_state_test_fail_writes() */
+static int test_mount_error; /* under state_lock; see persist_state_test_fail_mount() */
+#endif
+
+#if IS_ENABLED(CONFIG_APP_PERSIST_GC_SCHEDULING)
+static void persist_gc_work_handler(struct k_work *work);
+static K_WORK_DEFINE(gc_work, persist_gc_work_handler);
+static bool gc_deferred;
+static uint16_t compact_generation;
+#endif
+
+#if IS_ENABLED(CONFIG_APP_PERSIST_WRITE_BEHIND)
+#define PERSIST_FLUSH_THREAD_PRIORITY 8
+
+K_THREAD_STACK_DEFINE(persist_flush_stack, CONFIG_APP_PERSIST_FLUSH_STACK_SIZE);
+static struct k_thread persist_flush_tid;
+static K_SEM_DEFINE(flush_sem, 0, 1);
+static bool flush_thread_started;
+/* Last background commit error, under state_lock. Cleared once a commit
+ * gets everything onto flash; until then the next update returns it.
+ */
+static int flush_error;
+#endif
+
 #if IS_ENABLED(CONFIG_APP_CRYPTO_BACKEND_CURVE25519)
 static int hex_nibble(char c)
 {
@@ -145,7 +284,7 @@ static int curve_secret_generate(uint8_t secret[CURVE25519_KEY_SIZE])
 static int persist_read_encrypted(struct persist_blob *out_blob)
 {
 	struct persist_blob_encrypted storage = {0};
-	int rc = nvs_read(&g_state.fs, PERSIST_RECORD_ID, &storage, sizeof(storage));
+	int rc = persist_backend_read(PERSIST_RECORD_ID, &storage, sizeof(storage));
 
 	if (rc == sizeof(storage)) {
 		size_t plain_len = 0U;
@@ -154,6 +293,7 @@ static int persist_read_encrypted(struct persist_blob *out_blob)
 					       sizeof(*out_blob), &plain_len);
 		if (rc != 0) {
 			LOG_ERR("Persist blob decrypt failed: %d", rc);
+			event_log_append(EVENT_LOG_PERSIST_TAMPER, PERSIST_RECORD_ID);
 			return rc;
 		}
 		if (plain_len != sizeof(*out_blob)) {
@@ -188,7 +328,7 @@ static int persist_load_blob(struct persist_blob *out_blob)
 	}
 #endif
 
-	rc = nvs_read(&g_state.fs, PERSIST_RECORD_ID, out_blob, sizeof(*out_blob));
+	rc = persist_backend_read(PERSIST_RECORD_ID, out_blob, sizeof(*out_blob));
 	if (rc < 0) {
 		return rc;
 	}
@@ -196,54 +336,840 @@ static int persist_load_blob(struct persist_blob *out_blob)
 	return (rc == sizeof(*out_blob)) ? 0 : -ENOENT;
 }
 
-static int persist_store_blob(const struct persist_blob *blob)
+/* Field records are always plain. Session keys are derived from the
+ * counter stored here, so they are not available when the records are
+ * read at mount and differ on every boot anyway.
+ */
+static int persist_read_field_record(uint16_t id, struct persist_field *field)
 {
-#if IS_ENABLED(CONFIG_APP_USE_AES_ENCRYPTION)
-	if (app_crypto_is_enabled()) {
-		struct persist_blob_encrypted storage;
-		size_t cipher_len = 0U;
-		int rc = app_crypto_encrypt_buffer((const uint8_t *)blob, sizeof(*blob),
-						   storage.data, sizeof(storage.data),
-						   &cipher_len, storage.iv);
+	ssize_t rc = persist_backend_read(id, field, sizeof(*field));
+
+	if (rc < 0) {
+		return (int)rc;
+	}
+
+	return (rc == sizeof(*field)) ? 0 : -ENOENT;
+}
+
+/* Milliseconds until the watchdog fires if nothing feeds it from now on. */
+static int32_t persist_feed_margin_ms(void)
+{
+	uint32_t timeout_ms = (uint32_t)atomic_get(&feed_timeout_ms);
+
+	if (timeout_ms == 0U) {
+		return INT32_MAX;
+	}
+
+	uint32_t since_feed = k_uptime_get_32() - (uint32_t)atomic_get(&feed_uptime_ms);
+
+	return (int32_t)timeout_ms - (int32_t)since_feed;
+}
+
+/* Account for sectors the backend rolled over (and erased) during a write
+ * and report how much of the watchdog window was left when it finished.
+ */
+static void persist_note_gc_locked(uint32_t gc_before, uint32_t elapsed_us)
+{
+	uint32_t gc = persist_backend_gc_count();
+
+	if (gc == gc_before) {
+		return;
+	}
+
+	int32_t margin_ms = persist_feed_margin_ms();
+
+	g_stats.gc_cycles += gc - gc_before;
+	g_stats.gc_min_margin_ms = MIN(g_stats.gc_min_margin_ms, margin_ms);
+	LOG_EVT(INF, "PERSIST", "GC", "gc=%u,us=%u,margin_ms=%d",
+		gc, elapsed_us, margin_ms);
+#if IS_ENABLED(CONFIG_APP_PERSIST_WEAR_TELEMETRY)
+	g_wear.erases++;
+	g_wear.save_pending = true;
+#endif
+}
+
+#if IS_ENABLED(CONFIG_APP_PERSIST_WEAR_TELEMETRY)
+static void persist_wear_fill_locked(struct persist_state_wear *out)
+{
+	out->lifetime_writes = g_wear.base.writes + g_wear.writes;
+	out->lifetime_bytes = g_wear.base.bytes + g_wear.bytes;
+	out->lifetime_erases = g_wear.base.erases + g_wear.erases;
+	out->lifetime_uptime_s = g_wear.base.uptime_s + (uint32_t)(k_uptime_get() / MSEC_PER_SEC);
+	out->sector_size = persist_backend_sector_size();
+	out->sector_count = persist_backend_sector_count();
+	out->free_bytes = (int32_t)persist_backend_free_space();
+	out->projected_days = -1;
+
+	/* The backends rotate through every sector, so the part is worn out
+	 * after endurance * sector_count erases in total.
+	 */
+	uint64_t budget = (uint64_t)CONFIG_APP_PERSIST_FLASH_ENDURANCE * out->sector_count;
+
+	if (out->lifetime_erases >= budget) {
+		out->projected_days = 0;
+	} else if (out->lifetime_erases != 0U && out->lifetime_uptime_s != 0U) {
+		uint64_t remaining_s = (budget - out->lifetime_erases) *
+				       (uint64_t)out->lifetime_uptime_s / out->lifetime_erases;
+
+		out->projected_days = (int32_t)MIN(remaining_s / (24U * 60U * 60U),
+						   (uint64_t)INT32_MAX);
+	}
+}
+
+static void persist_wear_log_locked(void)
+{
+	struct persist_state_wear wear;
+
+	persist_wear_fill_locked(&wear);
+	LOG_EVT(INF, "PERSIST", "STATS",
+		"writes=%u,bytes=%u,erases=%u,uptime_s=%u,free=%d,sectors=%ux%u,"
+		"endurance=%u,projected_days=%d",
+		wear.lifetime_writes, wear.lifetime_bytes, wear.lifetime_erases,
+		wear.lifetime_uptime_s, wear.free_bytes, wear.sector_count,
+		wear.sector_size, CONFIG_APP_PERSIST_FLASH_ENDURANCE, wear.projected_days);
+
+	for (uint32_t id = 1U; id < ARRAY_SIZE(g_wear.writes_by_id); id++) {
+		if (g_wear.writes_by_id[id] != 0U) {
+			LOG_EVT(INF, "PERSIST", "STATS_RECORD", "id=%u,writes=%u",
+				id, g_wear.writes_by_id[id]);
+		}
+	}
+}
+
+static void persist_wear_load_locked(void)
+{
+	struct persist_wear_rollup rollup;
+	ssize_t rc = persist_backend_read(PERSIST_WEAR_ID, &rollup, sizeof(rollup));
+
+	safe_memset(&g_wear, sizeof(g_wear), 0, sizeof(g_wear));
+	if (rc == sizeof(rollup) && rollup.magic == PERSIST_WEAR_MAGIC) {
+		g_wear.base = rollup;
+	}
+}
+
+static ssize_t persist_write_record(uint16_t id, const void *data, size_t len);
+
+/* Fold this boot's counters into the persisted rollup. Written after each
+ * GC (the sector was just erased, so this cannot trigger another) and on
+ * the pre-reboot flush.
+ */
+static void persist_wear_save_locked(void)
+{
+	struct persist_state_wear wear;
+
+	g_wear.save_pending = false;
+	persist_wear_fill_locked(&wear);
+
+	struct persist_wear_rollup rollup = {
+		.magic = PERSIST_WEAR_MAGIC,
+		.writes = wear.lifetime_writes,
+		.bytes = wear.lifetime_bytes,
+		.erases = wear.lifetime_erases,
+		.uptime_s = wear.lifetime_uptime_s,
+	};
+	/* Rebase so base + this boot's counters stays the lifetime total;
+	 * the rollup write itself then lands in this boot's counters.
+	 */
+	struct persist_wear_rollup rebased = {
+		.magic = PERSIST_WEAR_MAGIC,
+		.writes = rollup.writes - g_wear.writes,
+		.bytes = rollup.bytes - g_wear.bytes,
+		.erases = rollup.erases - g_wear.erases,
+		.uptime_s = g_wear.base.uptime_s,
+	};
+	ssize_t rc = persist_write_record(PERSIST_WEAR_ID, &rollup, sizeof(rollup));
+
+	if (rc < 0) {
+		LOG_EVT(WRN, "PERSIST", "STATS_SAVE_FAIL", "rc=%d", (int)rc);
+		return;
+	}
+
+	g_wear.base = rebased;
+	/* Taken after the rollup write, so that write does not count as news. */
+	g_wear.saved_writes = g_wear.writes;
+	g_wear.saved_uptime_s = (uint32_t)(k_uptime_get() / MSEC_PER_SEC);
+	persist_wear_log_locked();
+}
+
+/* Worth a write: an erase is pending, or enough writes or uptime have
+ * accumulated since the last save.
+ */
+static bool persist_wear_stale_locked(void)
+{
+	uint32_t uptime_s = (uint32_t)(k_uptime_get() / MSEC_PER_SEC);
+
+	return g_wear.save_pending ||
+	       (g_wear.writes - g_wear.saved_writes) >= CONFIG_APP_PERSIST_WEAR_SAVE_WRITES ||
+	       (uptime_s - g_wear.saved_uptime_s) >= PERSIST_WEAR_SAVE_UPTIME_S;
+}
+#endif
+
+/* Every record write goes through here so GC detection and wear counting
+ * cover all callers. Returns the backend result unchanged.
+ */
+static ssize_t persist_write_record(uint16_t id, const void *data, size_t len)
+{
+#if defined(CONFIG_ZTEST)
+	if (test_write_error != 0) {
+		return test_write_error;
+	}
+#endif
+
+	uint32_t gc_before = persist_backend_gc_count();
+	uint32_t start = k_cycle_get_32();
+	ssize_t rc = persist_backend_write(id, data, len);
+
+	persist_note_gc_locked(gc_before, k_cyc_to_us_floor32(k_cycle_get_32() - start));
+
+#if IS_ENABLED(CONFIG_APP_PERSIST_WEAR_TELEMETRY)
+	if (rc > 0) {
+		g_wear.writes++;
+		g_wear.bytes += (uint32_t)rc;
+		if (id < ARRAY_SIZE(g_wear.writes_by_id)) {
+			g_wear.writes_by_id[id]++;
+		}
+	}
+	if (g_wear.save_pending && id != PERSIST_WEAR_ID) {
+		persist_wear_save_locked();
+	}
+#endif
+	return rc;
+}
+
+/* Returns the number of bytes handed to the backend (0 when it deduplicated an
+ * unchanged value) or a negative errno.
+ */
+static int persist_write_field_record(uint16_t id, const struct persist_field *field)
+{
+	return (int)persist_write_record(id, field, sizeof(*field));
+}
+
+/* The schema marker is a field record too, so it is stored plain. Only
+ * compaction passes a non-zero generation, to defeat deduplication; the
+ * loader ignores it.
+ */
+static int persist_store_schema(uint16_t generation)
+{
+	struct persist_field schema = {
+		.tag = PERSIST_TAG_SCHEMA,
+		.version = PERSIST_SCHEMA_VERSION,
+		.reserved = generation,
+		.value = PERSIST_MAGIC,
+	};
+
+	return persist_write_field_record(PERSIST_SCHEMA_ID, &schema);
+}
+
+static int persist_mount_locked(void);
+
+static uint32_t *persist_field_slot(uint8_t tag)
+{
+	switch (tag) {
+	case PERSIST_FIELD_SESSION:
+		return &g_state.blob.session_counter;
+	case PERSIST_FIELD_CONSECUTIVE_WDT:
+		return &g_state.blob.consecutive_watchdog;
+	case PERSIST_FIELD_TOTAL_WDT:
+		return &g_state.blob.total_watchdog;
+	case PERSIST_FIELD_OVERRIDE:
+		return &g_state.blob.watchdog_override_ms;
+	default:
+		return NULL;
+	}
+}
+
+static int persist_load_field(uint8_t tag, uint32_t *value)
+{
+	struct persist_field field;
+	int rc = persist_read_field_record(PERSIST_FIELD_ID(tag), &field);
+
+	if (rc != 0) {
+		return rc;
+	}
+
+	if (field.tag != tag || field.version != PERSIST_SCHEMA_VERSION) {
+		return -EILSEQ;
+	}
+
+	*value = field.value;
+	return 0;
+}
+
+static int persist_store_field(uint8_t tag, uint32_t value)
+{
+	struct persist_field field = {
+		.tag = tag,
+		.version = PERSIST_SCHEMA_VERSION,
+		.reserved = 0U,
+		.value = value,
+	};
+
+	return persist_write_field_record(PERSIST_FIELD_ID(tag), &field);
+}
+
+/* Length of the record behind a dirty bit, for the GC check. */
+static size_t persist_dirty_len(uint8_t bit)
+{
+	switch (bit) {
+	case PERSIST_DIRTY_TASK_FAULTS:
+		return sizeof(g_state.task_faults);
+	case PERSIST_DIRTY_ESCALATION:
+		return sizeof(g_state.escalation);
+	default:
+		return PERSIST_FIELD_RECORD_LEN;
+	}
+}
+
+/* Writes the record behind one dirty bit. Same return as
+ * persist_write_field_record().
+ */
+static int persist_store_dirty(uint8_t bit)
+{
+	switch (bit) {
+	case PERSIST_DIRTY_TASK_FAULTS:
+		return (int)persist_write_record(PERSIST_TASK_FAULT_ID, &g_state.task_faults,
+						 sizeof(g_state.task_faults));
+	case PERSIST_DIRTY_ESCALATION:
+		return (int)persist_write_record(PERSIST_ESCALATION_ID, &g_state.escalation,
+						 sizeof(g_state.escalation));
+	default:
+		return persist_store_field(bit, *persist_field_slot(bit));
+	}
+}
+
+/* A write that rolls the sector runs GC and erases a page inside the
+ * backend call. Only allow that while the last feed leaves at least the
+ * configured erase budget before the watchdog deadline.
+ */
+static bool persist_gc_allowed(size_t len)
+{
+#if IS_ENABLED(CONFIG_APP_PERSIST_GC_SCHEDULING)
+	return persist_backend_fits_in_sector(len) ||
+	       (persist_feed_margin_ms() >= CONFIG_APP_PERSIST_GC_BUDGET_MS);
+#else
+	ARG_UNUSED(len);
+	return true;
+#endif
+}
+
+/* Write all dirty fields and records. Unless force is set, stops with
+ * -EAGAIN before a write that would trigger GC outside the post-feed
+ * window; the rest stays dirty for persist_gc_work_handler().
+ */
+static int persist_commit_locked(bool force)
+{
+	uint32_t start = k_cycle_get_32();
+	uint32_t bytes = 0U;
+	int rc = 0;
+
+	if (!g_state.mounted) {
+		rc = persist_mount_locked();
 		if (rc != 0) {
-			LOG_ERR("Persist blob encryption failed: %d", rc);
+			g_stats.write_failures++;
 			return rc;
 		}
-		if (cipher_len != sizeof(storage.data)) {
-			LOG_ERR("Unexpected cipher length %zu", cipher_len);
-			return -EIO;
+	}
+
+	for (uint8_t bit = 0U; bit < PERSIST_DIRTY_COUNT; bit++) {
+		if ((g_state.dirty_fields & BIT(bit)) == 0U) {
+			continue;
+		}
+
+		if (!force && !persist_gc_allowed(persist_dirty_len(bit))) {
+			rc = -EAGAIN;
+			break;
+		}
+
+		rc = persist_store_dirty(bit);
+		if (rc < 0) {
+			break;
+		}
+
+		bytes += (uint32_t)rc;
+		g_state.dirty_fields &= ~BIT(bit);
+		rc = 0;
+	}
+
+	uint32_t elapsed_us = k_cyc_to_us_floor32(k_cycle_get_32() - start);
+
+	g_stats.last_write_us = elapsed_us;
+	g_stats.max_write_us = MAX(g_stats.max_write_us, elapsed_us);
+	g_stats.total_write_us += elapsed_us;
+	g_stats.bytes_written += bytes;
+
+#if IS_ENABLED(CONFIG_APP_PERSIST_GC_SCHEDULING)
+	if (rc == -EAGAIN) {
+		if (!gc_deferred) {
+			LOG_EVT(INF, "PERSIST", "GC_DEFERRED", "dirty=0x%x,margin_ms=%d",
+				g_state.dirty_fields, persist_feed_margin_ms());
+		}
+		gc_deferred = true;
+		g_stats.gc_deferred++;
+		return rc;
+	}
+#endif
+
+	if (rc < 0) {
+		g_stats.write_failures++;
+		LOG_ERR("Persistent write failed: %d", rc);
+		LOG_EVT(ERR, "PERSIST", "WRITE_FAIL", "rc=%d", rc);
+		return rc;
+	}
+
+	g_stats.writes++;
+#if IS_ENABLED(CONFIG_APP_PERSIST_WRITE_BEHIND)
+	flush_error = 0;
+#endif
+	return 0;
+}
+
+/* Read-through cache fill at mount. Loads schema v1 field records, or
+ * migrates the legacy single-blob record once: fields first, then the
+ * schema marker, then the legacy record is deleted, so an interrupted
+ * migration simply reruns on the next boot.
+ */
+static void persist_load_cache_locked(void)
+{
+	struct persist_field schema;
+	int rc = persist_read_field_record(PERSIST_SCHEMA_ID, &schema);
+
+	safe_memset(&g_state.blob, sizeof(g_state.blob), 0, sizeof(g_state.blob));
+	g_state.blob.magic = PERSIST_MAGIC;
+
+	if (rc == 0 && schema.tag == PERSIST_TAG_SCHEMA &&
+	    schema.version == PERSIST_SCHEMA_VERSION && schema.value == PERSIST_MAGIC) {
+		for (uint8_t tag = 0U; tag < PERSIST_FIELD_COUNT; tag++) {
+			uint32_t value = 0U;
+
+			if (persist_load_field(tag, &value) == 0) {
+				*persist_field_slot(tag) = value;
+			}
 		}
-		return nvs_write(&g_state.fs, PERSIST_RECORD_ID,
-				 &storage, sizeof(storage));
+		return;
+	}
+
+	struct persist_blob legacy;
+	bool migrated = false;
+
+	rc = persist_load_blob(&legacy);
+	if (rc == 0 && legacy.magic == PERSIST_MAGIC) {
+		g_state.blob = legacy;
+		g_state.dirty_fields = PERSIST_FIELDS_ALL;
+		if (persist_commit_locked(true) != 0) {
+			return;
+		}
+		migrated = true;
+	}
+
+	rc = persist_store_schema(0U);
+	if (rc < 0) {
+		LOG_EVT(ERR, "PERSIST", "SCHEMA_WRITE_FAIL", "rc=%d", rc);
+		return;
+	}
+
+	if (migrated) {
+		(void)persist_backend_delete(PERSIST_RECORD_ID);
+		LOG_EVT(INF, "PERSIST", "MIGRATED", "schema=%u", PERSIST_SCHEMA_VERSION);
 	}
+}
+
+/* Plain records are read once per cold load; after that they live in
+ * g_state and only the commit path touches flash.
+ */
+static void persist_load_records_locked(void)
+{
+	ssize_t rc = persist_backend_read(PERSIST_TASK_FAULT_ID, &g_state.task_faults,
+					  sizeof(g_state.task_faults));
+
+	if (rc != sizeof(g_state.task_faults) ||
+	    g_state.task_faults.magic != PERSIST_TASK_FAULT_MAGIC) {
+		safe_memset(&g_state.task_faults, sizeof(g_state.task_faults), 0,
+			    sizeof(g_state.task_faults));
+		g_state.task_faults.magic = PERSIST_TASK_FAULT_MAGIC;
+	}
+
+	rc = persist_backend_read(PERSIST_ESCALATION_ID, &g_state.escalation,
+				  sizeof(g_state.escalation));
+	if (rc != sizeof(g_state.escalation) ||
+	    g_state.escalation.magic != PERSIST_ESCALATION_MAGIC) {
+		safe_memset(&g_state.escalation, sizeof(g_state.escalation), 0,
+			    sizeof(g_state.escalation));
+		g_state.escalation.magic = PERSIST_ESCALATION_MAGIC;
+	}
+}
+
+/* Writers already serialize on state_lock. The scheduler lock keeps the
+ * odd-sequence window from being preempted, so a higher-priority reader
+ * can never spin on a half-published snapshot.
+ */
+static void persist_publish_locked(void)
+{
+	k_sched_lock();
+	(void)atomic_inc(&snapshot_seq);
+	g_snapshot = g_state.blob;
+	(void)atomic_inc(&snapshot_seq);
+	k_sched_unlock();
+}
+
+static void persist_read_snapshot(struct persist_blob *out)
+{
+	atomic_val_t seq;
+
+	do {
+		seq = atomic_get(&snapshot_seq);
+		*out = g_snapshot;
+	} while (((seq & 1) != 0) || (atomic_get(&snapshot_seq) != seq));
+}
+
+#if IS_ENABLED(CONFIG_APP_PERSIST_WARM_CACHE)
+/* Everything persist_state needs to resume after a software reboot without
+ * touching flash. Every boot consumes the cache on its first persist_state
+ * call, so an armed cache was always armed by the boot just before this one.
+ * boot_count only numbers boots for the log.
+ */
+struct persist_warm_cache {
+	uint32_t magic;
+	uint32_t boot_count;
+	uint32_t armed;
+	struct persist_blob blob;
+	struct persist_task_faults task_faults;
+	struct persist_escalation escalation;
+	uint32_t session_next;
+#if IS_ENABLED(CONFIG_APP_CRYPTO_BACKEND_CURVE25519)
+	/* Only filled while armed, so the scalar never outlives the handover. */
+	struct persist_curve_secret curve_secret;
+	struct persist_curve_peer curve_peer;
 #endif
+	uint32_t crc;
+};
 
-	return nvs_write(&g_state.fs, PERSIST_RECORD_ID,
-			 blob, sizeof(*blob));
+#if DT_NODE_EXISTS(PERSIST_RETAINED_NODE)
+static const struct device *const warm_dev = DEVICE_DT_GET(PERSIST_RETAINED_NODE);
+
+static int persist_warm_read(struct persist_warm_cache *cache)
+{
+	if (!device_is_ready(warm_dev)) {
+		return -ENODEV;
+	}
+
+	return retained_mem_read(warm_dev, 0, (uint8_t *)cache, sizeof(*cache));
+}
+
+static int persist_warm_write(const struct persist_warm_cache *cache)
+{
+	if (!device_is_ready(warm_dev)) {
+		return -ENODEV;
+	}
+
+	return retained_mem_write(warm_dev, 0, (const uint8_t *)cache, sizeof(*cache));
+}
+#else
+/* No retained_mem node: .noinit RAM is not cleared by a warm reset either. */
+static __noinit struct persist_warm_cache warm_ram;
+
+static int persist_warm_read(struct persist_warm_cache *cache)
+{
+	*cache = warm_ram;
+	return 0;
+}
+
+static int persist_warm_write(const struct persist_warm_cache *cache)
+{
+	warm_ram = *cache;
+	return 0;
+}
+#endif
+
+static uint32_t warm_boot_count;
+static bool warm_checked;
+static bool warm_armed;
+
+#if IS_ENABLED(CONFIG_APP_CRYPTO_BACKEND_CURVE25519)
+/* Curve25519 records handed over by an armed warm reboot, so that
+ * app_crypto_init() does not wait for the mount. Wiped once it mounts.
+ */
+static struct {
+	struct persist_curve_secret secret;
+	struct persist_curve_peer peer;
+} warm_curve;
+
+static void persist_warm_curve_read(uint16_t id, void *out, size_t len)
+{
+	if (persist_backend_read(id, out, len) != (ssize_t)len) {
+		safe_memset(out, len, 0, len);
+	}
+}
+
+/* From flash, or from the previous handover if the backend is not mounted
+ * yet (a warm boot that is re-armed before warm_mount_work has run).
+ */
+static void persist_warm_curve_fill_locked(struct persist_warm_cache *cache)
+{
+	if (!g_state.mounted) {
+		cache->curve_secret = warm_curve.secret;
+		cache->curve_peer = warm_curve.peer;
+		return;
+	}
+
+	persist_warm_curve_read(PERSIST_CURVE_SECRET_ID, &cache->curve_secret,
+				sizeof(cache->curve_secret));
+	persist_warm_curve_read(PERSIST_CURVE_PEER_ID, &cache->curve_peer,
+				sizeof(cache->curve_peer));
+}
+#endif
+
+static void persist_warm_mount_work_handler(struct k_work *work);
+static K_WORK_DEFINE(warm_mount_work, persist_warm_mount_work_handler);
+
+static uint32_t persist_warm_crc(const struct persist_warm_cache *cache)
+{
+	return crc32_ieee((const uint8_t *)cache, offsetof(struct persist_warm_cache, crc));
+}
+
+static void persist_warm_store_locked(bool arm)
+{
+	struct persist_warm_cache cache = {
+		.magic = PERSIST_WARM_MAGIC,
+		.boot_count = warm_boot_count,
+		.armed = arm ? PERSIST_WARM_ARMED : 0U,
+		.blob = g_state.blob,
+		.task_faults = g_state.task_faults,
+		.escalation = g_state.escalation,
+		.session_next = g_state.session_next,
+	};
+
+#if IS_ENABLED(CONFIG_APP_CRYPTO_BACKEND_CURVE25519)
+	if (arm) {
+		persist_warm_curve_fill_locked(&cache);
+	}
+#endif
+	cache.crc = persist_warm_crc(&cache);
+	if (persist_warm_write(&cache) == 0) {
+		warm_armed = arm;
+	}
+}
+
+/* Any change after arming would be lost by a restore, so drop the arm. */
+static void persist_warm_disarm_locked(void)
+{
+	if (warm_armed) {
+		persist_warm_store_locked(false);
+	}
+}
+
+/* Once per boot: bump the retained boot count and, if the previous boot
+ * armed the cache just before rebooting, load g_state from it.
+ */
+static bool persist_warm_restore_locked(void)
+{
+	if (warm_checked) {
+		return false;
+	}
+
+	uint32_t start = k_cycle_get_32();
+	struct persist_warm_cache cache;
+	bool valid = (persist_warm_read(&cache) == 0) &&
+		     (cache.magic == PERSIST_WARM_MAGIC) &&
+		     (cache.crc == persist_warm_crc(&cache));
+	bool usable = valid && (cache.armed == PERSIST_WARM_ARMED) &&
+		      (cache.blob.magic == PERSIST_MAGIC);
+
+	warm_checked = true;
+	warm_boot_count = valid ? (cache.boot_count + 1U) : 1U;
+
+	if (usable) {
+		g_state.blob = cache.blob;
+		g_state.task_faults = cache.task_faults;
+		g_state.escalation = cache.escalation;
+		g_state.session_next = cache.session_next;
+#if IS_ENABLED(CONFIG_APP_CRYPTO_BACKEND_CURVE25519)
+		warm_curve.secret = cache.curve_secret;
+		warm_curve.peer = cache.curve_peer;
+#endif
+	}
+
+	/* Consume it: a later reset that was not armed must go to flash. */
+	persist_warm_store_locked(false);
+	safe_memset(&cache, sizeof(cache), 0, sizeof(cache));
+
+	if (usable) {
+		LOG_EVT(INF, "PERSIST", "WARM_RESTORE", "boot=%u,us=%u", warm_boot_count,
+			k_cyc_to_us_floor32(k_cycle_get_32() - start));
+	}
+
+	return usable;
+}
+
+static void persist_warm_mount_work_handler(struct k_work *work)
+{
+	ARG_UNUSED(work);
+
+	k_mutex_lock(&state_lock, K_FOREVER);
+
+	if (!g_state.mounted) {
+		uint32_t start = k_cycle_get_32();
+		int rc = persist_mount_locked();
+
+		LOG_EVT(INF, "PERSIST", "WARM_MOUNT", "rc=%d,us=%u", rc,
+			k_cyc_to_us_floor32(k_cycle_get_32() - start));
+	}
+
+	k_mutex_unlock(&state_lock);
+}
+
+#if defined(CONFIG_ZTEST)
+static void persist_warm_test_forget(void)
+{
+	struct persist_warm_cache cache = {0};
+
+	(void)persist_warm_write(&cache);
+	warm_checked = false;
+	warm_armed = false;
+}
+#endif
+#endif
+
+/* Record a change to the given fields. With write-behind enabled the flush
+ * thread picks it up after the settle time, and the return value is the
+ * error of an earlier background commit that is still not on flash (the
+ * new change is queued either way). Otherwise it is committed immediately.
+ */
+static int persist_update_locked(uint32_t fields)
+{
+	g_stats.updates++;
+	g_state.dirty_fields |= fields;
+	persist_publish_locked();
+#if IS_ENABLED(CONFIG_APP_PERSIST_WARM_CACHE)
+	persist_warm_disarm_locked();
+#endif
+
+#if IS_ENABLED(CONFIG_APP_PERSIST_WRITE_BEHIND)
+	int rc = flush_error;
+
+	/* Report a failure once; the fields stay dirty and are retried. */
+	flush_error = 0;
+	k_sem_give(&flush_sem);
+	return rc;
+#else
+	int rc = persist_commit_locked(false);
+
+	/* Deferred: the cached value is already published and will be written
+	 * after the next watchdog feed.
+	 */
+	return (rc == -EAGAIN) ? 0 : rc;
+#endif
+}
+
+#if IS_ENABLED(CONFIG_APP_PERSIST_GC_SCHEDULING)
+/* Rewrite the schema marker (with a new generation in its reserved field so
+ * the backend cannot deduplicate it) until the write sector has
+ * CONFIG_APP_PERSIST_GC_HEADROOM bytes free. This pulls the next
+ * sector roll-over into the post-feed window instead of leaving it for
+ * whichever caller happens to write next.
+ */
+static void persist_compact_locked(void)
+{
+	uint32_t gc_before = persist_backend_gc_count();
+	uint32_t writes = 0U;
+
+	while (!persist_backend_fits_in_sector(CONFIG_APP_PERSIST_GC_HEADROOM) &&
+	       (persist_backend_gc_count() == gc_before) &&
+	       (persist_feed_margin_ms() >= CONFIG_APP_PERSIST_GC_BUDGET_MS)) {
+		int rc = persist_store_schema(++compact_generation);
+
+		if (rc < 0) {
+			LOG_EVT(ERR, "PERSIST", "COMPACT_FAIL", "rc=%d", rc);
+			return;
+		}
+		if (rc == 0) {
+			break;
+		}
+		g_stats.bytes_written += (uint32_t)rc;
+		writes++;
+	}
+
+	if (writes != 0U) {
+		LOG_EVT(INF, "PERSIST", "COMPACT", "writes=%u", writes);
+	}
+}
+
+/* Runs on the system workqueue right after the supervisor reports a feed,
+ * i.e. with (almost) the whole watchdog timeout ahead of it.
+ */
+static void persist_gc_work_handler(struct k_work *work)
+{
+	ARG_UNUSED(work);
+
+	k_mutex_lock(&state_lock, K_FOREVER);
+
+	if (g_state.loaded) {
+		if (g_state.dirty_fields != 0U && persist_commit_locked(false) == 0) {
+			gc_deferred = false;
+		}
+		if (g_state.mounted) {
+			persist_compact_locked();
+		}
+	}
+
+	k_mutex_unlock(&state_lock);
+}
+#endif
+
+#if IS_ENABLED(CONFIG_APP_PERSIST_WRITE_BEHIND)
+static void persist_flush_thread(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	k_thread_name_set(k_current_get(), "persist_flush");
+
+	while (1) {
+		k_sem_take(&flush_sem, K_FOREVER);
+
+		/* Let a burst of updates settle so it lands as one commit. */
+		k_msleep(CONFIG_APP_PERSIST_FLUSH_SETTLE_MS);
+		k_sem_reset(&flush_sem);
+
+		k_mutex_lock(&state_lock, K_FOREVER);
+		if (g_state.dirty_fields != 0U) {
+			int rc = persist_commit_locked(false);
+
+			/* -EAGAIN only defers to the post-feed GC window. */
+			if (rc < 0 && rc != -EAGAIN) {
+				flush_error = rc;
+			}
+		}
+		k_mutex_unlock(&state_lock);
+	}
 }
 
-static int persist_commit_locked(void)
+static void start_flush_thread_locked(void)
 {
-	int rc = persist_store_blob(&g_state.blob);
-
-	if (rc < 0) {
-		LOG_ERR("Persistent write failed: %d", rc);
-		LOG_EVT(ERR, "PERSIST", "WRITE_FAIL", "rc=%d", rc);
-		return rc;
+	if (flush_thread_started) {
+		return;
 	}
 
-	return 0;
+	k_thread_create(&persist_flush_tid, persist_flush_stack,
+			K_THREAD_STACK_SIZEOF(persist_flush_stack),
+			persist_flush_thread, NULL, NULL, NULL,
+			PERSIST_FLUSH_THREAD_PRIORITY, 0, K_NO_WAIT);
+	flush_thread_started = true;
 }
+#endif
 
-static int init_fs_if_needed(void)
+/* Open the storage partition and mount the backend (with retries). */
+static int persist_mount_locked(void)
 {
-	if (g_state.loaded) {
-		return 0;
-	}
-
 	const struct flash_area *fa = NULL;
 	int rc = 0;
 
+#if defined(CONFIG_ZTEST)
+	if (test_mount_error != 0) {
+		return test_mount_error;
+	}
+#endif
+
 	for (int attempt = 1; attempt <= PERSIST_RETRY_LIMIT; ++attempt) {
 		rc = flash_area_open(DT_FIXED_PARTITION_ID(STORAGE_PARTITION_NODE), &fa);
 		if (rc == 0) {
@@ -267,8 +1193,7 @@ static int init_fs_if_needed(void)
 		return rc;
 	}
 
-	g_state.fs.flash_device = fa->fa_dev;
-	if (!device_is_ready(g_state.fs.flash_device)) {
+	if (!device_is_ready(fa->fa_dev)) {
 		LOG_ERR("Storage flash device not ready");
 		LOG_EVT(ERR, "PERSIST", "FLASH_NOT_READY", "dev_id=%u",
 			DT_FIXED_PARTITION_ID(STORAGE_PARTITION_NODE));
@@ -276,11 +1201,8 @@ static int init_fs_if_needed(void)
 		return -EBUSY;
 	}
 
-	g_state.fs.offset = fa->fa_off;
-
 	struct flash_pages_info page_info;
-	rc = flash_get_page_info_by_offs(g_state.fs.flash_device,
-					 g_state.fs.offset, &page_info);
+	rc = flash_get_page_info_by_offs(fa->fa_dev, fa->fa_off, &page_info);
 	if (rc != 0) {
 		LOG_ERR("flash_get_page_info_by_offs failed: %d", rc);
 		LOG_EVT(ERR, "PERSIST", "FLASH_PAGE_INFO_FAIL", "rc=%d", rc);
@@ -288,13 +1210,16 @@ static int init_fs_if_needed(void)
 		return rc;
 	}
 
-	g_state.fs.sector_size = page_info.size;
-	g_state.fs.sector_count = fa->fa_size / page_info.size;
-
+	rc = persist_backend_configure(fa->fa_dev, fa->fa_off, page_info.size,
+				       fa->fa_size / page_info.size);
 	flash_area_close(fa);
+	if (rc != 0) {
+		LOG_EVT(ERR, "PERSIST", "BACKEND_CONFIG_FAIL", "rc=%d", rc);
+		return rc;
+	}
 
 	for (int attempt = 1; attempt <= PERSIST_RETRY_LIMIT; ++attempt) {
-		rc = nvs_mount(&g_state.fs);
+		rc = persist_backend_mount();
 		if (rc == 0) {
 			if (attempt > 1) {
 				LOG_EVT(INF, "PERSIST", "NVS_MOUNT_RECOVERED", "attempt=%d", attempt);
@@ -302,8 +1227,8 @@ static int init_fs_if_needed(void)
 			break;
 		}
 
-		LOG_WRN("Failed to mount NVS (attempt %d/%d): %d",
-			attempt, PERSIST_RETRY_LIMIT, rc);
+		LOG_WRN("Failed to mount %s (attempt %d/%d): %d",
+			persist_backend_name(), attempt, PERSIST_RETRY_LIMIT, rc);
 		LOG_EVT(WRN, "PERSIST", "NVS_MOUNT_RETRY", "attempt=%d,rc=%d", attempt, rc);
 
 		if (attempt < PERSIST_RETRY_LIMIT) {
@@ -316,33 +1241,91 @@ static int init_fs_if_needed(void)
 		return rc;
 	}
 
-	struct persist_blob tmp;
-	rc = persist_load_blob(&tmp);
-	if (rc == 0 && tmp.magic == PERSIST_MAGIC) {
-		g_state.blob = tmp;
-	} else {
-		g_state.blob.magic = PERSIST_MAGIC;
-		g_state.blob.consecutive_watchdog = 0U;
-		g_state.blob.total_watchdog = 0U;
-		g_state.blob.watchdog_override_ms = 0U;
-		g_state.blob.session_counter = 0U;
-		(void)persist_commit_locked();
-	}
+	g_state.mounted = true;
+#if IS_ENABLED(CONFIG_APP_PERSIST_WEAR_TELEMETRY)
+	persist_wear_load_locked();
+#endif
+#if IS_ENABLED(CONFIG_APP_PERSIST_WARM_CACHE) && IS_ENABLED(CONFIG_APP_CRYPTO_BACKEND_CURVE25519)
+	safe_memset(&warm_curve, sizeof(warm_curve), 0, sizeof(warm_curve));
+#endif
+	return 0;
+}
 
+static void persist_mark_loaded_locked(void)
+{
+	persist_publish_locked();
 	g_state.loaded = true;
-	LOG_INF("Persistent state loaded: consecutive=%u total=%u override=%u",
+#if IS_ENABLED(CONFIG_APP_PERSIST_WRITE_BEHIND)
+	start_flush_thread_locked();
+#endif
+}
+
+/* Ensure the backend is mounted and the RAM cache loaded. Everything that
+ * touches flash goes through here.
+ */
+static int init_fs_if_needed(void)
+{
+	if (!g_state.mounted) {
+		int rc = persist_mount_locked();
+
+		if (rc != 0) {
+			return rc;
+		}
+	}
+
+	if (g_state.loaded) {
+		return 0;
+	}
+
+#if IS_ENABLED(CONFIG_APP_PERSIST_WARM_CACHE)
+	if (persist_warm_restore_locked()) {
+		persist_mark_loaded_locked();
+		return 0;
+	}
+#endif
+
+	persist_load_cache_locked();
+	persist_load_records_locked();
+
+	/* Skip past whatever the previous boot may have leased. */
+	g_state.session_next = g_state.blob.session_counter;
+	persist_mark_loaded_locked();
+	LOG_INF("Persistent state loaded (%s): consecutive=%u total=%u override=%u session_hwm=%u",
+		persist_backend_name(),
 		g_state.blob.consecutive_watchdog,
 		g_state.blob.total_watchdog,
-		g_state.blob.watchdog_override_ms);
+		g_state.blob.watchdog_override_ms,
+		g_state.blob.session_counter);
 	return 0;
 }
 
+/* Ensure the RAM cache is loaded. After an armed warm reboot it comes from
+ * retained RAM and the backend mounts later on the system workqueue (or on
+ * the first commit, whichever comes first).
+ */
+static int init_state_if_needed(void)
+{
+	if (g_state.loaded) {
+		return 0;
+	}
+
+#if IS_ENABLED(CONFIG_APP_PERSIST_WARM_CACHE)
+	if (persist_warm_restore_locked()) {
+		persist_mark_loaded_locked();
+		(void)k_work_submit(&warm_mount_work);
+		return 0;
+	}
+#endif
+
+	return init_fs_if_needed();
+}
+
 int persist_state_init(void)
 {
 	int rc;
 
 	k_mutex_lock(&state_lock, K_FOREVER);
-	rc = init_fs_if_needed();
+	rc = init_state_if_needed();
 	k_mutex_unlock(&state_lock);
 
 	return rc;
@@ -352,19 +1335,28 @@ void persist_state_record_boot(bool watchdog_reset)
 {
 	k_mutex_lock(&state_lock, K_FOREVER);
 
-	if (init_fs_if_needed() != 0) {
+	if (init_state_if_needed() != 0) {
 		k_mutex_unlock(&state_lock);
 		return;
 	}
 
+	bool dirty = false;
+
 	if (watchdog_reset) {
 		g_state.blob.consecutive_watchdog++;
 		g_state.blob.total_watchdog++;
+		dirty = true;
 	} else if (g_state.blob.consecutive_watchdog != 0U) {
 		g_state.blob.consecutive_watchdog = 0U;
+		dirty = true;
 	}
 
-	(void)persist_commit_locked();
+	if (dirty) {
+		(void)persist_update_locked(watchdog_reset ?
+					    (BIT(PERSIST_FIELD_CONSECUTIVE_WDT) |
+					     BIT(PERSIST_FIELD_TOTAL_WDT)) :
+					    BIT(PERSIST_FIELD_CONSECUTIVE_WDT));
+	}
 	k_mutex_unlock(&state_lock);
 }
 
@@ -372,10 +1364,10 @@ void persist_state_clear_watchdog_counter(void)
 {
 	k_mutex_lock(&state_lock, K_FOREVER);
 
-	if (init_fs_if_needed() == 0 &&
+	if (init_state_if_needed() == 0 &&
 	    g_state.blob.consecutive_watchdog != 0U) {
 		g_state.blob.consecutive_watchdog = 0U;
-		(void)persist_commit_locked();
+		(void)persist_update_locked(BIT(PERSIST_FIELD_CONSECUTIVE_WDT));
 	}
 
 	k_mutex_unlock(&state_lock);
@@ -383,18 +1375,18 @@ void persist_state_clear_watchdog_counter(void)
 
 uint32_t persist_state_get_consecutive_watchdog(void)
 {
-	k_mutex_lock(&state_lock, K_FOREVER);
-	uint32_t value = g_state.blob.consecutive_watchdog;
-	k_mutex_unlock(&state_lock);
-	return value;
+	struct persist_blob snap;
+
+	persist_read_snapshot(&snap);
+	return snap.consecutive_watchdog;
 }
 
 uint32_t persist_state_get_total_watchdog(void)
 {
-	k_mutex_lock(&state_lock, K_FOREVER);
-	uint32_t value = g_state.blob.total_watchdog;
-	k_mutex_unlock(&state_lock);
-	return value;
+	struct persist_blob snap;
+
+	persist_read_snapshot(&snap);
+	return snap.total_watchdog;
 }
 
 bool persist_state_is_fallback_active(void)
@@ -405,10 +1397,10 @@ bool persist_state_is_fallback_active(void)
 
 uint32_t persist_state_get_watchdog_override(void)
 {
-	k_mutex_lock(&state_lock, K_FOREVER);
-	uint32_t value = g_state.blob.watchdog_override_ms;
-	k_mutex_unlock(&state_lock);
-	return value;
+	struct persist_blob snap;
+
+	persist_read_snapshot(&snap);
+	return snap.watchdog_override_ms;
 }
 
 int persist_state_set_watchdog_override(uint32_t timeout_ms)
@@ -417,14 +1409,14 @@ int persist_state_set_watchdog_override(uint32_t timeout_ms)
 
 	k_mutex_lock(&state_lock, K_FOREVER);
 
-	if (init_fs_if_needed() != 0) {
+	if (init_state_if_needed() != 0) {
 		k_mutex_unlock(&state_lock);
 		return -EIO;
 	}
 
 	if (g_state.blob.watchdog_override_ms != timeout_ms) {
 		g_state.blob.watchdog_override_ms = timeout_ms;
-		rc = persist_commit_locked();
+		rc = persist_update_locked(BIT(PERSIST_FIELD_OVERRIDE));
 	}
 
 	k_mutex_unlock(&state_lock);
@@ -437,32 +1429,278 @@ uint32_t persist_state_next_session_counter(void)
 
 	k_mutex_lock(&state_lock, K_FOREVER);
 
-	if (init_fs_if_needed() == 0) {
-		g_state.blob.session_counter++;
-		value = g_state.blob.session_counter;
-		(void)persist_commit_locked();
+	if (init_state_if_needed() == 0) {
+#if IS_ENABLED(CONFIG_APP_PERSIST_WARM_CACHE)
+		persist_warm_disarm_locked();
+#endif
+		if (g_state.session_next >= g_state.blob.session_counter) {
+			/* Lease exhausted: persist the next high-water mark before
+			 * handing out any value from it. This bypasses write-behind
+			 * so a crash can never reissue a counter. The mark is a
+			 * plain field record: the next boot reads it before any
+			 * session key exists, rekey worker call or not.
+			 */
+			uint32_t prev_hwm = g_state.blob.session_counter;
+			uint32_t prev_dirty = g_state.dirty_fields;
+			int rc;
+
+			g_state.blob.session_counter = g_state.session_next +
+						       PERSIST_SESSION_LEASE;
+			g_stats.updates++;
+			g_state.dirty_fields |= BIT(PERSIST_FIELD_SESSION);
+			rc = persist_commit_locked(true);
+			if (rc != 0) {
+				/* Nothing from an unpersisted lease may be issued. */
+				g_state.blob.session_counter = prev_hwm;
+				g_state.dirty_fields = (g_state.dirty_fields &
+							~BIT(PERSIST_FIELD_SESSION)) |
+						       (prev_dirty & BIT(PERSIST_FIELD_SESSION));
+				LOG_EVT(ERR, "PERSIST", "SESSION_LEASE_FAIL", "rc=%d", rc);
+			} else {
+				LOG_DBG("Session lease reserved up to %u",
+					g_state.blob.session_counter);
+			}
+		}
+		if (g_state.session_next < g_state.blob.session_counter) {
+			g_state.session_next++;
+			value = g_state.session_next;
+		}
 	}
 
 	k_mutex_unlock(&state_lock);
 	return value;
 }
 
-#if IS_ENABLED(CONFIG_APP_CRYPTO_BACKEND_CURVE25519)
-int persist_state_curve25519_get_secret(uint8_t out[CURVE25519_KEY_SIZE])
+int persist_state_flush(void)
+{
+	int rc = 0;
+
+	k_mutex_lock(&state_lock, K_FOREVER);
+
+	if (g_state.loaded && g_state.dirty_fields != 0U) {
+		rc = persist_commit_locked(true);
+	}
+
+#if IS_ENABLED(CONFIG_APP_PERSIST_WEAR_TELEMETRY)
+	if (g_state.loaded && init_fs_if_needed() == 0 && persist_wear_stale_locked()) {
+		persist_wear_save_locked();
+	}
+#endif
+
+	k_mutex_unlock(&state_lock);
+	return rc;
+}
+
+int persist_state_prepare_warm_reboot(void)
+{
+	int rc = persist_state_flush();
+
+#if IS_ENABLED(CONFIG_APP_PERSIST_WARM_CACHE)
+	k_mutex_lock(&state_lock, K_FOREVER);
+
+	/* Only hand over state that is also on flash. */
+	if (rc == 0 && g_state.loaded && g_state.dirty_fields == 0U) {
+		persist_warm_store_locked(true);
+		LOG_EVT(INF, "PERSIST", "WARM_ARMED", "boot=%u", warm_boot_count);
+	}
+
+	k_mutex_unlock(&state_lock);
+#endif
+	return rc;
+}
+
+void persist_state_watchdog_fed(uint32_t timeout_ms)
+{
+	atomic_set(&feed_uptime_ms, (atomic_val_t)k_uptime_get_32());
+	atomic_set(&feed_timeout_ms, (atomic_val_t)timeout_ms);
+
+#if IS_ENABLED(CONFIG_APP_PERSIST_GC_SCHEDULING)
+	(void)k_work_submit(&gc_work);
+#endif
+}
+
+void persist_state_get_stats(struct persist_state_stats *out)
+{
+	if (out == NULL) {
+		return;
+	}
+
+	k_mutex_lock(&state_lock, K_FOREVER);
+	*out = g_stats;
+	k_mutex_unlock(&state_lock);
+}
+
+int persist_state_get_wear(struct persist_state_wear *out)
 {
+#if IS_ENABLED(CONFIG_APP_PERSIST_WEAR_TELEMETRY)
 	if (out == NULL) {
 		return -EINVAL;
 	}
 
+	k_mutex_lock(&state_lock, K_FOREVER);
+
 	int rc = init_fs_if_needed();
+
+	if (rc == 0) {
+		persist_wear_fill_locked(out);
+	}
+
+	k_mutex_unlock(&state_lock);
+	return rc;
+#else
+	ARG_UNUSED(out);
+	return -ENOTSUP;
+#endif
+}
+
+int persist_state_note_task_fault(uint8_t slot)
+{
+	if (slot >= CONFIG_APP_SUPERVISOR_MAX_TASKS) {
+		return -EINVAL;
+	}
+
+	k_mutex_lock(&state_lock, K_FOREVER);
+
+	int rc = init_state_if_needed();
+
+	if (rc == 0) {
+		uint16_t *count = &g_state.task_faults.count[slot];
+
+		if (*count < UINT16_MAX) {
+			(*count)++;
+		}
+		rc = persist_update_locked(BIT(PERSIST_DIRTY_TASK_FAULTS));
+		if (rc == 0) {
+			rc = *count;
+		}
+	}
+
+	k_mutex_unlock(&state_lock);
+	return rc;
+}
+
+uint32_t persist_state_get_task_faults(uint8_t slot)
+{
+	if (slot >= CONFIG_APP_SUPERVISOR_MAX_TASKS) {
+		return 0U;
+	}
+
+	uint32_t count = 0U;
+
+	k_mutex_lock(&state_lock, K_FOREVER);
+
+	if (init_state_if_needed() == 0) {
+		count = g_state.task_faults.count[slot];
+	}
+
+	k_mutex_unlock(&state_lock);
+	return count;
+}
+
+int persist_state_set_escalation(const struct persist_state_escalation *in)
+{
+	if (in == NULL) {
+		return -EINVAL;
+	}
+
+	struct persist_escalation record = {
+		.magic = PERSIST_ESCALATION_MAGIC,
+		.stage = in->stage,
+		.task_mask = in->task_mask,
+		.elapsed_ms = in->elapsed_ms,
+	};
+
+	k_mutex_lock(&state_lock, K_FOREVER);
+
+	int rc = init_state_if_needed();
+
+	if (rc == 0 && memcmp(&g_state.escalation, &record, sizeof(record)) != 0) {
+		g_state.escalation = record;
+		rc = persist_update_locked(BIT(PERSIST_DIRTY_ESCALATION));
+	}
+
+	k_mutex_unlock(&state_lock);
+	return rc;
+}
+
+void persist_state_get_escalation(struct persist_state_escalation *out)
+{
+	safe_memset(out, sizeof(*out), 0, sizeof(*out));
+	k_mutex_lock(&state_lock, K_FOREVER);
+
+	if (init_state_if_needed() == 0) {
+		out->stage = g_state.escalation.stage;
+		out->task_mask = g_state.escalation.task_mask;
+		out->elapsed_ms = g_state.escalation.elapsed_ms;
+	}
+
+	k_mutex_unlock(&state_lock);
+}
+
+void persist_state_log_wear(void)
+{
+#if IS_ENABLED(CONFIG_APP_PERSIST_WEAR_TELEMETRY)
+	k_mutex_lock(&state_lock, K_FOREVER);
+
+	if (init_fs_if_needed() == 0) {
+		persist_wear_log_locked();
+	}
+
+	k_mutex_unlock(&state_lock);
+#endif
+}
+
+#if IS_ENABLED(CONFIG_APP_CRYPTO_BACKEND_CURVE25519)
+/* Loads the state like any other call, so an armed warm boot does not mount
+ * here. Returns 0 with out filled from the warm handover, 1 when the caller
+ * has to read the record from the (now mounted) backend, or a negative errno.
+ */
+static int persist_curve_ready_locked(uint16_t id, uint8_t out[CURVE25519_KEY_SIZE])
+{
+	int rc = init_state_if_needed();
+
 	if (rc != 0) {
 		return rc;
 	}
 
+#if IS_ENABLED(CONFIG_APP_PERSIST_WARM_CACHE)
+	/* A handover always has the scalar; a peer it lacks is not on flash. */
+	if (!g_state.mounted && warm_curve.secret.magic == PERSIST_CURVE_SECRET_MAGIC) {
+		if (id == PERSIST_CURVE_SECRET_ID) {
+			memcpy(out, warm_curve.secret.secret, CURVE25519_KEY_SIZE);
+			return 0;
+		}
+		if (warm_curve.peer.magic != PERSIST_CURVE_PEER_MAGIC) {
+			return -ENOENT;
+		}
+		memcpy(out, warm_curve.peer.peer, CURVE25519_KEY_SIZE);
+		return 0;
+	}
+#else
+	ARG_UNUSED(id);
+	ARG_UNUSED(out);
+#endif
+
+	rc = init_fs_if_needed();
+	return (rc != 0) ? rc : 1;
+}
+
+int persist_state_curve25519_get_secret(uint8_t out[CURVE25519_KEY_SIZE])
+{
+	if (out == NULL) {
+		return -EINVAL;
+	}
+
 	k_mutex_lock(&state_lock, K_FOREVER);
 
+	int rc = persist_curve_ready_locked(PERSIST_CURVE_SECRET_ID, out);
+	if (rc <= 0) {
+		k_mutex_unlock(&state_lock);
+		return rc;
+	}
+
 	struct persist_curve_secret record = {0};
-	rc = nvs_read(&g_state.fs, PERSIST_CURVE_SECRET_ID, &record, sizeof(record));
+	rc = persist_backend_read(PERSIST_CURVE_SECRET_ID, &record, sizeof(record));
 	if (rc == sizeof(record) && record.magic == PERSIST_CURVE_SECRET_MAGIC) {
 		memcpy(out, record.secret, CURVE25519_KEY_SIZE);
 		k_mutex_unlock(&state_lock);
@@ -476,7 +1714,7 @@ int persist_state_curve25519_get_secret(uint8_t out[CURVE25519_KEY_SIZE])
 	}
 	record.magic = PERSIST_CURVE_SECRET_MAGIC;
 
-	rc = nvs_write(&g_state.fs, PERSIST_CURVE_SECRET_ID, &record, sizeof(record));
+	rc = persist_write_record(PERSIST_CURVE_SECRET_ID, &record, sizeof(record));
 	if (rc < 0) {
 		LOG_ERR("Failed to persist Curve25519 scalar: %d", rc);
 		k_mutex_unlock(&state_lock);
@@ -505,13 +1743,14 @@ int persist_state_curve25519_set_secret(const uint8_t secret[CURVE25519_KEY_SIZE
 
 	int rc = init_fs_if_needed();
 	if (rc == 0) {
-		rc = nvs_write(&g_state.fs, PERSIST_CURVE_SECRET_ID,
+		rc = persist_write_record(PERSIST_CURVE_SECRET_ID,
 			       &record, sizeof(record));
 		if (rc < 0) {
 			LOG_ERR("Failed to write Curve25519 scalar: %d", rc);
 		} else {
 			rc = 0;
 			LOG_INF("Curve25519 scalar updated via provisioning command");
+			event_log_append(EVENT_LOG_PROVISION_SECRET, 0U);
 		}
 	}
 
@@ -525,15 +1764,16 @@ int persist_state_curve25519_get_peer(uint8_t out[CURVE25519_KEY_SIZE])
 		return -EINVAL;
 	}
 
-	int rc = init_fs_if_needed();
-	if (rc != 0) {
+	k_mutex_lock(&state_lock, K_FOREVER);
+
+	int rc = persist_curve_ready_locked(PERSIST_CURVE_PEER_ID, out);
+	if (rc <= 0) {
+		k_mutex_unlock(&state_lock);
 		return rc;
 	}
 
-	k_mutex_lock(&state_lock, K_FOREVER);
-
 	struct persist_curve_peer record = {0};
-	rc = nvs_read(&g_state.fs, PERSIST_CURVE_PEER_ID, &record, sizeof(record));
+	rc = persist_backend_read(PERSIST_CURVE_PEER_ID, &record, sizeof(record));
 	if (rc == sizeof(record) && record.magic == PERSIST_CURVE_PEER_MAGIC) {
 		memcpy(out, record.peer, CURVE25519_KEY_SIZE);
 		k_mutex_unlock(&state_lock);
@@ -559,13 +1799,14 @@ int persist_state_curve25519_set_peer(const uint8_t peer[CURVE25519_KEY_SIZE])
 
 	int rc = init_fs_if_needed();
 	if (rc == 0) {
-		rc = nvs_write(&g_state.fs, PERSIST_CURVE_PEER_ID,
+		rc = persist_write_record(PERSIST_CURVE_PEER_ID,
 			       &record, sizeof(record));
 		if (rc < 0) {
 			LOG_ERR("Failed to write Curve25519 peer key: %d", rc);
 		} else {
 			rc = 0;
 			LOG_INF("Curve25519 peer public key updated via provisioning command");
+			event_log_append(EVENT_LOG_PROVISION_PEER, 0U);
 		}
 	}
 
@@ -642,26 +1883,95 @@ void persist_state_test_copy_plain(struct persist_blob *dst,
 	safe_memcpy(dst, sizeof(*dst), src, sizeof(*src));
 }
 
+void persist_state_test_write_legacy_blob(const struct persist_blob *blob)
+{
+	k_mutex_lock(&state_lock, K_FOREVER);
+
+	if (init_fs_if_needed() == 0) {
+		(void)persist_backend_delete(PERSIST_SCHEMA_ID);
+		for (uint8_t tag = 0U; tag < PERSIST_FIELD_COUNT; tag++) {
+			(void)persist_backend_delete(PERSIST_FIELD_ID(tag));
+		}
+		(void)persist_backend_write(PERSIST_RECORD_ID, blob, sizeof(*blob));
+	}
+
+	k_mutex_unlock(&state_lock);
+}
+
 void persist_state_test_reset(void)
 {
 	k_mutex_lock(&state_lock, K_FOREVER);
 
 	if (init_fs_if_needed() == 0) {
-		(void)nvs_clear(&g_state.fs);
+		(void)persist_backend_clear();
 	}
 
-	safe_memset(&g_state.fs, sizeof(g_state.fs), 0, sizeof(g_state.fs));
+	persist_backend_forget();
 	safe_memset(&g_state.blob, sizeof(g_state.blob), 0, sizeof(g_state.blob));
+	safe_memset(&g_state.task_faults, sizeof(g_state.task_faults), 0,
+		    sizeof(g_state.task_faults));
+	safe_memset(&g_state.escalation, sizeof(g_state.escalation), 0,
+		    sizeof(g_state.escalation));
+	g_state.session_next = 0U;
+	g_state.dirty_fields = 0U;
+	g_state.mounted = false;
 	g_state.loaded = false;
+	persist_publish_locked();
+#if IS_ENABLED(CONFIG_APP_PERSIST_WARM_CACHE)
+	persist_warm_test_forget();
+#endif
+	atomic_set(&feed_uptime_ms, 0);
+	atomic_set(&feed_timeout_ms, 0);
+#if IS_ENABLED(CONFIG_APP_PERSIST_WEAR_TELEMETRY)
+	safe_memset(&g_wear, sizeof(g_wear), 0, sizeof(g_wear));
+#endif
+#if IS_ENABLED(CONFIG_APP_PERSIST_GC_SCHEDULING)
+	gc_deferred = false;
+#endif
+#if IS_ENABLED(CONFIG_APP_PERSIST_WRITE_BEHIND)
+	flush_error = 0;
+#endif
+	safe_memset(&g_stats, sizeof(g_stats), 0, sizeof(g_stats));
+	g_stats.gc_min_margin_ms = INT32_MAX;
+	test_write_error = 0;
+	test_mount_error = 0;
+	k_mutex_unlock(&state_lock);
+}
+
+void persist_state_test_fail_writes(int err)
+{
+	k_mutex_lock(&state_lock, K_FOREVER);
+	test_write_error = err;
+	k_mutex_unlock(&state_lock);
+}
+
+void persist_state_test_fail_mount(int err)
+{
+	k_mutex_lock(&state_lock, K_FOREVER);
+	test_mount_error = err;
 	k_mutex_unlock(&state_lock);
 }
 
 void persist_state_test_reload(void)
 {
 	k_mutex_lock(&state_lock, K_FOREVER);
-	safe_memset(&g_state.fs, sizeof(g_state.fs), 0, sizeof(g_state.fs));
+	persist_backend_forget();
 	safe_memset(&g_state.blob, sizeof(g_state.blob), 0, sizeof(g_state.blob));
+	safe_memset(&g_state.task_faults, sizeof(g_state.task_faults), 0,
+		    sizeof(g_state.task_faults));
+	safe_memset(&g_state.escalation, sizeof(g_state.escalation), 0,
+		    sizeof(g_state.escalation));
+	g_state.session_next = 0U;
+	g_state.dirty_fields = 0U;
+	g_state.mounted = false;
 	g_state.loaded = false;
+#if IS_ENABLED(CONFIG_APP_PERSIST_WARM_CACHE)
+	/* A reload is a warm boot: retained RAM survives, the consumed flag
+	 * does not.
+	 */
+	warm_checked = false;
+#endif
+	persist_publish_locked();
 	k_mutex_unlock(&state_lock);
 }
 #endif
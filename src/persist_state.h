@@ -6,7 +6,57 @@
 
 #include "curve25519_ref10.h"
 
+/* Flash write accounting for the reset-counter/override blob. */
+struct persist_state_stats {
+	uint32_t updates;        /* logical changes requested by callers */
+	uint32_t writes;         /* commits that reached NVS */
+	uint32_t bytes_written;  /* record payload bytes handed to nvs_write */
+	uint32_t write_failures;
+	uint32_t last_write_us;
+	uint32_t max_write_us;
+	uint32_t total_write_us;
+	uint32_t gc_cycles;       /* write-sector roll-overs (one erase each) */
+	uint32_t gc_deferred;     /* commits postponed to the next feed window */
+	int32_t gc_min_margin_ms; /* smallest feed-to-deadline margin after a GC */
+};
+
+/* Lifetime flash usage of the storage partition; see docs/persist_state.md. */
+struct persist_state_wear {
+	uint32_t lifetime_writes;   /* record writes that reached flash */
+	uint32_t lifetime_bytes;
+	uint32_t lifetime_erases;   /* sector erases (one per GC) */
+	uint32_t lifetime_uptime_s; /* uptime covered by the counters above */
+	uint32_t sector_size;
+	uint32_t sector_count;
+	int32_t free_bytes;         /* backend free space, or negative errno */
+	int32_t projected_days;     /* days until the erase budget is spent; -1 unknown */
+};
+
 int persist_state_init(void);
+int persist_state_flush(void);
+/* Flush, then (CONFIG_APP_PERSIST_WARM_CACHE) hand the cache to the next boot. */
+int persist_state_prepare_warm_reboot(void);
+void persist_state_get_stats(struct persist_state_stats *out);
+int persist_state_get_wear(struct persist_state_wear *out);
+void persist_state_log_wear(void);
+/* Supervisor heartbeat fault counters, one per registry slot. note returns
+ * the new count or a negative errno.
+ */
+int persist_state_note_task_fault(uint8_t slot);
+uint32_t persist_state_get_task_faults(uint8_t slot);
+/* Open recovery incident (see recovery.h); stage 0 means none. Cached and
+ * committed like the fields; the reboot rungs flush it before rebooting.
+ */
+struct persist_state_escalation {
+	uint8_t stage;
+	uint32_t task_mask;  /* heartbeat slots that were stale */
+	uint32_t elapsed_ms; /* incident time spent before the last reboot */
+};
+
+int persist_state_set_escalation(const struct persist_state_escalation *in);
+void persist_state_get_escalation(struct persist_state_escalation *out);
+/* Called by the supervisor after each successful watchdog feed. */
+void persist_state_watchdog_fed(uint32_t timeout_ms);
 void persist_state_record_boot(bool watchdog_reset);
 void persist_state_clear_watchdog_counter(void);
 
@@ -21,11 +71,18 @@ int persist_state_curve25519_get_secret(uint8_t out[CURVE25519_KEY_SIZE]);
 int persist_state_curve25519_set_secret(const uint8_t secret[CURVE25519_KEY_SIZE]);
 int persist_state_curve25519_get_peer(uint8_t out[CURVE25519_KEY_SIZE]);
 int persist_state_curve25519_set_peer(const uint8_t peer[CURVE25519_KEY_SIZE]);
+/* Next session counter, or 0 if the lease holding it could not be
+ * persisted. 0 is never issued otherwise.
+ */
 uint32_t persist_state_next_session_counter(void);
 
 #if defined(CONFIG_ZTEST)
 void persist_state_test_reset(void);
 void persist_state_test_reload(void);
+/* Every record write fails with err until called again with 0. */
+void persist_state_test_fail_writes(int err);
+/* Every backend mount fails with err until called again with 0. */
+void persist_state_test_fail_mount(int err);
 #endif
 
 #endif /* PERSIST_STATE_H */
@@ -15,6 +15,17 @@ struct persist_blob {
 	uint32_t session_counter;
 };
 
+/* Schema v1 stores each blob field in its own NVS record so a counter bump
+ * only rewrites that field. tag/version let a mount reject stale layouts.
+ * Stored plain: they are read before any session key exists.
+ */
+struct persist_field {
+	uint8_t tag;
+	uint8_t version;
+	uint16_t reserved;
+	uint32_t value;
+};
+
 #if IS_ENABLED(CONFIG_APP_USE_AES_ENCRYPTION)
 struct persist_blob_encrypted {
 	uint8_t iv[APP_CRYPTO_IV_LEN];
@@ -21,6 +21,10 @@ int persist_state_test_decrypt_blob(const struct persist_blob_encrypted *storage
 
 void persist_state_test_copy_plain(struct persist_blob *dst,
 				   const struct persist_blob *src);
+/* Replaces the field records with a plain legacy blob so the next reload
+ * exercises the one-time migration.
+ */
+void persist_state_test_write_legacy_blob(const struct persist_blob *blob);
 #endif /* CONFIG_ZTEST */
 
 #endif /* PERSIST_STATE_TEST_H */
@@ -0,0 +1,308 @@
+#include <errno.h>
+#include <string.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/sys/crc.h>
+#include <zephyr/sys/util.h>
+
+#if defined(CONFIG_CPU_CORTEX_M)
+#include <cmsis_core.h>
+#endif
+
+#include "event_log.h"
+#include "log_utils.h"
+#include "prewatchdog.h"
+#include "safe_memory.h"
+#include "supervisor.h"
+#include "watchdog_ctrl.h"
+
+LOG_MODULE_REGISTER(prewatchdog, LOG_LEVEL_INF);
+
+BUILD_ASSERT(CONFIG_APP_PREWATCHDOG_PERCENT > CONFIG_APP_WATCHDOG_FEED_PERCENT,
+	     "pre-watchdog must fire after a missed feed, not before a due one");
+
+#define PREWATCHDOG_MAGIC 0x50524557u /* 'PREW' */
+#define PREWATCHDOG_NAME_LEN 8U
+#define PREWATCHDOG_NO_THREAD 0xFFU
+
+struct prewatchdog_thread {
+	char name[PREWATCHDOG_NAME_LEN];
+	uint32_t sp;
+	uint32_t cycles; /* runtime since the previous quiet check */
+	uint8_t state;
+	int8_t prio;
+	uint8_t reserved[2];
+};
+
+struct prewatchdog_record {
+	uint32_t magic;
+	uint32_t uptime_ms;
+	uint32_t timeout_ms;
+	uint32_t feed_age_ms;
+	uint32_t hb_age_ms[CONFIG_APP_SUPERVISOR_MAX_TASKS];
+	uint8_t thread_count;
+	uint8_t current; /* thread the timer interrupted */
+	uint8_t recovered; /* a feed arrived after the snapshot */
+	uint8_t reserved;
+	struct prewatchdog_thread threads[CONFIG_APP_PREWATCHDOG_MAX_THREADS];
+	uint32_t crc;
+};
+
+/* Survives warm and IWDG resets; validated by magic and CRC. */
+static __noinit struct prewatchdog_record last_snapshot;
+/* Orders record updates from the timer and the walk work item. */
+static struct k_spinlock snapshot_lock;
+
+static void prewatchdog_check(struct k_timer *timer);
+static K_TIMER_DEFINE(prewatchdog_timer, prewatchdog_check, NULL);
+static void walk_work_handler(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(walk_work, walk_work_handler);
+static atomic_t last_feed_ms = ATOMIC_INIT(0);
+static bool fired; /* timer context only */
+/* Set by the timer when it fires, before it submits walk_work. */
+static const struct k_thread *fired_thread;
+static uint32_t fired_window_ms;
+static bool walked;
+
+#if IS_ENABLED(CONFIG_THREAD_RUNTIME_STATS)
+/* Execution cycles per captured thread when the walk ran. */
+static struct {
+	const struct k_thread *thread;
+	uint32_t cycles;
+} baseline[CONFIG_APP_PREWATCHDOG_MAX_THREADS];
+
+static uint32_t thread_cycles(const struct k_thread *thread)
+{
+	k_thread_runtime_stats_t stats;
+
+	if (k_thread_runtime_stats_get((k_tid_t)thread, &stats) != 0) {
+		return 0U;
+	}
+	return (uint32_t)stats.execution_cycles;
+}
+
+static void cycles_cb(const struct k_thread *thread, void *user_data)
+{
+	struct prewatchdog_record *rec = user_data;
+
+	for (uint8_t i = 0U; i < rec->thread_count; i++) {
+		if (baseline[i].thread == thread) {
+			rec->threads[i].cycles = thread_cycles(thread) - baseline[i].cycles;
+			return;
+		}
+	}
+}
+#endif
+
+static uint32_t prewatchdog_crc(const struct prewatchdog_record *rec)
+{
+	return crc32_ieee((const uint8_t *)rec, offsetof(struct prewatchdog_record, crc));
+}
+
+static void capture_thread(struct prewatchdog_record *rec, const struct k_thread *thread,
+			   uint32_t sp)
+{
+	struct prewatchdog_thread *out = &rec->threads[rec->thread_count];
+	const char *name = k_thread_name_get((k_tid_t)thread);
+
+	(void)strncpy(out->name, (name != NULL) ? name : "?", sizeof(out->name));
+	out->state = thread->base.thread_state;
+	out->prio = thread->base.prio;
+	out->sp = sp;
+	out->cycles = 0U;
+#if IS_ENABLED(CONFIG_THREAD_RUNTIME_STATS)
+	baseline[rec->thread_count].thread = thread;
+	baseline[rec->thread_count].cycles = thread_cycles(thread);
+#endif
+	rec->thread_count++;
+}
+
+static void snapshot_cb(const struct k_thread *thread, void *user_data)
+{
+	struct prewatchdog_record *rec = user_data;
+
+	/* The timer already captured the interrupted thread with its live SP. */
+	if (rec->thread_count >= ARRAY_SIZE(rec->threads) || thread == fired_thread) {
+		return;
+	}
+
+#if defined(CONFIG_CPU_CORTEX_M)
+	capture_thread(rec, thread, thread->callee_saved.psp);
+#else
+	capture_thread(rec, thread, 0U);
+#endif
+}
+
+/* Timer context. Only what the next boot cannot do without: the header,
+ * the interrupted thread and the heartbeat ages. The walk over every
+ * thread is left to walk_work.
+ */
+static void take_snapshot(uint32_t now, uint32_t timeout_ms, uint32_t feed_age_ms)
+{
+	struct prewatchdog_record *rec = &last_snapshot;
+	k_spinlock_key_t key = k_spin_lock(&snapshot_lock);
+
+	safe_memset(rec, sizeof(*rec), 0, sizeof(*rec));
+	rec->magic = PREWATCHDOG_MAGIC;
+	rec->uptime_ms = now;
+	rec->timeout_ms = timeout_ms;
+	rec->feed_age_ms = feed_age_ms;
+	rec->current = PREWATCHDOG_NO_THREAD;
+	for (int slot = 0; slot < CONFIG_APP_SUPERVISOR_MAX_TASKS; slot++) {
+		rec->hb_age_ms[slot] = supervisor_task_age_ms(slot);
+	}
+
+	fired_thread = k_current_get();
+	rec->current = 0U;
+#if defined(CONFIG_CPU_CORTEX_M)
+	/* The interrupted thread's context is not saved yet: use the live PSP. */
+	capture_thread(rec, fired_thread, __get_PSP());
+#else
+	capture_thread(rec, fired_thread, 0U);
+#endif
+	rec->crc = prewatchdog_crc(rec);
+	k_spin_unlock(&snapshot_lock, key);
+}
+
+/* First run: add every other thread to the snapshot. With runtime stats, a
+ * second run halfway to the IWDG records what each thread ran since then.
+ */
+static void walk_work_handler(struct k_work *work)
+{
+	struct prewatchdog_record *rec = &last_snapshot;
+	k_spinlock_key_t key = k_spin_lock(&snapshot_lock);
+
+#if IS_ENABLED(CONFIG_THREAD_RUNTIME_STATS)
+	k_thread_foreach(walked ? cycles_cb : snapshot_cb, rec);
+#else
+	k_thread_foreach(snapshot_cb, rec);
+#endif
+	rec->crc = prewatchdog_crc(rec);
+	k_spin_unlock(&snapshot_lock, key);
+
+	if (!walked) {
+		walked = true;
+		LOG_EVT(WRN, "WATCHDOG", "PREEMPT_WALK", "threads=%u", rec->thread_count);
+#if IS_ENABLED(CONFIG_THREAD_RUNTIME_STATS)
+		(void)k_work_reschedule(k_work_delayable_from_work(work), K_MSEC(fired_window_ms));
+#else
+		ARG_UNUSED(work);
+#endif
+	}
+}
+
+static void prewatchdog_check(struct k_timer *timer)
+{
+	uint32_t now = k_uptime_get_32();
+	uint32_t timeout_ms = watchdog_ctrl_get_timeout();
+	uint32_t threshold_ms = MAX((timeout_ms * CONFIG_APP_PREWATCHDOG_PERCENT) / 100U, 1U);
+	uint32_t feed_age_ms = now - (uint32_t)atomic_get(&last_feed_ms);
+
+	if (feed_age_ms < threshold_ms) {
+		/* Fed in time: sleep until this feed would cross the threshold. */
+		if (fired) {
+			k_spinlock_key_t key = k_spin_lock(&snapshot_lock);
+
+			fired = false;
+			last_snapshot.recovered = 1U;
+			last_snapshot.crc = prewatchdog_crc(&last_snapshot);
+			k_spin_unlock(&snapshot_lock, key);
+			LOG_EVT(WRN, "WATCHDOG", "PREEMPT_CLEARED", "feed_age_ms=%u", feed_age_ms);
+		}
+		k_timer_start(timer, K_MSEC(threshold_ms - feed_age_ms), K_NO_WAIT);
+		return;
+	}
+
+	if (!fired) {
+		fired = true;
+		take_snapshot(now, timeout_ms, feed_age_ms);
+
+		const struct prewatchdog_record *rec = &last_snapshot;
+		const char *name = (rec->current != PREWATCHDOG_NO_THREAD) ?
+				   rec->threads[rec->current].name : "isr";
+
+		/* Immediate-mode logging prints this before the IWDG fires. */
+		LOG_EVT(ERR, "WATCHDOG", "PREEMPT", "thread=%.8s,feed_age_ms=%u,timeout_ms=%u",
+			name, feed_age_ms, timeout_ms);
+		event_log_append(EVENT_LOG_WATCHDOG_PREEMPT, feed_age_ms);
+
+		/* Runs once the hog lets the system workqueue in, if it does. */
+		walked = false;
+		fired_window_ms = MAX((timeout_ms - MIN(feed_age_ms, timeout_ms)) / 2U, 1U);
+		(void)k_work_reschedule(&walk_work, K_NO_WAIT);
+	}
+
+	/* Keep watching so a late feed marks the snapshot as recovered. */
+	k_timer_start(timer, K_MSEC(threshold_ms), K_NO_WAIT);
+}
+
+void prewatchdog_start(void)
+{
+	prewatchdog_feed();
+	(void)k_work_cancel_delayable(&walk_work);
+	fired = false;
+	k_timer_start(&prewatchdog_timer, K_NO_WAIT, K_NO_WAIT);
+}
+
+void prewatchdog_feed(void)
+{
+	atomic_set(&last_feed_ms, (atomic_val_t)k_uptime_get_32());
+}
+
+void prewatchdog_report_last_boot(bool watchdog_reset)
+{
+	struct prewatchdog_record *rec = &last_snapshot;
+
+	if (rec->magic != PREWATCHDOG_MAGIC || rec->crc != prewatchdog_crc(rec)) {
+		return;
+	}
+
+	const char *name = (rec->current < rec->thread_count) ?
+			   rec->threads[rec->current].name : "isr";
+
+	LOG_EVT(WRN, "WATCHDOG", "PREEMPT_LAST",
+		"reset=%s,recovered=%u,thread=%.8s,feed_age_ms=%u,timeout_ms=%u,uptime_ms=%u",
+		watchdog_reset ? "watchdog" : "other", rec->recovered, name, rec->feed_age_ms,
+		rec->timeout_ms, rec->uptime_ms);
+
+	for (uint8_t i = 0U; i < MIN(rec->thread_count, ARRAY_SIZE(rec->threads)); i++) {
+		const struct prewatchdog_thread *t = &rec->threads[i];
+
+		LOG_EVT(WRN, "WATCHDOG", "PREEMPT_THREAD",
+			"name=%.8s,state=0x%02x,prio=%d,sp=0x%08x,cycles=%u,current=%u", t->name,
+			t->state, t->prio, t->sp, t->cycles, (i == rec->current) ? 1U : 0U);
+	}
+
+	for (int slot = 0; slot < CONFIG_APP_SUPERVISOR_MAX_TASKS; slot++) {
+		if (rec->hb_age_ms[slot] != UINT32_MAX) {
+			LOG_EVT(WRN, "WATCHDOG", "PREEMPT_HEARTBEAT", "slot=%d,age_ms=%u", slot,
+				rec->hb_age_ms[slot]);
+		}
+	}
+
+	/* Report once. */
+	rec->magic = 0U;
+}
+
+#if defined(CONFIG_ZTEST)
+int prewatchdog_test_last(struct prewatchdog_test_snapshot *out)
+{
+	const struct prewatchdog_record *rec = &last_snapshot;
+
+	if (rec->magic != PREWATCHDOG_MAGIC || rec->crc != prewatchdog_crc(rec)) {
+		return -ENOENT;
+	}
+
+	safe_memset(out, sizeof(*out), 0, sizeof(*out));
+	if (rec->current < rec->thread_count) {
+		safe_memcpy(out->thread, sizeof(out->thread) - 1U,
+			    rec->threads[rec->current].name, PREWATCHDOG_NAME_LEN);
+	}
+	out->feed_age_ms = rec->feed_age_ms;
+	out->thread_count = rec->thread_count;
+	out->recovered = rec->recovered != 0U;
+	return 0;
+}
+#endif
@@ -0,0 +1,50 @@
+#ifndef PREWATCHDOG_H
+#define PREWATCHDOG_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <zephyr/sys/util.h>
+
+/* Software pre-watchdog (CONFIG_APP_PREWATCHDOG). A k_timer checks the age
+ * of the last IWDG feed; once it passes CONFIG_APP_PREWATCHDOG_PERCENT of
+ * the armed timeout it snapshots every thread into .noinit RAM so the next
+ * boot can name the thread that starved the supervisor.
+ */
+#if IS_ENABLED(CONFIG_APP_PREWATCHDOG)
+/* Called by watchdog_ctrl_init(); starts the check timer. */
+void prewatchdog_start(void);
+/* Called on every successful feed or counter reload. Only stores a
+ * timestamp; the timer re-arms itself from it.
+ */
+void prewatchdog_feed(void);
+/* Logs and consumes the snapshot left by the previous boot, if any. */
+void prewatchdog_report_last_boot(bool watchdog_reset);
+
+#if defined(CONFIG_ZTEST)
+struct prewatchdog_test_snapshot {
+	char thread[9];
+	uint32_t feed_age_ms;
+	uint8_t thread_count;
+	bool recovered;
+};
+
+/* Copies the current snapshot without consuming it; -ENOENT if none. */
+int prewatchdog_test_last(struct prewatchdog_test_snapshot *out);
+#endif
+#else
+static inline void prewatchdog_start(void)
+{
+}
+
+static inline void prewatchdog_feed(void)
+{
+}
+
+static inline void prewatchdog_report_last_boot(bool watchdog_reset)
+{
+	ARG_UNUSED(watchdog_reset);
+}
+#endif
+
+#endif /* PREWATCHDOG_H */
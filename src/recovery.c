@@ -1,11 +1,16 @@
 #include <zephyr/kernel.h>
 #include <zephyr/logging/log.h>
+#include <zephyr/logging/log_ctrl.h>
 #include <zephyr/sys/reboot.h>
 #include <zephyr/sys/util.h>
 #include <zephyr/sys/atomic.h>
+#include <errno.h>
 #include <limits.h>
 
+#include "event_log.h"
+#include "log_tx.h"
 #include "log_utils.h"
+#include "persist_state.h"
 #include "recovery.h"
 #if defined(CONFIG_ZTEST)
 #include "recovery_test.h"
@@ -13,7 +18,13 @@
 
 LOG_MODULE_REGISTER(recovery, LOG_LEVEL_INF);
 
-/* Event used to signal recovery actions */
+/* Event used to signal recovery actions: one bit per reason, then the
+ * supervisor's task fault / healthy reports for the escalation ladder.
+ */
+#define RECOVERY_EVT_TASK_FAULT BIT(RECOVERY_REASON_COUNT)
+#define RECOVERY_EVT_HEALTHY BIT(RECOVERY_REASON_COUNT + 1)
+#define RECOVERY_EVT_ALL BIT_MASK(RECOVERY_REASON_COUNT + 2)
+
 static struct k_event recovery_event;
 #if defined(CONFIG_ZTEST)
 static atomic_t recovery_test_events = ATOMIC_INIT(0);
@@ -27,6 +38,101 @@ static const int64_t SAFE_MODE_DEADLINE_INACTIVE = INT64_MIN;
 static int64_t safe_mode_deadline = SAFE_MODE_DEADLINE_INACTIVE;
 static uint32_t safe_mode_delay_ms;
 
+#if IS_ENABLED(CONFIG_APP_RECOVERY_ESCALATION)
+#define ESCALATION_NO_DEADLINE INT64_MAX
+
+struct recovery_actions {
+	recovery_action_fn restart;
+	recovery_action_fn reinit;
+};
+
+/* Open incident; owned by the recovery thread. */
+struct escalation {
+	enum recovery_stage stage; /* last rung run, NONE when closed */
+	uint32_t task_mask;
+	int64_t start_ts;          /* incident start on this boot's clock */
+	uint32_t carried_ms;       /* incident time before the last reboot */
+	int64_t deadline;          /* rung timeout or end of the stable window */
+	bool verifying;            /* waiting for the heartbeats to return */
+};
+
+static const char *const stage_names[RECOVERY_STAGE_COUNT] = {
+	"none", "restart", "reinit", "warm_reboot", "cold_reboot",
+};
+
+static struct recovery_actions actions[CONFIG_APP_SUPERVISOR_MAX_TASKS];
+static struct escalation esc = { .deadline = ESCALATION_NO_DEADLINE };
+static struct recovery_stage_stats stage_stats[RECOVERY_STAGE_COUNT];
+static atomic_t fault_mask = ATOMIC_INIT(0);
+/* Uptime (ms) until which the supervisor keeps feeding; 0 = no hold. */
+static atomic_t hold_until_ms = ATOMIC_INIT(0);
+#endif
+
+/* Pre-reboot chain: reason record, registered hooks, persist_state commit
+ * last so it covers anything the hooks changed.
+ */
+#define REBOOT_CHAIN_MAX (2U + CONFIG_APP_RECOVERY_REBOOT_HOOKS)
+
+static const struct recovery_reboot_hook *extra_hooks[CONFIG_APP_RECOVERY_REBOOT_HOOKS];
+static atomic_t extra_hook_count = ATOMIC_INIT(0);
+#if defined(CONFIG_ZTEST)
+static void (*reboot_hook)(int type);
+static struct recovery_reboot_prep last_prep;
+#endif
+
+/* Flash commits, driver re-init and the pre-reboot hooks need far more stack
+ * than deciding what to do next, so they run on the system workqueue, whose
+ * stack is already sized for NVS writes (docs/memory_budget.md). The
+ * recovery thread only waits, which keeps its own stack small.
+ */
+struct recovery_job {
+	struct k_work work;
+	struct k_sem done;
+	int (*fn)(void *arg);
+	void *arg;
+	int rc;
+};
+
+static struct recovery_job job;
+
+static void recovery_job_handler(struct k_work *work)
+{
+	struct recovery_job *j = CONTAINER_OF(work, struct recovery_job, work);
+
+	j->rc = j->fn(j->arg);
+	k_sem_give(&j->done);
+}
+
+static bool job_busy(void)
+{
+	return k_work_busy_get(&job.work) != 0;
+}
+
+/* Run fn on the system workqueue and wait for it until deadline (uptime
+ * ms). A job that is still queued or running from an earlier timeout
+ * blocks the next one with -EBUSY instead of being overwritten.
+ */
+static int run_on_workq(int (*fn)(void *arg), void *arg, int64_t deadline)
+{
+	if (job_busy()) {
+		return -EBUSY;
+	}
+
+	job.fn = fn;
+	job.arg = arg;
+	k_sem_reset(&job.done);
+
+	int rc = k_work_submit(&job.work);
+
+	if (rc < 0) {
+		return rc;
+	}
+	if (k_sem_take(&job.done, K_TIMEOUT_ABS_MS(deadline)) != 0) {
+		return -ETIMEDOUT;
+	}
+	return job.rc;
+}
+
 static const char *recovery_reason_to_str(enum recovery_reason reason)
 {
 	switch (reason) {
@@ -58,69 +164,428 @@ void recovery_request(enum recovery_reason reason)
 #endif
 }
 
+static int record_reason_step(enum recovery_reason reason, int reboot_type, uint32_t call)
+{
+	ARG_UNUSED(reboot_type);
+	ARG_UNUSED(call);
+	event_log_append(EVENT_LOG_RECOVERY_REBOOT, (uint32_t)reason);
+	event_log_flush();
+	return 0;
+}
+
+/* STM32 resets the same way for both types; a cold reboot also skips the
+ * warm-boot cache so the next boot reloads everything from flash.
+ */
+static int persist_step(enum recovery_reason reason, int reboot_type, uint32_t call)
+{
+	ARG_UNUSED(reason);
+	ARG_UNUSED(call);
+	return (reboot_type == SYS_REBOOT_COLD) ? persist_state_flush() :
+						  persist_state_prepare_warm_reboot();
+}
+
+static const struct recovery_reboot_hook reason_hook = { "reason", record_reason_step };
+static const struct recovery_reboot_hook persist_hook = { "persist", persist_step };
+
+static void reboot_now(int type)
+{
+#if defined(CONFIG_ZTEST)
+	if (reboot_hook != NULL) {
+		reboot_hook(type);
+		return;
+	}
+#endif
+	sys_reboot(type);
+}
+
+struct reboot_step_args {
+	const struct recovery_reboot_hook *hook;
+	enum recovery_reason reason;
+	int reboot_type;
+	uint32_t call;
+};
+
+static int reboot_step_job(void *arg)
+{
+	const struct reboot_step_args *a = arg;
+
+	return a->hook->step(a->reason, a->reboot_type, a->call);
+}
+
+/* Step one hook until it finishes. A hook reached after the deadline still
+ * gets its first call, with one more deadline window to finish it, so
+ * synchronous work is not skipped but a wedged workqueue cannot stop the
+ * reboot.
+ */
+static int run_reboot_hook(const struct recovery_reboot_hook *hook, enum recovery_reason reason,
+			   int reboot_type, int64_t deadline)
+{
+	/* Static: an abandoned call may still read it from the workqueue. */
+	static struct reboot_step_args args;
+
+	if (job_busy()) {
+		return -EBUSY;
+	}
+	args = (struct reboot_step_args){
+		.hook = hook,
+		.reason = reason,
+		.reboot_type = reboot_type,
+	};
+
+	for (uint32_t call = 0U;; call++) {
+		int64_t wait_until = deadline;
+
+		if (call == 0U) {
+			wait_until = MAX(deadline,
+					 k_uptime_get() + CONFIG_APP_RECOVERY_REBOOT_DEADLINE_MS);
+		}
+		args.call = call;
+
+		int rc = run_on_workq(reboot_step_job, &args, wait_until);
+
+		if (rc != -EINPROGRESS) {
+			return rc;
+		}
+		if (k_uptime_get() >= deadline) {
+			return -ETIMEDOUT;
+		}
+		k_msleep(1);
+	}
+}
+
+/* Immediate mode has already formatted everything; with CONFIG_APP_LOG_TX
+ * the bytes may still be waiting in its ring.
+ */
+static void drain_log_output(int64_t deadline)
+{
+#if defined(CONFIG_LOG) && !defined(CONFIG_LOG_MODE_IMMEDIATE)
+	while (log_data_pending() && k_uptime_get() < deadline) {
+		k_msleep(1);
+	}
+#endif
+	while (log_tx_pending() && k_uptime_get() < deadline) {
+		k_msleep(1);
+	}
+}
+
+/* Run the pre-reboot chain, report how long it took, drain the log and
+ * reboot. Reboots as soon as every hook is done, and never later than
+ * CONFIG_APP_RECOVERY_REBOOT_DEADLINE_MS after the start.
+ */
+static void reboot_after_hooks(enum recovery_reason reason, int reboot_type)
+{
+	int64_t start = k_uptime_get();
+	int64_t deadline = start + CONFIG_APP_RECOVERY_REBOOT_DEADLINE_MS;
+	const struct recovery_reboot_hook *chain[REBOOT_CHAIN_MAX];
+	uint32_t extra = MIN((uint32_t)atomic_get(&extra_hook_count), ARRAY_SIZE(extra_hooks));
+	uint32_t count = 0U;
+	uint32_t late = 0U;
+	uint32_t failed = 0U;
+
+	chain[count++] = &reason_hook;
+	for (uint32_t i = 0U; i < extra; i++) {
+		if (extra_hooks[i] != NULL) {
+			chain[count++] = extra_hooks[i];
+		}
+	}
+	chain[count++] = &persist_hook;
+
+	for (uint32_t i = 0U; i < count; i++) {
+		int rc = run_reboot_hook(chain[i], reason, reboot_type, deadline);
+
+		if (rc == -ETIMEDOUT) {
+			late |= BIT(i);
+		} else if (rc < 0) {
+			failed |= BIT(i);
+		}
+		if (rc < 0) {
+			LOG_EVT(WRN, "RECOVERY", "REBOOT_HOOK_FAIL", "hook=%s,rc=%d",
+				chain[i]->name, rc);
+		}
+	}
+
+	uint32_t hooks_ms = (uint32_t)(k_uptime_get() - start);
+
+	LOG_EVT(WRN, "RECOVERY", "REBOOT_PREP", "reason=%d,type=%s,ms=%u,hooks=%u,late=0x%x,failed=0x%x",
+		reason, (reboot_type == SYS_REBOOT_COLD) ? "cold" : "warm", hooks_ms, count, late,
+		failed);
+
+	int64_t drain_start = k_uptime_get();
+
+	drain_log_output(deadline);
+#if defined(CONFIG_ZTEST)
+	last_prep = (struct recovery_reboot_prep){
+		.hooks_ms = hooks_ms,
+		.drain_ms = (uint32_t)(k_uptime_get() - drain_start),
+		.late_mask = late,
+		.failed_mask = failed,
+	};
+#else
+	ARG_UNUSED(drain_start);
+#endif
+	reboot_now(reboot_type);
+}
+
 static void handle_safe_mode_reboot(void)
 {
 	LOG_EVT_SIMPLE(WRN, "RECOVERY", "SAFE_MODE_TIMEOUT");
 	LOG_EVT(WRN, "RECOVERY", "SAFE_MODE_REBOOT",
 		"delay_ms=%u", safe_mode_delay_ms);
-	sys_reboot(SYS_REBOOT_WARM);
+	reboot_after_hooks(RECOVERY_REASON_SAFE_MODE_TIMEOUT, SYS_REBOOT_WARM);
+}
+
+#if IS_ENABLED(CONFIG_APP_RECOVERY_ESCALATION)
+static uint32_t incident_ms(int64_t now)
+{
+	return esc.carried_ms + (uint32_t)(now - esc.start_ts);
+}
+
+static int save_escalation_job(void *arg)
+{
+	return persist_state_set_escalation(arg);
+}
+
+static void save_escalation(int64_t now)
+{
+	/* Static: an abandoned commit may still read it from the workqueue. */
+	static struct persist_state_escalation rec;
+
+	if (job_busy()) {
+		LOG_EVT(WRN, "RECOVERY", "SAVE_SKIPPED", "stage=%s,rc=%d",
+			stage_names[esc.stage], -EBUSY);
+		return;
+	}
+	rec = (struct persist_state_escalation){
+		.stage = (uint8_t)esc.stage,
+		.task_mask = esc.task_mask,
+		.elapsed_ms = (esc.stage == RECOVERY_STAGE_NONE) ? 0U : incident_ms(now),
+	};
+
+	(void)run_on_workq(save_escalation_job, &rec,
+			   k_uptime_get() + CONFIG_APP_RECOVERY_REBOOT_DEADLINE_MS);
+}
+
+static void hold_watchdog_until(int64_t deadline)
+{
+	atomic_set(&hold_until_ms, (atomic_val_t)MAX((uint32_t)deadline, 1U));
+}
+
+/* Runs the rung's action for every stale slot. Returns how many ran, or a
+ * negative errno if one failed.
+ */
+static int run_actions(enum recovery_stage stage)
+{
+	uint32_t mask = esc.task_mask;
+	recovery_action_fn last = NULL;
+	int ran = 0;
+
+	while (mask != 0U) {
+		uint32_t slot = find_lsb_set(mask) - 1U;
+
+		mask &= mask - 1U;
+		if (slot >= ARRAY_SIZE(actions)) {
+			break;
+		}
+
+		recovery_action_fn fn = (stage == RECOVERY_STAGE_RESTART) ?
+					actions[slot].restart : actions[slot].reinit;
+
+		/* Slots registered together share one action; run it once. */
+		if (fn == NULL || fn == last) {
+			continue;
+		}
+		last = fn;
+
+		int rc = fn();
+
+		if (rc < 0) {
+			LOG_EVT(WRN, "RECOVERY", "ACTION_FAIL", "stage=%s,task=%u,rc=%d",
+				stage_names[stage], slot, rc);
+			return rc;
+		}
+		ran++;
+	}
+
+	return ran;
 }
 
+static int run_actions_job(void *arg)
+{
+	return run_actions((enum recovery_stage)POINTER_TO_INT(arg));
+}
+
+/* Move the open incident (or a new one) to the next rung that applies. */
+static void escalate(int64_t now)
+{
+	if (esc.stage == RECOVERY_STAGE_NONE) {
+		esc.start_ts = now;
+		esc.carried_ms = 0U;
+	}
+
+	while (true) {
+		esc.stage = MIN(esc.stage + 1, RECOVERY_STAGE_COLD_REBOOT);
+		esc.verifying = true;
+		LOG_EVT(ERR, "RECOVERY", "ESCALATE", "stage=%s,tasks=0x%08x,elapsed_ms=%u",
+			stage_names[esc.stage], esc.task_mask, incident_ms(now));
+
+		if (esc.stage >= RECOVERY_STAGE_WARM_REBOOT) {
+			break;
+		}
+
+		/* Persist first: an action that wedges this thread ends in an IWDG
+		 * reset, and the next boot must know which rung that was.
+		 */
+		esc.deadline = now + CONFIG_APP_RECOVERY_STAGE_TIMEOUT_MS;
+		hold_watchdog_until(esc.deadline);
+		save_escalation(now);
+
+		/* A wedged action is abandoned at the rung's deadline. */
+		int rc = run_on_workq(run_actions_job, INT_TO_POINTER(esc.stage), esc.deadline);
+
+		if (rc > 0) {
+			stage_stats[esc.stage].attempts++;
+			return;
+		}
+		LOG_EVT(WRN, "RECOVERY", "STAGE_SKIPPED", "stage=%s,rc=%d",
+			stage_names[esc.stage], rc);
+	}
+
+	atomic_set(&hold_until_ms, 0);
+	esc.deadline = ESCALATION_NO_DEADLINE;
+	save_escalation(now);
+	reboot_after_hooks(RECOVERY_REASON_HEALTH_FAULT,
+			   (esc.stage == RECOVERY_STAGE_WARM_REBOOT) ? SYS_REBOOT_WARM :
+								       SYS_REBOOT_COLD);
+}
+
+static void handle_task_fault(int64_t now)
+{
+	uint32_t mask = (uint32_t)atomic_clear(&fault_mask);
+
+	esc.task_mask |= mask;
+	LOG_EVT(WRN, "RECOVERY", "TASK_FAULT", "tasks=0x%08x,stage=%s", mask,
+		stage_names[esc.stage]);
+
+	/* An in-place rung is still inside its window: its timeout decides. */
+	if (esc.verifying && esc.deadline != ESCALATION_NO_DEADLINE) {
+		return;
+	}
+	escalate(now);
+}
+
+static void handle_healthy(int64_t now)
+{
+	if (!esc.verifying) {
+		return;
+	}
+
+	uint32_t mttr_ms = incident_ms(now);
+	struct recovery_stage_stats *st = &stage_stats[esc.stage];
+
+	st->recovered++;
+	st->total_ms += mttr_ms;
+	st->max_ms = MAX(st->max_ms, mttr_ms);
+	LOG_EVT(INF, "RECOVERY", "RECOVERED", "stage=%s,mttr_ms=%u,tasks=0x%08x",
+		stage_names[esc.stage], mttr_ms, esc.task_mask);
+
+	/* Keep the incident open: a relapse inside the window escalates. */
+	esc.verifying = false;
+	esc.deadline = now + CONFIG_APP_RECOVERY_STABLE_MS;
+	atomic_set(&hold_until_ms, 0);
+}
+
+static void handle_escalation_deadline(int64_t now)
+{
+	if (esc.verifying) {
+		LOG_EVT(WRN, "RECOVERY", "STAGE_TIMEOUT", "stage=%s,tasks=0x%08x",
+			stage_names[esc.stage], esc.task_mask);
+		escalate(now);
+		return;
+	}
+
+	LOG_EVT(INF, "RECOVERY", "ESCALATION_CLEARED", "stage=%s,elapsed_ms=%u",
+		stage_names[esc.stage], incident_ms(now));
+	esc = (struct escalation){ .deadline = ESCALATION_NO_DEADLINE };
+	save_escalation(now);
+}
+
+/* Pick up an incident the previous boot left open. */
+static void escalation_resume(int64_t boot_ts)
+{
+	struct persist_state_escalation rec;
+
+	persist_state_get_escalation(&rec);
+	esc = (struct escalation){ .deadline = ESCALATION_NO_DEADLINE };
+	if (rec.stage == RECOVERY_STAGE_NONE || rec.stage >= RECOVERY_STAGE_COUNT) {
+		return;
+	}
+
+	/* An open in-place rung means its window ended in a watchdog reset,
+	 * which already did the warm rung's job.
+	 */
+	esc.stage = MAX((enum recovery_stage)rec.stage, RECOVERY_STAGE_WARM_REBOOT);
+	esc.task_mask = rec.task_mask;
+	esc.start_ts = boot_ts;
+	esc.carried_ms = rec.elapsed_ms;
+	esc.verifying = true;
+	/* Reboot rungs are counted here, where their outcome can be seen. */
+	stage_stats[esc.stage].attempts++;
+	LOG_EVT(WRN, "RECOVERY", "ESCALATION_RESUMED", "stage=%s,tasks=0x%08x,elapsed_ms=%u",
+		stage_names[esc.stage], esc.task_mask, esc.carried_ms);
+}
+#endif
+
 static void recovery_thread(void *p1, void *p2, void *p3)
 {
 	ARG_UNUSED(p1); ARG_UNUSED(p2); ARG_UNUSED(p3);
 	k_thread_name_set(k_current_get(), "recovery");
 
 	while (1) {
-		k_timeout_t wait = K_FOREVER;
-		bool deadline_pending = false;
+		int64_t wake_ts = INT64_MAX;
 
 		k_mutex_lock(&safe_mode_lock, K_FOREVER);
 
-			if (safe_mode_deadline != SAFE_MODE_DEADLINE_INACTIVE) {
-			int64_t now = k_uptime_get();
-			int64_t delta = safe_mode_deadline - now;
-
-			if (delta <= 0) {
+		if (safe_mode_deadline != SAFE_MODE_DEADLINE_INACTIVE) {
+			if (safe_mode_deadline <= k_uptime_get()) {
 				safe_mode_deadline = SAFE_MODE_DEADLINE_INACTIVE;
 				k_mutex_unlock(&safe_mode_lock);
 				handle_safe_mode_reboot();
 				continue;
 			}
-
-			if (delta > (int64_t)INT32_MAX) {
-				delta = (int64_t)INT32_MAX;
-			}
-
-			wait = K_MSEC((uint32_t)delta);
-			deadline_pending = true;
+			wake_ts = safe_mode_deadline;
 		}
 
 		k_mutex_unlock(&safe_mode_lock);
 
-		uint32_t events = k_event_wait(&recovery_event,
-					       BIT_MASK(RECOVERY_REASON_COUNT),
-					       true, wait);
+#if IS_ENABLED(CONFIG_APP_RECOVERY_ESCALATION)
+		if (esc.deadline <= k_uptime_get()) {
+			handle_escalation_deadline(k_uptime_get());
+			continue;
+		}
+		wake_ts = MIN(wake_ts, esc.deadline);
+#endif
+
+		/* Clear only what is handled below; a report posted while the
+		 * previous batch ran must not be lost.
+		 */
+		uint32_t events = k_event_wait(&recovery_event, RECOVERY_EVT_ALL, false,
+					       (wake_ts == INT64_MAX) ? K_FOREVER :
+					       K_TIMEOUT_ABS_MS(wake_ts));
 
 		if (events == 0U) {
-			/* timeout expired */
-			if (deadline_pending) {
-				continue;
-			}
-			/* No pending deadline; spurious timeout */
+			/* A deadline expired; re-evaluate. */
 			continue;
 		}
+		k_event_clear(&recovery_event, events);
 
 		if (events & BIT(RECOVERY_REASON_HEALTH_FAULT)) {
 			LOG_EVT_SIMPLE(ERR, "RECOVERY", "HEALTH_FAULT");
-			k_msleep(200);
-			sys_reboot(SYS_REBOOT_WARM);
+			reboot_after_hooks(RECOVERY_REASON_HEALTH_FAULT, SYS_REBOOT_WARM);
 		}
 
 		if (events & BIT(RECOVERY_REASON_MANUAL_TRIGGER)) {
 			LOG_EVT_SIMPLE(WRN, "RECOVERY", "MANUAL_TRIGGER");
-			k_msleep(200);
-			sys_reboot(SYS_REBOOT_WARM);
+			reboot_after_hooks(RECOVERY_REASON_MANUAL_TRIGGER, SYS_REBOOT_WARM);
 		}
 
 		if (events & BIT(RECOVERY_REASON_SAFE_MODE_TIMEOUT)) {
@@ -130,10 +595,19 @@ static void recovery_thread(void *p1, void *p2, void *p3)
 			handle_safe_mode_reboot();
 		}
 
+#if IS_ENABLED(CONFIG_APP_RECOVERY_ESCALATION)
+		if (events & RECOVERY_EVT_TASK_FAULT) {
+			handle_task_fault(k_uptime_get());
+		}
+
+		if (events & RECOVERY_EVT_HEALTHY) {
+			handle_healthy(k_uptime_get());
+		}
+#endif
+
 		if (events & BIT(RECOVERY_REASON_WATCHDOG_INIT_FAIL)) {
 			LOG_EVT_SIMPLE(ERR, "RECOVERY", "WATCHDOG_INIT_REBOOT");
-			k_msleep(200);
-			sys_reboot(SYS_REBOOT_WARM);
+			reboot_after_hooks(RECOVERY_REASON_WATCHDOG_INIT_FAIL, SYS_REBOOT_WARM);
 		}
 	}
 }
@@ -141,6 +615,11 @@ static void recovery_thread(void *p1, void *p2, void *p3)
 void recovery_start(void)
 {
 	k_event_init(&recovery_event);
+	k_work_init(&job.work, recovery_job_handler);
+	k_sem_init(&job.done, 0, 1);
+#if IS_ENABLED(CONFIG_APP_RECOVERY_ESCALATION)
+	escalation_resume(0);
+#endif
 	k_thread_create(&recovery_tid, recovery_stack,
 			K_THREAD_STACK_SIZEOF(recovery_stack),
 			recovery_thread, NULL, NULL, NULL,
@@ -174,6 +653,88 @@ void recovery_schedule_safe_mode_reboot(uint32_t delay_ms)
 	k_wakeup(&recovery_tid);
 }
 
+int recovery_register_reboot_hook(const struct recovery_reboot_hook *hook)
+{
+	if (hook == NULL || hook->step == NULL) {
+		return -EINVAL;
+	}
+
+	atomic_val_t slot = atomic_inc(&extra_hook_count);
+
+	if ((uint32_t)slot >= ARRAY_SIZE(extra_hooks)) {
+		(void)atomic_dec(&extra_hook_count);
+		return -ENOMEM;
+	}
+	extra_hooks[slot] = hook;
+	return 0;
+}
+
+int recovery_register_actions(uint32_t task_mask, recovery_action_fn restart,
+			      recovery_action_fn reinit)
+{
+#if IS_ENABLED(CONFIG_APP_RECOVERY_ESCALATION)
+	if (task_mask == 0U ||
+	    (uint64_t)task_mask >= BIT64(CONFIG_APP_SUPERVISOR_MAX_TASKS)) {
+		return -EINVAL;
+	}
+
+	while (task_mask != 0U) {
+		uint32_t slot = find_lsb_set(task_mask) - 1U;
+
+		task_mask &= task_mask - 1U;
+		actions[slot].restart = restart;
+		actions[slot].reinit = reinit;
+	}
+	return 0;
+#else
+	ARG_UNUSED(task_mask);
+	ARG_UNUSED(restart);
+	ARG_UNUSED(reinit);
+	return -ENOTSUP;
+#endif
+}
+
+void recovery_report_task_fault(uint32_t stale_mask)
+{
+#if IS_ENABLED(CONFIG_APP_RECOVERY_ESCALATION)
+	atomic_or(&fault_mask, (atomic_val_t)stale_mask);
+	k_event_post(&recovery_event, RECOVERY_EVT_TASK_FAULT);
+#else
+	ARG_UNUSED(stale_mask);
+	recovery_request(RECOVERY_REASON_HEALTH_FAULT);
+#endif
+}
+
+void recovery_report_healthy(void)
+{
+#if IS_ENABLED(CONFIG_APP_RECOVERY_ESCALATION)
+	k_event_post(&recovery_event, RECOVERY_EVT_HEALTHY);
+#endif
+}
+
+bool recovery_holds_watchdog(void)
+{
+#if IS_ENABLED(CONFIG_APP_RECOVERY_ESCALATION)
+	uint32_t until = (uint32_t)atomic_get(&hold_until_ms);
+
+	return until != 0U && (int32_t)(until - k_uptime_get_32()) > 0;
+#else
+	return false;
+#endif
+}
+
+void recovery_get_stage_stats(enum recovery_stage stage, struct recovery_stage_stats *out)
+{
+	*out = (struct recovery_stage_stats){ 0 };
+#if IS_ENABLED(CONFIG_APP_RECOVERY_ESCALATION)
+	if (stage >= 0 && stage < RECOVERY_STAGE_COUNT) {
+		*out = stage_stats[stage];
+	}
+#else
+	ARG_UNUSED(stage);
+#endif
+}
+
 #if defined(CONFIG_ZTEST)
 void recovery_test_init_event(void)
 {
@@ -190,4 +751,23 @@ void recovery_test_clear_pending_events(void)
 {
 	atomic_set(&recovery_test_events, 0);
 }
+
+void recovery_test_set_reboot_hook(void (*hook)(int type))
+{
+	reboot_hook = hook;
+}
+
+void recovery_test_last_reboot_prep(struct recovery_reboot_prep *out)
+{
+	*out = last_prep;
+}
+
+void recovery_test_reboot(void)
+{
+#if IS_ENABLED(CONFIG_APP_RECOVERY_ESCALATION)
+	atomic_set(&hold_until_ms, 0);
+	atomic_set(&fault_mask, 0);
+	escalation_resume(k_uptime_get());
+#endif
+}
 #endif
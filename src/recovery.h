@@ -11,8 +11,68 @@ enum recovery_reason {
 	RECOVERY_REASON_COUNT
 };
 
+/* Escalation ladder for heartbeat faults (CONFIG_APP_RECOVERY_ESCALATION).
+ * Each fault of an open incident moves one rung up; rungs without a
+ * registered action for the stale tasks are skipped.
+ */
+enum recovery_stage {
+	RECOVERY_STAGE_NONE = 0,
+	RECOVERY_STAGE_RESTART,     /* restart the stalled work item or thread */
+	RECOVERY_STAGE_REINIT,      /* reinitialise the task's driver */
+	RECOVERY_STAGE_WARM_REBOOT,
+	RECOVERY_STAGE_COLD_REBOOT,
+	RECOVERY_STAGE_COUNT
+};
+
+/* Fault-to-healthy times of the attempts made at one rung. Reboot rungs
+ * include the time spent before the reset, carried in persist_state.
+ */
+struct recovery_stage_stats {
+	uint32_t attempts;
+	uint32_t recovered;
+	uint32_t total_ms;
+	uint32_t max_ms;
+};
+
+/* Returns 0 once the action has been issued, negative errno to skip to the
+ * next rung. Runs on the recovery thread.
+ */
+typedef int (*recovery_action_fn)(void);
+
+/* Pre-reboot hook. step() is called until it returns 0 (done), a negative
+ * errno other than -EINPROGRESS (failed), or the chain deadline
+ * (CONFIG_APP_RECOVERY_REBOOT_DEADLINE_MS) passes. call counts from 0, so a
+ * hook can start work on the first call and poll on later ones. Runs on the
+ * recovery thread, 1 ms apart.
+ */
+struct recovery_reboot_hook {
+	const char *name;
+	int (*step)(enum recovery_reason reason, int reboot_type, uint32_t call);
+};
+
 void recovery_start(void);
 void recovery_request(enum recovery_reason reason);
 void recovery_schedule_safe_mode_reboot(uint32_t delay_ms);
+/* Add a hook to run before every recovery reboot, after the reason is
+ * recorded and before persist_state commits. The hook must stay valid.
+ * Returns -ENOMEM once CONFIG_APP_RECOVERY_REBOOT_HOOKS are in use.
+ */
+int recovery_register_reboot_hook(const struct recovery_reboot_hook *hook);
+/* Attach restart/reinit actions to supervisor heartbeat slots (bit = handle).
+ * Either action may be NULL. Call from init code before faults can occur.
+ */
+int recovery_register_actions(uint32_t task_mask, recovery_action_fn restart,
+			      recovery_action_fn reinit);
+/* Supervisor hooks: heartbeats in stale_mask went stale / all heartbeats are
+ * healthy again. Without CONFIG_APP_RECOVERY_ESCALATION a fault is a
+ * RECOVERY_REASON_HEALTH_FAULT request.
+ */
+void recovery_report_task_fault(uint32_t stale_mask);
+void recovery_report_healthy(void);
+/* True while an in-place rung is inside its CONFIG_APP_RECOVERY_STAGE_TIMEOUT_MS
+ * window; the supervisor keeps feeding the watchdog until then.
+ */
+bool recovery_holds_watchdog(void);
+void recovery_get_stage_stats(enum recovery_stage stage, struct recovery_stage_stats *out);
 
 #endif /* RECOVERY_H */
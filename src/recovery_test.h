@@ -4,9 +4,22 @@
 #include <stdint.h>
 
 #if defined(CONFIG_ZTEST)
+/* Timing of the last pre-reboot chain; bits are chain positions. */
+struct recovery_reboot_prep {
+	uint32_t hooks_ms;
+	uint32_t drain_ms;
+	uint32_t late_mask;
+	uint32_t failed_mask;
+};
+
 void recovery_test_init_event(void);
 uint32_t recovery_test_get_pending_events(void);
 void recovery_test_clear_pending_events(void);
+/* Replaces sys_reboot() on every reboot path. */
+void recovery_test_set_reboot_hook(void (*hook)(int type));
+void recovery_test_last_reboot_prep(struct recovery_reboot_prep *out);
+/* Re-read the escalation record as if the board had just booted. */
+void recovery_test_reboot(void);
 #endif
 
 #endif /* RECOVERY_TEST_H */
@@ -11,6 +11,7 @@
 #include <zephyr/logging/log.h>
 
 #include "app_crypto.h"
+#include "log_tx.h"
 #include "log_utils.h"
 #include "supervisor.h"
 
@@ -28,9 +29,11 @@ static const struct device *const hts221_dev = DEVICE_DT_GET_ONE(st_hts221);
 static const struct gpio_dt_spec led = GPIO_DT_SPEC_GET(LED0_NODE, gpios);
 
 static bool sensor_led_ready;
+static bool sensor_safe_mode;
 static uint32_t sensor_poll_interval_ms;
 static struct k_work_delayable sensor_work;
 static uint32_t sample_counter;
+static uint32_t samples_skipped;
 
 struct sensor_sample_payload {
 	int64_t temp_mc;
@@ -100,7 +103,21 @@ static void sensor_work_handler(struct k_work *work)
 					backend_str);
 			}
 
+			if (log_tx_congested()) {
+				/* Log output is backed up: skip this sample's line
+				 * rather than have the backend drop it.
+				 */
+				samples_skipped++;
+				logged = true;
+				use_encryption = false;
+			} else if (samples_skipped != 0U) {
+				LOG_EVT(WRN, "SENSOR", "HTS221_SKIPPED", "count=%u", samples_skipped);
+				samples_skipped = 0U;
+			}
+
 			if (use_encryption) {
+				app_crypto_message_boundary();
+
 				struct sensor_sample_payload payload = {
 					.temp_mc = temp_mc,
 					.humidity_mpct = humid_mpct,
@@ -174,6 +191,7 @@ int sensor_hts221_start(bool safe_mode_active)
 		return -ENODEV;
 	}
 
+	sensor_safe_mode = safe_mode_active;
 	sensor_poll_interval_ms = safe_mode_active ?
 		CONFIG_APP_SENSOR_SAFE_MODE_INTERVAL_MS :
 		CONFIG_APP_SENSOR_SAMPLE_INTERVAL_MS;
@@ -199,3 +217,23 @@ int sensor_hts221_start(bool safe_mode_active)
 	sample_counter = 0U;
 	return 0;
 }
+
+int sensor_hts221_restart(void)
+{
+	int rc = k_work_reschedule_for_queue(&k_sys_work_q, &sensor_work, K_NO_WAIT);
+
+	return (rc < 0) ? rc : 0;
+}
+
+int sensor_hts221_reinit(void)
+{
+	(void)k_work_cancel_delayable(&sensor_work);
+	/* A handler blocked inside the driver cannot be re-initialised. */
+	if (k_work_delayable_busy_get(&sensor_work) != 0) {
+		return -EBUSY;
+	}
+
+	int rc = sensor_hts221_start(sensor_safe_mode);
+
+	return (rc == 0) ? sensor_hts221_restart() : rc;
+}
@@ -11,4 +11,17 @@
  */
 int sensor_hts221_start(bool safe_mode_active);
 
+/**
+ * Recovery ladder actions (see recovery_register_actions()).
+ *
+ * restart reschedules the polling work item immediately; reinit cancels it,
+ * runs sensor_hts221_start() again with the mode it was started in and
+ * polls right away.
+ *
+ * @return 0 on success, -EBUSY if the work item is stuck in its handler,
+ *	   or the error from the work queue / start.
+ */
+int sensor_hts221_restart(void);
+int sensor_hts221_reinit(void);
+
 #endif /* SENSOR_HTS221_H */
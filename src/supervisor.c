@@ -8,6 +8,8 @@
 #include <limits.h>
 #include <string.h>
 
+#include "event_log.h"
+#include "log2_hist.h"
 #include "log_utils.h"
 #include "persist_state.h"
 #include "recovery.h"
@@ -28,47 +30,206 @@ LOG_MODULE_REGISTER(supervisor, LOG_LEVEL_INF);
 #define SUPERVISOR_BOOT_GRACE_MS 3000U
 #endif
 #define SUPERVISOR_MAX_FAILURES 3U
+/* Status-register poll period while an IWDG retune is in flight. */
+#define SUPERVISOR_RETUNE_POLL_MS 5U
 
 K_THREAD_STACK_DEFINE(supervisor_stack, CONFIG_APP_SUPERVISOR_THREAD_STACK_SIZE);
 static struct k_thread supervisor_tid;
-static atomic_t led_last_seen = ATOMIC_INIT(0);
-static atomic_t sys_last_seen = ATOMIC_INIT(0);
+
+/* Heartbeat registry. The system and LED heartbeats occupy the first two
+ * slots; supervisor_register_task() hands out the rest. Producers only touch
+ * their timestamp and their bit in task_checked_in, so check-ins are
+ * lock-free and ISR-safe.
+ */
+enum {
+	SUPERVISOR_TASK_SYSTEM = SUPERVISOR_HANDLE_SYSTEM,
+	SUPERVISOR_TASK_LED = SUPERVISOR_HANDLE_LED,
+	SUPERVISOR_TASK_BUILTIN
+};
+
+struct supervisor_task {
+	const char *name;
+	uint32_t stale_ms;
+};
+
+static struct supervisor_task tasks[CONFIG_APP_SUPERVISOR_MAX_TASKS] = {
+	[SUPERVISOR_TASK_SYSTEM] = { "system", CONFIG_APP_HEALTH_SYS_STALE_MS },
+	[SUPERVISOR_TASK_LED] = { "led", CONFIG_APP_HEALTH_LED_STALE_MS },
+};
+static atomic_t task_last_seen[CONFIG_APP_SUPERVISOR_MAX_TASKS];
+static atomic_t task_monitored = ATOMIC_INIT(0);
+static atomic_t task_checked_in = ATOMIC_INIT(0);
+static atomic_t task_min_stale_ms =
+	ATOMIC_INIT(MIN(CONFIG_APP_HEALTH_SYS_STALE_MS, CONFIG_APP_HEALTH_LED_STALE_MS));
+static uint8_t task_count = SUPERVISOR_TASK_BUILTIN; /* guarded by cfg_lock */
+#if IS_ENABLED(CONFIG_APP_HEALTH_JITTER_STATS)
+/* Inter-arrival time of each slot's check-ins, filled by the producers. */
+static struct log2_hist task_jitter[CONFIG_APP_SUPERVISOR_MAX_TASKS];
+static int64_t jitter_window_start_ts; /* supervisor thread only */
+#endif
 static int64_t supervisor_boot_ts;
-static bool watchdog_counter_cleared;
+/* Given when the thread must re-plan before its current deadline. */
+static K_SEM_DEFINE(supervisor_wake, 0, 1);
 #if defined(CONFIG_ZTEST)
 static bool supervisor_thread_started;
+static atomic_t supervisor_wakeups = ATOMIC_INIT(0);
 #endif
 
-struct watchdog_cfg {
+/* Watchdog target requested by other threads. Writers serialize on cfg_lock
+ * and publish under a sequence counter (odd = publish in progress); the
+ * supervisor thread only reads, so it never waits on a lower-priority thread
+ * holding the mutex. A new generation tells it to re-plan the retune.
+ */
+struct watchdog_request {
+	uint32_t generation;
 	uint32_t desired_timeout_ms;
 	uint32_t retune_delay_ms;
 	int64_t retune_ready_ts;
-	bool monitor_led;
-	bool retune_pending;
-	bool retune_done_once;
-	bool retune_failed_logged;
 };
 
-static struct watchdog_cfg wd_cfg;
+/* Retune progress; owned by the supervisor thread, no locking. */
+struct retune_state {
+	uint32_t generation;
+	uint32_t desired_timeout_ms;
+	int64_t ready_ts;
+	int64_t poll_ts;
+	bool pending;
+	bool in_flight;
+	bool done_once;
+	bool failed_logged;
+};
+
+static struct watchdog_request wd_req;
+static atomic_t wd_req_seq = ATOMIC_INIT(0);
 static K_MUTEX_DEFINE(cfg_lock);
 
-static void update_retune_schedule_locked(bool apply_immediately)
+/* Same scheme as persist_publish_locked(): the scheduler lock keeps the odd
+ * window from being preempted, so a higher-priority reader never spins.
+ */
+static void publish_request_locked(uint32_t timeout_ms, bool apply_immediately)
 {
-	int64_t now = k_uptime_get();
+	struct watchdog_request next = wd_req;
+
+	next.generation++;
+	next.desired_timeout_ms = timeout_ms;
+	next.retune_ready_ts = k_uptime_get() +
+			       (apply_immediately ? 0 : (int64_t)next.retune_delay_ms);
+
+	k_sched_lock();
+	(void)atomic_inc(&wd_req_seq);
+	wd_req = next;
+	(void)atomic_inc(&wd_req_seq);
+	k_sched_unlock();
+}
 
-	wd_cfg.retune_ready_ts = now + (apply_immediately ? 0 : (int64_t)wd_cfg.retune_delay_ms);
-	wd_cfg.retune_pending = (wd_cfg.desired_timeout_ms != watchdog_ctrl_get_timeout());
-	if (!wd_cfg.retune_pending) {
-		wd_cfg.retune_done_once = true;
+static void read_request(struct watchdog_request *out)
+{
+	atomic_val_t seq;
+
+	do {
+		seq = atomic_get(&wd_req_seq);
+		*out = wd_req;
+	} while (((seq & 1) != 0) || (atomic_get(&wd_req_seq) != seq));
+}
+
+/* Returns true when a new request was picked up. */
+static bool refresh_retune_state(struct retune_state *rt)
+{
+	struct watchdog_request req;
+
+	read_request(&req);
+	if (req.generation == rt->generation) {
+		return false;
 	}
-	wd_cfg.retune_failed_logged = false;
+
+	rt->generation = req.generation;
+	rt->desired_timeout_ms = req.desired_timeout_ms;
+	rt->ready_ts = req.retune_ready_ts;
+	rt->pending = (req.desired_timeout_ms != watchdog_ctrl_get_timeout());
+	rt->done_once = !rt->pending;
+	rt->failed_logged = false;
+	return true;
 }
 
-static void snapshot_watchdog_cfg(struct watchdog_cfg *out_cfg)
+/* Feed schedule derived from the timeout currently armed in the IWDG;
+ * owned by the supervisor thread.
+ */
+struct feed_plan {
+	uint32_t timeout_ms;
+	uint32_t interval_ms;
+	int64_t last_feed_ts; /* 0 until this thread fed or reloaded the IWDG */
+	int64_t next_feed_ts;
+};
+
+/* Re-plan after boot or a retune. A successful retune also reloads the
+ * counter, so the next feed is a full interval away.
+ */
+static void feed_plan_update(struct feed_plan *plan, int64_t now, bool reloaded)
 {
-	k_mutex_lock(&cfg_lock, K_FOREVER);
-	*out_cfg = wd_cfg;
-	k_mutex_unlock(&cfg_lock);
+	plan->timeout_ms = watchdog_ctrl_get_timeout();
+	plan->interval_ms = (plan->timeout_ms == 0U) ? SUPERVISOR_PERIOD_MS :
+			    MAX((plan->timeout_ms * CONFIG_APP_WATCHDOG_FEED_PERCENT) / 100U, 1U);
+	plan->last_feed_ts = reloaded ? now : 0;
+	plan->next_feed_ts = reloaded ? (now + plan->interval_ms) : now;
+}
+
+#if IS_ENABLED(CONFIG_APP_WATCHDOG_MARGIN_STATS)
+/* Time left before expiry at each feed, per report window. */
+static struct {
+	struct log2_hist hist;
+	uint32_t min_ms;
+	int64_t window_start_ts;
+} margin_stats = {
+	.min_ms = UINT32_MAX,
+};
+
+static void margin_report(const struct feed_plan *plan, int64_t now)
+{
+	uint32_t feeds = log2_hist_count(&margin_stats.hist);
+
+	if (feeds != 0U) {
+		LOG_EVT(INF, "WATCHDOG", "MARGIN",
+			"timeout_ms=%u,interval_ms=%u,feeds=%u,min_ms=%u,p50_ms=%u,p99_ms=%u",
+			plan->timeout_ms, plan->interval_ms, feeds, margin_stats.min_ms,
+			log2_hist_percentile(&margin_stats.hist, 50U),
+			log2_hist_percentile(&margin_stats.hist, 99U));
+	}
+
+	log2_hist_reset(&margin_stats.hist);
+	margin_stats.min_ms = UINT32_MAX;
+	margin_stats.window_start_ts = now;
+}
+#endif
+
+static void note_feed(struct feed_plan *plan, int64_t now)
+{
+#if IS_ENABLED(CONFIG_APP_WATCHDOG_MARGIN_STATS)
+	if (plan->last_feed_ts != 0 && plan->timeout_ms != 0U) {
+		int64_t left = plan->last_feed_ts + (int64_t)plan->timeout_ms - now;
+		uint32_t margin = (left > 0) ? (uint32_t)left : 0U;
+
+		log2_hist_add(&margin_stats.hist, margin);
+		margin_stats.min_ms = MIN(margin_stats.min_ms, margin);
+	}
+
+	if ((CONFIG_APP_WATCHDOG_MARGIN_REPORT_S > 0) &&
+	    ((now - margin_stats.window_start_ts) >=
+	     ((int64_t)CONFIG_APP_WATCHDOG_MARGIN_REPORT_S * MSEC_PER_SEC))) {
+		margin_report(plan, now);
+	}
+#endif
+	plan->last_feed_ts = now;
+}
+
+static void note_retune(struct feed_plan *plan, int64_t now)
+{
+#if IS_ENABLED(CONFIG_APP_WATCHDOG_MARGIN_STATS)
+	/* Close the window for the old timeout. */
+	margin_report(plan, now);
+#endif
+	feed_plan_update(plan, now, true);
+	LOG_EVT(INF, "WATCHDOG", "FEED_PLAN", "timeout_ms=%u,interval_ms=%u",
+		plan->timeout_ms, plan->interval_ms);
 }
 
 static bool feed_watchdog(const char *context, uint32_t *fail_count)
@@ -76,6 +237,7 @@ static bool feed_watchdog(const char *context, uint32_t *fail_count)
 	int ret = watchdog_ctrl_feed();
 
 	if (ret == 0) {
+		persist_state_watchdog_fed(watchdog_ctrl_get_timeout());
 		return true;
 	}
 
@@ -90,6 +252,7 @@ static bool feed_watchdog(const char *context, uint32_t *fail_count)
 	}
 
 	LOG_EVT(ERR, "WATCHDOG", "FEED_FAIL", "context=%s,rc=%d", context, ret);
+	event_log_append(EVENT_LOG_WATCHDOG_FEED_FAIL, (uint32_t)ret);
 
 	if (fail_count != NULL) {
 		(*fail_count)++;
@@ -99,96 +262,261 @@ static bool feed_watchdog(const char *context, uint32_t *fail_count)
 }
 
 struct health_status {
-	bool led_ok;
-	bool hb_ok;
-	uint32_t led_age;
-	uint32_t hb_age;
+	uint32_t stale_mask; /* monitored tasks past their stale threshold */
+	int64_t deadline;    /* earliest expiry among the fresh ones */
 };
 
-static struct health_status sample_health(const struct watchdog_cfg *cfg, uint32_t now32)
+static uint32_t task_age(uint32_t slot, uint32_t now32)
 {
+	uint32_t last = (uint32_t)atomic_get(&task_last_seen[slot]);
+
+	return (last == 0U) ? UINT32_MAX : (now32 - last);
+}
+
+/* A task that checked in since window_start is fresh for at least the
+ * smallest stale threshold after window_start, so when the window is shorter
+ * than that the check is two mask operations. Only tasks that missed the
+ * window have their timestamps read.
+ */
+static struct health_status sample_health(int64_t now, int64_t window_start)
+{
+	uint32_t monitored = (uint32_t)atomic_get(&task_monitored);
+	uint32_t checked = (uint32_t)atomic_clear(&task_checked_in);
+	uint32_t min_stale = (uint32_t)atomic_get(&task_min_stale_ms);
 	struct health_status status = {
-		.led_ok = true,
-		.hb_ok = false,
-		.led_age = 0U,
-		.hb_age = 0U,
+		.stale_mask = 0U,
+		.deadline = INT64_MAX,
 	};
+	uint32_t slow = monitored;
 
-	uint32_t hb_last = atomic_get(&sys_last_seen);
-	if (hb_last == 0U) {
-		status.hb_ok = false;
-		status.hb_age = UINT32_MAX;
-	} else {
-		uint32_t age = now32 - hb_last;
-		status.hb_age = age;
-		status.hb_ok = age <= CONFIG_APP_HEALTH_SYS_STALE_MS;
+	if ((monitored & checked) != 0U && (now - window_start) <= (int64_t)min_stale) {
+		slow &= ~checked;
+		status.deadline = window_start + (int64_t)min_stale + 1;
 	}
 
-	if (!cfg->monitor_led) {
-		status.led_ok = true;
-		status.led_age = 0U;
-		return status;
-	}
+	while (slow != 0U) {
+		uint32_t slot = find_lsb_set(slow) - 1U;
+		uint32_t age = task_age(slot, (uint32_t)now);
 
-	uint32_t led_last = atomic_get(&led_last_seen);
-	if (led_last == 0U) {
-		status.led_ok = false;
-		status.led_age = UINT32_MAX;
-	} else {
-		uint32_t age = now32 - led_last;
-		status.led_age = age;
-		status.led_ok = age <= CONFIG_APP_HEALTH_LED_STALE_MS;
+		slow &= slow - 1U;
+		if (age > tasks[slot].stale_ms) {
+			status.stale_mask |= BIT(slot);
+		} else {
+			status.deadline = MIN(status.deadline,
+					      now + (int64_t)(tasks[slot].stale_ms - age) + 1);
+		}
 	}
 
 	return status;
 }
 
+/* Per-task TASK_STALE / TASK_RESTORED events; each new stale transition also
+ * bumps the task's persisted fault counter.
+ */
+static void report_task_transitions(uint32_t stale_mask, uint32_t *reported, uint32_t now32)
+{
+	uint32_t newly_stale = stale_mask & ~*reported;
+	uint32_t restored = *reported & ~stale_mask;
+
+	while (newly_stale != 0U) {
+		uint32_t slot = find_lsb_set(newly_stale) - 1U;
+		int faults = persist_state_note_task_fault((uint8_t)slot);
+
+		newly_stale &= newly_stale - 1U;
+		LOG_EVT(WRN, "HEALTH", "TASK_STALE", "task=%s,age_ms=%u,stale_ms=%u,faults=%d",
+			tasks[slot].name, task_age(slot, now32), tasks[slot].stale_ms, faults);
+	}
+
+	while (restored != 0U) {
+		uint32_t slot = find_lsb_set(restored) - 1U;
+
+		restored &= restored - 1U;
+		LOG_EVT(INF, "HEALTH", "TASK_RESTORED", "task=%s", tasks[slot].name);
+	}
+
+	*reported = stale_mask;
+}
+
+int supervisor_register_task(const char *name, uint32_t stale_ms)
+{
+	if (name == NULL || stale_ms == 0U) {
+		return -EINVAL;
+	}
+
+	k_mutex_lock(&cfg_lock, K_FOREVER);
+
+	if (task_count >= CONFIG_APP_SUPERVISOR_MAX_TASKS) {
+		k_mutex_unlock(&cfg_lock);
+		LOG_EVT(WRN, "HEALTH", "TASK_REGISTRY_FULL", "task=%s", name);
+		return -ENOMEM;
+	}
+
+	int slot = task_count++;
+
+	tasks[slot].name = name;
+	tasks[slot].stale_ms = stale_ms;
+	atomic_set(&task_last_seen[slot], k_uptime_get_32());
+	if (stale_ms < (uint32_t)atomic_get(&task_min_stale_ms)) {
+		atomic_set(&task_min_stale_ms, stale_ms);
+	}
+	atomic_or(&task_monitored, BIT(slot));
+
+	k_mutex_unlock(&cfg_lock);
+
+	LOG_EVT(INF, "HEALTH", "TASK_REGISTERED", "task=%s,slot=%d,stale_ms=%u,faults=%u",
+		name, slot, stale_ms, persist_state_get_task_faults((uint8_t)slot));
+	/* Re-plan: the new task may expire before the current wake deadline. */
+	k_sem_give(&supervisor_wake);
+	return slot;
+}
+
+void supervisor_task_alive(int handle)
+{
+	if (handle < 0 || handle >= CONFIG_APP_SUPERVISOR_MAX_TASKS) {
+		return;
+	}
+
+	uint32_t now32 = k_uptime_get_32();
+	uint32_t prev = (uint32_t)atomic_set(&task_last_seen[handle], (atomic_val_t)now32);
+
+	atomic_or(&task_checked_in, BIT(handle));
+#if IS_ENABLED(CONFIG_APP_HEALTH_JITTER_STATS)
+	/* 0 means the slot was never stamped; there is no interval yet. */
+	if (prev != 0U) {
+		log2_hist_add(&task_jitter[handle], now32 - prev);
+	}
+#else
+	ARG_UNUSED(prev);
+#endif
+}
+
+uint32_t supervisor_task_age_ms(int handle)
+{
+	if (handle < 0 || handle >= CONFIG_APP_SUPERVISOR_MAX_TASKS ||
+	    (atomic_get(&task_monitored) & BIT(handle)) == 0) {
+		return UINT32_MAX;
+	}
+
+	return task_age((uint32_t)handle, k_uptime_get_32());
+}
+
 void supervisor_notify_led_alive(void)
 {
-	atomic_set(&led_last_seen, k_uptime_get_32());
+	supervisor_task_alive(SUPERVISOR_TASK_LED);
 }
 
 void supervisor_notify_system_alive(void)
 {
-	atomic_set(&sys_last_seen, k_uptime_get_32());
+	supervisor_task_alive(SUPERVISOR_TASK_SYSTEM);
+}
+
+#if IS_ENABLED(CONFIG_APP_HEALTH_JITTER_STATS)
+static void log_jitter(void)
+{
+	uint32_t monitored = (uint32_t)atomic_get(&task_monitored);
+
+	while (monitored != 0U) {
+		uint32_t slot = find_lsb_set(monitored) - 1U;
+		const struct log2_hist *hist = &task_jitter[slot];
+
+		monitored &= monitored - 1U;
+		LOG_EVT(INF, "HEALTH", "JITTER",
+			"task=%s,samples=%u,p50_ms=%u,p99_ms=%u,max_ms=%u,stale_ms=%u",
+			tasks[slot].name, log2_hist_count(hist),
+			log2_hist_percentile(hist, 50U), log2_hist_percentile(hist, 99U),
+			log2_hist_max(hist), tasks[slot].stale_ms);
+	}
 }
 
-static void attempt_watchdog_retune(const struct watchdog_cfg *cfg, int64_t now)
+static void jitter_report_if_due(int64_t now)
 {
-	if (!cfg->retune_pending || now < cfg->retune_ready_ts) {
+	if ((CONFIG_APP_HEALTH_JITTER_REPORT_S == 0) ||
+	    ((now - jitter_window_start_ts) <
+	     ((int64_t)CONFIG_APP_HEALTH_JITTER_REPORT_S * MSEC_PER_SEC))) {
 		return;
 	}
 
-	int rc = watchdog_ctrl_retune(cfg->desired_timeout_ms);
+	log_jitter();
+	/* A check-in racing the reset may be lost; the window stays usable. */
+	for (size_t i = 0U; i < ARRAY_SIZE(task_jitter); i++) {
+		log2_hist_reset(&task_jitter[i]);
+	}
+	jitter_window_start_ts = now;
+}
+
+void supervisor_log_health_stats(void)
+{
+	log_jitter();
+}
+#endif
+
+/* Returns true when a retune finished, i.e. the IWDG counter was reloaded. */
+static bool attempt_watchdog_retune(struct retune_state *rt, int64_t now)
+{
+	int rc;
+
+	if (rt->in_flight) {
+		if (now < rt->poll_ts) {
+			return false;
+		}
+
+		rc = watchdog_ctrl_retune_poll();
+		if (rc == -EINPROGRESS) {
+			rt->poll_ts = now + SUPERVISOR_RETUNE_POLL_MS;
+			return false;
+		}
+
+		rt->in_flight = false;
+		if (rc != 0) {
+			LOG_EVT(WRN, "WATCHDOG", "RETUNE_DEFERRED", "rc=%d", rc);
+			rt->ready_ts = now + SUPERVISOR_PERIOD_MS;
+			return false;
+		}
+
+		uint32_t armed = watchdog_ctrl_get_timeout();
+
+		LOG_EVT(INF, "WATCHDOG", "RETUNED", "timeout_ms=%u", armed);
+		/* A newer request may have arrived mid-update; it starts next. */
+		rt->pending = (armed != rt->desired_timeout_ms);
+		rt->done_once = !rt->pending;
+		rt->failed_logged = false;
+		return true;
+	}
+
+	if (!rt->pending || now < rt->ready_ts) {
+		return false;
+	}
+
+	rc = watchdog_ctrl_retune_start(rt->desired_timeout_ms);
+
+	if (rc == -EINPROGRESS) {
+		/* Registers written; poll on later wakeups instead of spinning. */
+		rt->in_flight = true;
+		rt->poll_ts = now + SUPERVISOR_RETUNE_POLL_MS;
+		return false;
+	}
 
 	if (rc == 0) {
-		LOG_EVT(INF, "WATCHDOG", "RETUNED", "timeout_ms=%u", cfg->desired_timeout_ms);
-		k_mutex_lock(&cfg_lock, K_FOREVER);
-		wd_cfg.retune_pending = false;
-		wd_cfg.retune_done_once = true;
-		wd_cfg.retune_failed_logged = false;
-		k_mutex_unlock(&cfg_lock);
-		persist_state_clear_watchdog_counter();
-		watchdog_counter_cleared = true;
-		return;
+		LOG_EVT(INF, "WATCHDOG", "RETUNED", "timeout_ms=%u", rt->desired_timeout_ms);
+		rt->pending = false;
+		rt->done_once = true;
+		rt->failed_logged = false;
+		return true;
 	}
 
 	if (rc == -ENOTSUP || rc == -ENOTTY) {
-		if (!cfg->retune_failed_logged) {
+		if (!rt->failed_logged) {
 			LOG_EVT(WRN, "WATCHDOG", "RETUNE_NOT_SUPPORTED", "rc=%d", rc);
 		}
-		k_mutex_lock(&cfg_lock, K_FOREVER);
-		wd_cfg.retune_pending = false;
-		wd_cfg.retune_done_once = true;
-		wd_cfg.retune_failed_logged = true;
-		k_mutex_unlock(&cfg_lock);
-		return;
+		rt->pending = false;
+		rt->done_once = true;
+		rt->failed_logged = true;
+		return false;
 	}
 
 	LOG_EVT(WRN, "WATCHDOG", "RETUNE_DEFERRED", "rc=%d", rc);
-	k_mutex_lock(&cfg_lock, K_FOREVER);
-	wd_cfg.retune_ready_ts = now + SUPERVISOR_PERIOD_MS;
-	k_mutex_unlock(&cfg_lock);
+	rt->ready_ts = now + SUPERVISOR_PERIOD_MS;
+	return false;
 }
 
 static void supervisor_thread(void *p1, void *p2, void *p3)
@@ -200,83 +528,158 @@ static void supervisor_thread(void *p1, void *p2, void *p3)
 	k_thread_name_set(k_current_get(), "supervisor");
 
 	uint32_t fail_count = 0;
+	bool watchdog_counter_cleared = false;
+	struct retune_state rt = {0};
+	struct feed_plan plan;
+	bool degraded = false;
+	bool healthy_reported = false;
+	uint32_t stale_reported = 0U;
+	int64_t window_start = supervisor_boot_ts;
+
+	feed_plan_update(&plan, k_uptime_get(), false);
+#if IS_ENABLED(CONFIG_APP_HEALTH_JITTER_STATS)
+	jitter_window_start_ts = supervisor_boot_ts;
+#endif
 
 	while (1) {
 		int64_t now = k_uptime_get();
 		uint32_t now32 = (uint32_t)now;
-		struct watchdog_cfg cfg;
 
-		snapshot_watchdog_cfg(&cfg);
-		attempt_watchdog_retune(&cfg, now);
+		if (refresh_retune_state(&rt)) {
+			watchdog_counter_cleared = false;
+		}
+		if (attempt_watchdog_retune(&rt, now)) {
+			note_retune(&plan, now);
+			persist_state_clear_watchdog_counter();
+			watchdog_counter_cleared = true;
+		}
+
+		struct health_status health = sample_health(now, window_start);
+		int64_t grace_end_ts = supervisor_boot_ts + SUPERVISOR_BOOT_GRACE_MS;
+		bool in_boot_grace = now < grace_end_ts;
+		bool healthy = in_boot_grace || (health.stale_mask == 0U);
+
+		window_start = now;
+		if (!in_boot_grace) {
+			report_task_transitions(health.stale_mask, &stale_reported, now32);
+		}
+#if IS_ENABLED(CONFIG_APP_HEALTH_JITTER_STATS)
+		jitter_report_if_due(now);
+#endif
+		bool feed_due = now >= plan.next_feed_ts;
 
-		struct health_status health = sample_health(&cfg, now32);
-		bool in_boot_grace = (now - supervisor_boot_ts) < SUPERVISOR_BOOT_GRACE_MS;
+		if (feed_due) {
+			/* Fixed cadence from the previous slot, not from "now". */
+			plan.next_feed_ts += plan.interval_ms;
+			if (plan.next_feed_ts <= now) {
+				plan.next_feed_ts = now + plan.interval_ms;
+			}
+		}
 
-		if (!watchdog_counter_cleared && cfg.retune_done_once && !in_boot_grace &&
-		    health.led_ok && health.hb_ok) {
+		if (!watchdog_counter_cleared && rt.done_once && !in_boot_grace &&
+		    healthy) {
 			persist_state_clear_watchdog_counter();
 			watchdog_counter_cleared = true;
 		}
 
 		if (in_boot_grace) {
-			if (watchdog_ctrl_is_enabled()) {
-				(void)feed_watchdog("boot grace", NULL);
+			if (feed_due && watchdog_ctrl_is_enabled() &&
+			    feed_watchdog("boot grace", NULL)) {
+				note_feed(&plan, now);
 			}
 			fail_count = 0;
-		} else if (health.led_ok && health.hb_ok) {
-			if (watchdog_ctrl_is_enabled()) {
+		} else if (healthy) {
+			if (degraded) {
+				degraded = false;
+				LOG_EVT_SIMPLE(INF, "HEALTH", "RESTORED");
+			}
+			if (!healthy_reported) {
+				/* Also once per boot, so a ladder resumed after a
+				 * reboot rung can see the outcome.
+				 */
+				healthy_reported = true;
+				recovery_report_healthy();
+			}
+
+			/* Early wakeups (retune, config change) leave the cadence alone. */
+			if (feed_due && watchdog_ctrl_is_enabled()) {
 				bool fed = feed_watchdog("steady-state", &fail_count);
 
 				if (fed) {
+					note_feed(&plan, now);
 					fail_count = 0;
 				} else if (fail_count >= SUPERVISOR_MAX_FAILURES) {
 					LOG_ERR("Repeated watchdog feed failures -- requesting recovery");
 					recovery_request(RECOVERY_REASON_HEALTH_FAULT);
 					fail_count = 0;
 				}
-			} else {
+			} else if (feed_due) {
 				fail_count = 0;
 			}
 		} else {
-			fail_count++;
-			const char *led_status = cfg.monitor_led ? (health.led_ok ? "ok" : "stale") : "disabled";
-			LOG_EVT(WRN, "HEALTH", "DEGRADED",
-				"fail=%u,led=%s,led_age_ms=%u,hb=%s,hb_age_ms=%u",
-				fail_count,
-				led_status,
-				cfg.monitor_led ? health.led_age : 0U,
-				health.hb_ok ? "ok" : "stale",
-				health.hb_age);
-
-			if (fail_count >= SUPERVISOR_MAX_FAILURES) {
+			if (!degraded) {
+				/* A heartbeat deadline expired: the stale threshold
+				 * already is the tolerance, so escalate now instead of
+				 * after more polls.
+				 */
+				degraded = true;
+				healthy_reported = false;
+				LOG_EVT(WRN, "HEALTH", "DEGRADED", "stale_mask=0x%08x",
+					health.stale_mask);
 				LOG_EVT_SIMPLE(ERR, "HEALTH", "RECOVERY_REQUEST");
-				recovery_request(RECOVERY_REASON_HEALTH_FAULT);
-				fail_count = 0;
+				recovery_report_task_fault(health.stale_mask);
+			}
+
+			/* An in-place recovery rung gets its bounded window; past it
+			 * the IWDG is left to fire as before.
+			 */
+			if (feed_due && watchdog_ctrl_is_enabled() && recovery_holds_watchdog() &&
+			    feed_watchdog("recovery", NULL)) {
+				note_feed(&plan, now);
 			}
 		}
 
-		k_msleep(SUPERVISOR_PERIOD_MS);
+		/* Sleep until the next feed slot, heartbeat expiry, end of boot
+		 * grace or pending retune, whichever comes first. While degraded
+		 * the feed cadence doubles as the re-check interval.
+		 */
+		int64_t wake_ts = plan.next_feed_ts;
+
+		if (in_boot_grace) {
+			wake_ts = MIN(wake_ts, grace_end_ts);
+		} else if (healthy) {
+			wake_ts = MIN(wake_ts, health.deadline);
+		}
+
+		if (rt.in_flight) {
+			wake_ts = MIN(wake_ts, rt.poll_ts);
+		} else if (rt.pending) {
+			wake_ts = MIN(wake_ts, rt.ready_ts);
+		}
+
+		(void)k_sem_take(&supervisor_wake, K_TIMEOUT_ABS_MS(wake_ts));
+#if defined(CONFIG_ZTEST)
+		(void)atomic_inc(&supervisor_wakeups);
+#endif
 	}
 }
 
 void supervisor_start(uint32_t steady_timeout_ms, uint32_t retune_delay_ms, bool monitor_led)
 {
 	supervisor_boot_ts = k_uptime_get();
-	watchdog_counter_cleared = false;
-	atomic_set(&sys_last_seen, k_uptime_get_32());
+	atomic_set(&task_last_seen[SUPERVISOR_TASK_SYSTEM], k_uptime_get_32());
 	if (!monitor_led) {
-		atomic_set(&led_last_seen, k_uptime_get_32());
+		atomic_set(&task_last_seen[SUPERVISOR_TASK_LED], k_uptime_get_32());
 	}
+	atomic_and(&task_monitored, ~(atomic_val_t)BIT_MASK(SUPERVISOR_TASK_BUILTIN));
+	atomic_or(&task_monitored, BIT(SUPERVISOR_TASK_SYSTEM) |
+				   (monitor_led ? BIT(SUPERVISOR_TASK_LED) : 0U));
 
 	k_mutex_lock(&cfg_lock, K_FOREVER);
-	wd_cfg.desired_timeout_ms = steady_timeout_ms;
-	wd_cfg.retune_delay_ms = retune_delay_ms;
-	wd_cfg.monitor_led = monitor_led;
-	wd_cfg.retune_done_once = false;
-	wd_cfg.retune_pending = true;
-	wd_cfg.retune_failed_logged = false;
-	update_retune_schedule_locked(false);
+	wd_req.retune_delay_ms = retune_delay_ms;
+	publish_request_locked(steady_timeout_ms, false);
 	k_mutex_unlock(&cfg_lock);
+	k_sem_reset(&supervisor_wake);
 
 	k_thread_create(&supervisor_tid, supervisor_stack,
 			K_THREAD_STACK_SIZEOF(supervisor_stack), supervisor_thread,
@@ -289,20 +692,18 @@ void supervisor_start(uint32_t steady_timeout_ms, uint32_t retune_delay_ms, bool
 int supervisor_request_watchdog_target(uint32_t timeout_ms, bool apply_immediately)
 {
 	k_mutex_lock(&cfg_lock, K_FOREVER);
-	wd_cfg.desired_timeout_ms = timeout_ms;
-	wd_cfg.retune_done_once = false;
-	watchdog_counter_cleared = false;
-	update_retune_schedule_locked(apply_immediately);
+	publish_request_locked(timeout_ms, apply_immediately);
 	k_mutex_unlock(&cfg_lock);
+	k_sem_give(&supervisor_wake);
 	return 0;
 }
 
 uint32_t supervisor_get_watchdog_target(void)
 {
-	k_mutex_lock(&cfg_lock, K_FOREVER);
-	uint32_t value = wd_cfg.desired_timeout_ms;
-	k_mutex_unlock(&cfg_lock);
-	return value;
+	struct watchdog_request req;
+
+	read_request(&req);
+	return req.desired_timeout_ms;
 }
 
 void supervisor_request_manual_recovery(void)
@@ -313,34 +714,55 @@ void supervisor_request_manual_recovery(void)
 #if defined(CONFIG_ZTEST)
 void supervisor_test_set_last_seen(uint32_t led_last, uint32_t hb_last)
 {
-	atomic_set(&led_last_seen, led_last);
-	atomic_set(&sys_last_seen, hb_last);
+	atomic_set(&task_last_seen[SUPERVISOR_TASK_LED], led_last);
+	atomic_set(&task_last_seen[SUPERVISOR_TASK_SYSTEM], hb_last);
 }
 
 struct supervisor_health_snapshot supervisor_test_sample(bool monitor_led,
 							 uint32_t now32)
 {
-	struct watchdog_cfg cfg = {
-		.desired_timeout_ms = 0U,
-		.retune_delay_ms = 0U,
-		.retune_ready_ts = 0,
-		.monitor_led = monitor_led,
-		.retune_pending = false,
-		.retune_done_once = false,
-		.retune_failed_logged = false,
-	};
-
-	struct health_status health = sample_health(&cfg, now32);
 	struct supervisor_health_snapshot snapshot = {
-		.led_ok = health.led_ok,
-		.hb_ok = health.hb_ok,
-		.led_age = health.led_age,
-		.hb_age = health.hb_age,
+		.led_ok = true,
+		.hb_ok = false,
+		.led_age = 0U,
+		.hb_age = task_age(SUPERVISOR_TASK_SYSTEM, now32),
 	};
 
+	snapshot.hb_ok = snapshot.hb_age <= tasks[SUPERVISOR_TASK_SYSTEM].stale_ms;
+	if (monitor_led) {
+		snapshot.led_age = task_age(SUPERVISOR_TASK_LED, now32);
+		snapshot.led_ok = snapshot.led_age <= tasks[SUPERVISOR_TASK_LED].stale_ms;
+	}
+
 	return snapshot;
 }
 
+uint32_t supervisor_test_wakeups(void)
+{
+	return (uint32_t)atomic_get(&supervisor_wakeups);
+}
+
+int supervisor_test_jitter(int handle, struct supervisor_jitter_snapshot *out)
+{
+#if IS_ENABLED(CONFIG_APP_HEALTH_JITTER_STATS)
+	if (handle < 0 || handle >= CONFIG_APP_SUPERVISOR_MAX_TASKS || out == NULL) {
+		return -EINVAL;
+	}
+
+	const struct log2_hist *hist = &task_jitter[handle];
+
+	out->samples = log2_hist_count(hist);
+	out->p50_ms = log2_hist_percentile(hist, 50U);
+	out->p99_ms = log2_hist_percentile(hist, 99U);
+	out->max_ms = log2_hist_max(hist);
+	return 0;
+#else
+	ARG_UNUSED(handle);
+	ARG_UNUSED(out);
+	return -ENOTSUP;
+#endif
+}
+
 void supervisor_test_reset(void)
 {
 	if (supervisor_thread_started) {
@@ -348,13 +770,26 @@ void supervisor_test_reset(void)
 		supervisor_thread_started = false;
 	}
 
-	atomic_set(&led_last_seen, 0);
-	atomic_set(&sys_last_seen, 0);
-	watchdog_counter_cleared = false;
+	for (size_t i = 0U; i < ARRAY_SIZE(task_last_seen); i++) {
+		atomic_set(&task_last_seen[i], 0);
+	}
+	atomic_set(&task_monitored, 0);
+	atomic_set(&task_checked_in, 0);
+	atomic_set(&task_min_stale_ms,
+		   MIN(CONFIG_APP_HEALTH_SYS_STALE_MS, CONFIG_APP_HEALTH_LED_STALE_MS));
+	atomic_set(&supervisor_wakeups, 0);
+#if IS_ENABLED(CONFIG_APP_HEALTH_JITTER_STATS)
+	for (size_t i = 0U; i < ARRAY_SIZE(task_jitter); i++) {
+		log2_hist_reset(&task_jitter[i]);
+	}
+#endif
+	k_sem_reset(&supervisor_wake);
 	supervisor_boot_ts = 0;
 
 	k_mutex_lock(&cfg_lock, K_FOREVER);
-	safe_memset(&wd_cfg, sizeof(wd_cfg), 0, sizeof(wd_cfg));
+	safe_memset(&wd_req, sizeof(wd_req), 0, sizeof(wd_req));
+	atomic_set(&wd_req_seq, 0);
+	task_count = SUPERVISOR_TASK_BUILTIN;
 	k_mutex_unlock(&cfg_lock);
 }
 #endif
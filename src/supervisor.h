@@ -4,13 +4,30 @@
 #include <stdbool.h>
 #include <stdint.h>
 
+/* Handles of the built-in heartbeats fed by supervisor_notify_*_alive(). */
+#define SUPERVISOR_HANDLE_SYSTEM 0
+#define SUPERVISOR_HANDLE_LED 1
+
 void supervisor_start(uint32_t steady_timeout_ms, uint32_t retune_delay_ms,
                       bool monitor_led);
 void supervisor_notify_led_alive(void);
 void supervisor_notify_system_alive(void);
+/* Heartbeat registry: returns a handle (>= 0) for supervisor_task_alive(),
+ * or -EINVAL / -ENOMEM. Handles are slot numbers assigned in registration
+ * order, which also keys the persisted fault counters, so register from
+ * deterministic init code. supervisor_task_alive() is ISR-safe.
+ */
+int supervisor_register_task(const char *name, uint32_t stale_ms);
+void supervisor_task_alive(int handle);
+/* ms since the task last checked in, or UINT32_MAX if the slot is not
+ * monitored. Lock-free; safe from ISRs.
+ */
+uint32_t supervisor_task_age_ms(int handle);
 int supervisor_request_watchdog_target(uint32_t timeout_ms, bool apply_immediately);
 uint32_t supervisor_get_watchdog_target(void);
 void supervisor_request_manual_recovery(void);
+/* EVT,HEALTH,JITTER per monitored task (CONFIG_APP_HEALTH_JITTER_STATS). */
+void supervisor_log_health_stats(void);
 
 #if defined(CONFIG_ZTEST)
 void supervisor_test_reset(void);
@@ -15,6 +15,17 @@ struct supervisor_health_snapshot {
 void supervisor_test_set_last_seen(uint32_t led_last, uint32_t hb_last);
 struct supervisor_health_snapshot supervisor_test_sample(bool monitor_led,
 							 uint32_t now32);
+uint32_t supervisor_test_wakeups(void);
+
+struct supervisor_jitter_snapshot {
+	uint32_t samples;
+	uint32_t p50_ms;
+	uint32_t p99_ms;
+	uint32_t max_ms;
+};
+
+/* -ENOTSUP without CONFIG_APP_HEALTH_JITTER_STATS. */
+int supervisor_test_jitter(int handle, struct supervisor_jitter_snapshot *out);
 #endif
 
 #endif /* SUPERVISOR_TEST_H */
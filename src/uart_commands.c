@@ -9,10 +9,18 @@
 #include <zephyr/drivers/uart.h>
 #include <zephyr/kernel.h>
 #include <zephyr/logging/log.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/sys/byteorder.h>
 
+#include "app_crypto.h"
+#include "event_log.h"
+#include "flight_recorder.h"
+#include "log_tx.h"
 #include "log_utils.h"
 #include "persist_state.h"
+#include "safe_memory.h"
 #include "supervisor.h"
+#include "uart_frame.h"
 #include "watchdog_ctrl.h"
 
 LOG_MODULE_REGISTER(uart_cmd, LOG_LEVEL_INF);
@@ -21,117 +29,94 @@ LOG_MODULE_REGISTER(uart_cmd, LOG_LEVEL_INF);
 
 #if IS_ENABLED(CONFIG_APP_PROVISION_BUILD)
 #define CMD_STACK_SIZE CONFIG_APP_PROVISION_CMD_STACK
-#define CMD_BUFFER_LEN CONFIG_APP_PROVISION_CMD_BUFFER
+#elif IS_ENABLED(CONFIG_APP_UART_FRAMES) && IS_ENABLED(CONFIG_APP_CRYPTO_BACKEND_CURVE25519)
+/* Read-public-key runs a scalar multiplication on this stack. */
+#define CMD_STACK_SIZE 1024
 #else
 #define CMD_STACK_SIZE 288
-#if IS_ENABLED(CONFIG_APP_CRYPTO_BACKEND_CURVE25519)
-/* prov curve <scalar> [peer] plus delimiters. */
-#define CMD_BUFFER_LEN (16 + (CURVE25519_KEY_SIZE * 4))
-#else
+#endif
+/* Longest buffered command, and a whole frame. prov curve lines are
+ * decoded as they arrive and never buffered.
+ */
 #define CMD_BUFFER_LEN 48
+#define CMD_THREAD_PRIORITY 9
+
+/* Tests point the CLI at an emulated UART; boards use the console. */
+#if DT_HAS_CHOSEN(app_command_uart)
+#define CMD_UART_NODE DT_CHOSEN(app_command_uart)
+#else
+#define CMD_UART_NODE DT_CHOSEN(zephyr_console)
 #endif
+
+#define RX_RING_SIZE CONFIG_APP_UART_RX_RING_SIZE
+
+BUILD_ASSERT(IS_POWER_OF_TWO(RX_RING_SIZE), "UART RX ring size must be a power of two");
+#if IS_ENABLED(CONFIG_APP_UART_FRAMES)
+BUILD_ASSERT(RX_RING_SIZE >= UART_FRAME_MAX_LEN, "UART RX ring must hold a whole frame");
+BUILD_ASSERT(CMD_BUFFER_LEN >= UART_FRAME_MAX_LEN, "command buffer must hold a whole frame");
 #endif
-#define CMD_THREAD_PRIORITY 9
 
 K_THREAD_STACK_DEFINE(cmd_stack, CMD_STACK_SIZE);
 static struct k_thread cmd_thread;
 static bool cmd_safe_mode_active;
 static const struct device *uart_dev;
 
-static const char *skip_spaces(const char *s);
+/* Single producer (the RX ISR) and single consumer (the command thread), so
+ * each index has one writer and no lock is needed. Indices run free and are
+ * masked on access. The ISR fills ahead of rx_head and only publishes whole
+ * lines, each stored with a single '\n' terminator, so the thread never sees
+ * a partial command.
+ */
+static uint8_t rx_ring[RX_RING_SIZE];
+static atomic_t rx_head; /* published end, written by the ISR */
+static atomic_t rx_tail; /* consumed end, written by the thread */
+static uint32_t rx_wr; /* ISR only: end of the line being received */
+static bool rx_discarding; /* ISR only: skipping the rest of an overrun line */
+static K_SEM_DEFINE(rx_line_sem, 0, 1);
+
+static atomic_t rx_bytes;
+static atomic_t rx_lines;
+static atomic_t rx_dropped;
+static atomic_t rx_overruns;
+
+#if IS_ENABLED(CONFIG_APP_UART_FRAMES)
+enum rx_frame_state {
+	RX_TEXT,
+	RX_FRAME_LEN,
+	RX_FRAME_BODY,
+};
+
+static enum rx_frame_state rx_state; /* ISR only */
+static uint32_t rx_frame_left; /* ISR only: body and CRC bytes still due */
+static uint32_t rx_frame_ms; /* ISR only: arrival of the previous frame byte */
+static bool rx_frame_dropping; /* ISR only: the frame overran the ring */
+static atomic_t rx_frames;
+#endif
 
 #if IS_ENABLED(CONFIG_APP_CRYPTO_BACKEND_CURVE25519)
-static char prov_accum[CMD_BUFFER_LEN];
-static size_t prov_accum_len;
-
-static void prov_accum_reset(void)
-{
-	prov_accum_len = 0U;
-	prov_accum[0] = '\0';
-}
-
-static void prov_accum_abort(void)
-{
-	if (prov_accum_len > 0U) {
-		LOG_EVT(WRN, "PROVISION", "INCOMPLETE_CHUNK",
-			"len=%zu,head=%.*s",
-			prov_accum_len,
-			(int)MIN(prov_accum_len, 16U),
-			prov_accum);
-		prov_accum_reset();
-	}
-}
-
-static void prov_accum_append(const char *chunk)
-{
-	if (prov_accum_len >= sizeof(prov_accum) - 1U) {
-		LOG_EVT(WRN, "PROVISION", "BUFFER_OVERFLOW", "len=%zu", prov_accum_len);
-		prov_accum_reset();
-		return;
-	}
-
-	if (prov_accum_len != 0U) {
-		prov_accum[prov_accum_len++] = ' ';
-	}
-
-	while (*chunk != '\0' && prov_accum_len < sizeof(prov_accum) - 1U) {
-		prov_accum[prov_accum_len++] = *chunk++;
-	}
-
-	if (*chunk != '\0') {
-		LOG_EVT(WRN, "PROVISION", "BUFFER_TRUNCATED", "");
-		prov_accum_len = sizeof(prov_accum) - 1U;
-	}
-
-	prov_accum[prov_accum_len] = '\0';
-	LOG_DBG("prov_accum len=%zu head=%.*s",
-		prov_accum_len,
-		(int)MIN(prov_accum_len, 32U),
-		prov_accum);
-}
-
-static bool prov_command_complete(const char *line)
-{
-	const char *cursor = skip_spaces(line);
-
-	if (strncmp(cursor, "prov", 4) != 0) {
-		return true;
-	}
-
-	cursor = skip_spaces(cursor + 4);
-	if (strncmp(cursor, "curve", 5) != 0) {
-		return true;
-	}
-
-	cursor = skip_spaces(cursor + 5);
-
-	size_t scalar_len = 0U;
-	while (cursor[scalar_len] != '\0' &&
-	       !isspace((unsigned char)cursor[scalar_len])) {
-		scalar_len++;
-	}
-
-	if (scalar_len < CURVE25519_KEY_SIZE * 2U) {
-		return false;
-	}
-
-	cursor = skip_spaces(cursor + scalar_len);
-	if (*cursor == '\0') {
-		return true;
-	}
-
-	size_t peer_len = 0U;
-	while (cursor[peer_len] != '\0' &&
-	       !isspace((unsigned char)cursor[peer_len])) {
-		peer_len++;
-	}
-
-	if (peer_len < CURVE25519_KEY_SIZE * 2U) {
-		return false;
-	}
-
-	return true;
-}
+/* prov curve <scalar> [peer] is parsed as it is popped from the RX ring:
+ * hex digits are decoded straight into key, so the line itself is never
+ * held. The scalar is persisted as soon as its token ends, then key is
+ * reused for the peer.
+ */
+enum prov_state {
+	PROV_IDLE,
+	PROV_TARGET,
+	PROV_SCALAR_GAP,
+	PROV_SCALAR,
+	PROV_PEER_GAP,
+	PROV_PEER,
+	PROV_TRAILING,
+	PROV_FAILED,
+};
+
+static struct {
+	enum prov_state state;
+	uint8_t key[CURVE25519_KEY_SIZE];
+	uint32_t digits; /* hex digits of the current token */
+	uint32_t scalar_len;
+	uint8_t matched; /* characters of "curve" seen */
+} prov;
 #endif
 
 static void print_status(void)
@@ -149,36 +134,68 @@ static void print_status(void)
 	if (consecutive != 0U) {
 		LOG_EVT(INF, "TELEMETRY", "WATCHDOG_RESETS", "count=%u", consecutive);
 	}
+
+	struct persist_state_stats stats;
+
+	persist_state_get_stats(&stats);
+	LOG_EVT(INF, "TELEMETRY", "PERSIST_WRITES",
+		"updates=%u,writes=%u,bytes=%u,fail=%u,last_us=%u,max_us=%u,total_us=%u",
+		stats.updates, stats.writes, stats.bytes_written, stats.write_failures,
+		stats.last_write_us, stats.max_write_us, stats.total_write_us);
+	LOG_EVT(INF, "TELEMETRY", "PERSIST_GC", "cycles=%u,deferred=%u,min_margin_ms=%d",
+		stats.gc_cycles, stats.gc_deferred,
+		(stats.gc_cycles != 0U) ? stats.gc_min_margin_ms : 0);
+
+	struct uart_commands_rx_stats rx;
+
+	uart_commands_get_rx_stats(&rx);
+	LOG_EVT(INF, "TELEMETRY", "UART_RX", "bytes=%u,lines=%u,frames=%u,dropped=%u,overruns=%u",
+		rx.bytes, rx.lines, rx.frames, rx.dropped, rx.overruns);
+
+#if IS_ENABLED(CONFIG_APP_LOG_TX)
+	struct log_tx_stats tx;
+
+	log_tx_get_stats(&tx);
+	LOG_EVT(INF, "TELEMETRY", "LOG_TX",
+		"msgs=%u,bytes=%u,dropped_msgs=%u,dropped_bytes=%u,max_fill=%u,congested=%u,"
+		"truncated=%u",
+		tx.msgs, tx.bytes, tx.dropped_msgs, tx.dropped_bytes, tx.max_fill,
+		tx.congested, tx.truncated);
+#endif
 }
 
-static void apply_timeout(uint32_t timeout_ms)
+static int apply_timeout(uint32_t timeout_ms)
 {
 	if (timeout_ms < 100U || timeout_ms > 60000U) {
 		LOG_WRN("Timeout %u ms out of range (100-60000)", timeout_ms);
-		return;
+		return -EINVAL;
 	}
 
 	int rc = persist_state_set_watchdog_override(timeout_ms);
 	if (rc < 0) {
 		LOG_ERR("Failed to persist watchdog override: %d", rc);
-		return;
+		return rc;
 	}
 
 	supervisor_request_watchdog_target(timeout_ms, true);
 	LOG_EVT(INF, "WATCHDOG", "OVERRIDE_SET", "timeout_ms=%u", timeout_ms);
+	event_log_append(EVENT_LOG_WATCHDOG_OVERRIDE, timeout_ms);
+	return 0;
 }
 
-static void clear_override(void)
+static int clear_override(void)
 {
 	int rc = persist_state_set_watchdog_override(0U);
 	if (rc < 0) {
 		LOG_ERR("Failed to clear watchdog override: %d", rc);
-		return;
+		return rc;
 	}
 
 	supervisor_request_watchdog_target(CONFIG_APP_WATCHDOG_STEADY_TIMEOUT_MS, true);
 	LOG_EVT(INF, "WATCHDOG", "OVERRIDE_CLEARED",
 		"steady_ms=%u", CONFIG_APP_WATCHDOG_STEADY_TIMEOUT_MS);
+	event_log_append(EVENT_LOG_WATCHDOG_OVERRIDE, 0U);
+	return 0;
 }
 
 #if IS_ENABLED(CONFIG_APP_CRYPTO_BACKEND_CURVE25519)
@@ -196,100 +213,335 @@ static int hex_value_cli(char c)
 	return -1;
 }
 
-static int decode_hex_token(const char *token, size_t len,
-			    uint8_t *out, size_t out_len)
+/* True once the line so far reads "prov" and a blank, leading blanks
+ * allowed: the rest of it goes to prov_feed() instead of the line buffer.
+ */
+static bool prov_line_started(const char *line, size_t len)
 {
-	if (token == NULL || len != (out_len * 2U)) {
-		return -EINVAL;
+	while (len > 0U && isspace((unsigned char)*line)) {
+		line++;
+		len--;
 	}
 
-	for (size_t i = 0U; i < out_len; i++) {
-		int hi = hex_value_cli(token[i * 2U]);
-		int lo = hex_value_cli(token[i * 2U + 1U]);
+	return len == 5U && strncmp(line, "prov", 4) == 0 && isspace((unsigned char)line[4]);
+}
 
-		if (hi < 0 || lo < 0) {
-			return -EINVAL;
+static void prov_fail(void)
+{
+	prov.state = PROV_FAILED;
+	safe_memset(prov.key, sizeof(prov.key), 0, sizeof(prov.key));
+}
+
+static void prov_begin(void)
+{
+	prov.state = PROV_TARGET;
+	prov.digits = 0U;
+	prov.scalar_len = 0U;
+	prov.matched = 0U;
+}
+
+/* A hex token has ended: persist it if it is a whole key. */
+static void prov_token_end(void)
+{
+	bool peer = (prov.state == PROV_PEER);
+	uint32_t digits = prov.digits;
+
+	if (!peer) {
+		prov.scalar_len = digits;
+	}
+	prov.digits = 0U;
+
+	if (digits != CURVE25519_KEY_SIZE * 2U) {
+		if (peer) {
+			LOG_EVT(WRN, "PROVISION", "PEER_LEN_BAD", "len=%u", digits);
+		} else {
+			LOG_EVT(WRN, "PROVISION", "SCALAR_PARSE_FAIL", "len=%u", digits);
 		}
+		prov_fail();
+		return;
+	}
+
+	int rc = peer ? persist_state_curve25519_set_peer(prov.key)
+		      : persist_state_curve25519_set_secret(prov.key);
 
-		out[i] = (uint8_t)((hi << 4) | lo);
+	safe_memset(prov.key, sizeof(prov.key), 0, sizeof(prov.key));
+	if (rc != 0) {
+		LOG_ERR("Failed to persist Curve25519 %s: %d", peer ? "peer key" : "scalar", rc);
+		prov_fail();
+		return;
 	}
 
-	return 0;
+	prov.state = peer ? PROV_TRAILING : PROV_PEER_GAP;
 }
 
-static const char *skip_spaces(const char *s)
+static void prov_feed(char c)
 {
-	while (*s != '\0' && isspace((unsigned char)*s)) {
-		s++;
+	bool blank = isspace((unsigned char)c);
+
+	if (!blank && prov.state == PROV_SCALAR_GAP) {
+		prov.state = PROV_SCALAR;
+	} else if (!blank && prov.state == PROV_PEER_GAP) {
+		prov.state = PROV_PEER;
+	}
+
+	switch (prov.state) {
+	case PROV_TARGET:
+		if (blank && prov.matched == 0U) {
+			break;
+		}
+		if (prov.matched < 5U && c == "curve"[prov.matched]) {
+			prov.matched++;
+		} else if (prov.matched == 5U && blank) {
+			prov.state = PROV_SCALAR_GAP;
+		} else {
+			LOG_EVT(WRN, "PROVISION", "UNKNOWN_TARGET", "at=%u", prov.matched);
+			prov_fail();
+		}
+		break;
+	case PROV_SCALAR:
+	case PROV_PEER: {
+		if (blank) {
+			prov_token_end();
+			break;
+		}
+
+		int v = hex_value_cli(c);
+
+		if (v < 0 || prov.digits >= CURVE25519_KEY_SIZE * 2U) {
+			/* Count on so the length in the event is the token's. */
+			prov.digits++;
+			if (v < 0 && prov.state == PROV_PEER) {
+				LOG_EVT(WRN, "PROVISION", "PEER_PARSE_FAIL", "at=%u", prov.digits - 1U);
+				prov_fail();
+			} else if (v < 0) {
+				LOG_EVT(WRN, "PROVISION", "SCALAR_PARSE_FAIL", "at=%u", prov.digits - 1U);
+				prov_fail();
+			}
+			break;
+		}
+
+		uint8_t *byte = &prov.key[prov.digits / 2U];
+
+		*byte = ((prov.digits & 1U) == 0U) ? (uint8_t)(v << 4) : (uint8_t)(*byte | v);
+		prov.digits++;
+		break;
+	}
+	default:
+		/* Anything after the peer is ignored, as is the rest of a failed line. */
+		break;
 	}
-	return s;
 }
 
-static void handle_provision_command(const char *args)
+/* End of line: a pending token ends here too. */
+static void prov_end(void)
 {
-	args = skip_spaces(args);
-	if (strncmp(args, "curve", 5) != 0) {
-		LOG_EVT(WRN, "PROVISION", "UNKNOWN_TARGET", "body=%s", args);
-		return;
+	switch (prov.state) {
+	case PROV_TARGET:
+		if (prov.matched == 5U) {
+			LOG_EVT(WRN, "PROVISION", "MISSING_SCALAR", "");
+		} else {
+			LOG_EVT(WRN, "PROVISION", "UNKNOWN_TARGET", "at=%u", prov.matched);
+		}
+		break;
+	case PROV_SCALAR_GAP:
+		LOG_EVT(WRN, "PROVISION", "MISSING_SCALAR", "");
+		break;
+	case PROV_SCALAR:
+	case PROV_PEER:
+		prov_token_end();
+		break;
+	default:
+		break;
 	}
 
-	args = skip_spaces(args + 5);
-	if (*args == '\0') {
-		LOG_EVT(WRN, "PROVISION", "MISSING_SCALAR", "");
-		return;
+	if (prov.state == PROV_PEER_GAP || prov.state == PROV_TRAILING) {
+		LOG_EVT(INF, "PROVISION", "CURVE25519_UPDATED", "scalar_len=%u,peer_updated=%s",
+			prov.scalar_len, (prov.state == PROV_TRAILING) ? "yes" : "no");
+		LOG_INF("Reboot the board to load the new Curve25519 material");
 	}
 
-	const char *scalar_tok = args;
-	size_t scalar_len = 0U;
-	while (args[scalar_len] != '\0' && !isspace((unsigned char)args[scalar_len])) {
-		scalar_len++;
+	safe_memset(prov.key, sizeof(prov.key), 0, sizeof(prov.key));
+	prov.state = PROV_IDLE;
+}
+#endif
+
+/* Thread only. Reads a byte and clears its slot before the slot is handed
+ * back, so key material does not linger in rx_ring.
+ */
+static uint8_t rx_take(uint32_t pos)
+{
+	uint8_t *slot = &rx_ring[pos & (RX_RING_SIZE - 1U)];
+	uint8_t ch = *slot;
+
+	safe_memset(slot, 1U, 0, 1U);
+	return ch;
+}
+
+#if IS_ENABLED(CONFIG_APP_UART_FRAMES)
+static uint8_t frame_set_key(const struct uart_frame *req)
+{
+	bool peer = (req->op == UART_FRAME_OP_SET_PEER);
+
+	if (req->len != CURVE25519_KEY_SIZE) {
+		return UART_FRAME_BAD_LEN;
 	}
 
-	args = skip_spaces(args + scalar_len);
-	const char *peer_tok = NULL;
-	size_t peer_len = 0U;
-	if (*args != '\0') {
-		peer_tok = args;
-		while (args[peer_len] != '\0' && !isspace((unsigned char)args[peer_len])) {
-			peer_len++;
-		}
+	int rc = peer ? persist_state_curve25519_set_peer(req->payload)
+		      : persist_state_curve25519_set_secret(req->payload);
+
+	if (rc == -ENOTSUP) {
+		return UART_FRAME_UNSUPPORTED;
+	}
+	if (rc != 0) {
+		LOG_ERR("Failed to persist Curve25519 %s: %d", peer ? "peer key" : "scalar", rc);
+		return UART_FRAME_STORE_FAILED;
 	}
 
-	LOG_EVT(INF, "PROVISION", "CURVE_CMD_RX",
-		"scalar_len=%zu,peer_len=%zu,raw=%.*s",
-		scalar_len, peer_len, (int)(scalar_len + (peer_tok ? peer_len + 1U : 0U)), scalar_tok);
+	LOG_EVT(INF, "PROVISION", "CURVE25519_UPDATED", "peer_updated=%s", peer ? "yes" : "no");
+	return UART_FRAME_OK;
+}
 
-	uint8_t buffer[CURVE25519_KEY_SIZE];
-	if (decode_hex_token(scalar_tok, scalar_len, buffer, CURVE25519_KEY_SIZE) != 0) {
-		LOG_EVT(WRN, "PROVISION", "SCALAR_PARSE_FAIL", "len=%zu", scalar_len);
-		return;
+static uint8_t frame_read_pubkey(const struct uart_frame *req, uint8_t *out, size_t *out_len)
+{
+	if (req->len != 0U) {
+		return UART_FRAME_BAD_LEN;
 	}
 
-	int rc = persist_state_curve25519_set_secret(buffer);
+#if IS_ENABLED(CONFIG_APP_CRYPTO_BACKEND_CURVE25519)
+	uint8_t secret[CURVE25519_KEY_SIZE];
+	int rc = persist_state_curve25519_get_secret(secret);
+
 	if (rc != 0) {
-		LOG_ERR("Failed to persist Curve25519 scalar: %d", rc);
-		return;
+		LOG_ERR("Failed to load Curve25519 scalar: %d", rc);
+		return UART_FRAME_STORE_FAILED;
 	}
 
-	if (peer_tok != NULL) {
-		if (peer_len != CURVE25519_KEY_SIZE * 2U) {
-			LOG_EVT(WRN, "PROVISION", "PEER_LEN_BAD", "len=%zu", peer_len);
-			return;
-		}
-		if (decode_hex_token(peer_tok, peer_len, buffer, CURVE25519_KEY_SIZE) != 0) {
-			LOG_EVT(WRN, "PROVISION", "PEER_PARSE_FAIL", "");
-			return;
-		}
-		rc = persist_state_curve25519_set_peer(buffer);
+	curve25519_ref10_scalarmult_base(out, secret);
+	safe_memset(secret, sizeof(secret), 0, sizeof(secret));
+	*out_len = CURVE25519_KEY_SIZE;
+	return UART_FRAME_OK;
+#else
+	ARG_UNUSED(out);
+	ARG_UNUSED(out_len);
+	return UART_FRAME_UNSUPPORTED;
+#endif
+}
+
+static uint8_t frame_set_override(const struct uart_frame *req)
+{
+	if (req->len != sizeof(uint32_t)) {
+		return UART_FRAME_BAD_LEN;
+	}
+
+	uint32_t timeout_ms = sys_get_le32(req->payload);
+	int rc = (timeout_ms == 0U) ? clear_override() : apply_timeout(timeout_ms);
+
+	if (rc == -EINVAL) {
+		return UART_FRAME_BAD_ARG;
+	}
+	return (rc == 0) ? UART_FRAME_OK : UART_FRAME_STORE_FAILED;
+}
+
+/* out holds CURVE25519_KEY_SIZE bytes. */
+static uint8_t frame_dispatch(const struct uart_frame *req, uint8_t *out, size_t *out_len)
+{
+	switch (req->op) {
+	case UART_FRAME_OP_PING:
+		out[0] = UART_FRAME_VERSION;
+		out[1] = UART_FRAME_MAX_BODY;
+		*out_len = 2U;
+		return UART_FRAME_OK;
+	case UART_FRAME_OP_SET_SECRET:
+	case UART_FRAME_OP_SET_PEER:
+		return frame_set_key(req);
+	case UART_FRAME_OP_READ_PUBKEY:
+		return frame_read_pubkey(req, out, out_len);
+	case UART_FRAME_OP_SET_OVERRIDE:
+		return frame_set_override(req);
+	default:
+		return UART_FRAME_UNKNOWN_OP;
+	}
+}
+
+static void frame_send(const uint8_t *frame, size_t len)
+{
+	/* The buffered log backend queues the frame in one piece between two
+	 * log messages; wait a little for room rather than lose the answer.
+	 */
+	int rc = log_tx_write(uart_dev, frame, len);
+
+	for (int i = 0; rc == -ENOSPC && i < 50; i++) {
+		k_msleep(1);
+		rc = log_tx_write(uart_dev, frame, len);
+	}
+	if (rc != -ENODEV) {
 		if (rc != 0) {
-			LOG_ERR("Failed to persist Curve25519 peer key: %d", rc);
-			return;
+			LOG_EVT(WRN, "UART_CMD", "FRAME_TX_DROPPED", "rc=%d", rc);
+		}
+		return;
+	}
+
+	/* Written directly: keeps other threads' log lines out of the frame.
+	 * A line logged from an ISR can still cut in; the host drops the frame
+	 * on its CRC and retries.
+	 */
+	k_sched_lock();
+	for (size_t i = 0U; i < len; i++) {
+		uart_poll_out(uart_dev, frame[i]);
+	}
+	k_sched_unlock();
+}
+
+static void handle_frame(const uint8_t *frame, size_t len)
+{
+	struct uart_frame req;
+	uint8_t payload[CURVE25519_KEY_SIZE];
+	size_t payload_len = 0U;
+	uint8_t status;
+	int rc = uart_frame_decode(frame, len, &req);
+
+	if (rc == -EBADMSG) {
+		status = UART_FRAME_BAD_CRC;
+	} else if (rc != 0) {
+		status = UART_FRAME_BAD_LEN;
+	} else {
+		status = frame_dispatch(&req, payload, &payload_len);
+	}
+
+	if (status != UART_FRAME_OK) {
+		payload_len = 0U;
+	}
+	LOG_EVT(INF, "UART_CMD", "FRAME", "op=0x%02x,seq=%u,status=%u", req.op, req.seq,
+		status);
+
+	uint8_t resp[UART_FRAME_HDR_LEN + UART_FRAME_MIN_BODY + 1U + sizeof(payload) +
+		     UART_FRAME_CRC_LEN];
+
+	frame_send(resp, uart_frame_encode_response(req.op, req.seq, status, payload,
+						    payload_len, resp, sizeof(resp)));
+}
+
+/* The ISR publishes SOF and LEN, plus body and CRC when LEN is valid.
+ * Frames may carry keys: the ring span and the copy are wiped after use.
+ */
+static uint32_t take_frame(uint32_t tail, uint8_t *frame, size_t frame_size)
+{
+	size_t len = 0U;
+
+	frame[len++] = UART_FRAME_SOF;
+	frame[len++] = rx_take(tail++);
+	if (uart_frame_body_len_valid(frame[1])) {
+		size_t end = len + frame[1] + UART_FRAME_CRC_LEN;
+
+		while (len < end) {
+			frame[len++] = rx_take(tail++);
 		}
 	}
 
-	LOG_EVT(INF, "PROVISION", "CURVE25519_UPDATED",
-		"peer_updated=%s", peer_tok ? "yes" : "no");
-	LOG_INF("Reboot the board to load the new Curve25519 material");
+	atomic_set(&rx_tail, (atomic_val_t)tail);
+	handle_frame(frame, len);
+	safe_memset(frame, frame_size, 0, len);
+	return tail;
 }
 #endif
 
@@ -312,12 +564,6 @@ static void handle_line(const char *line)
 		return;
 	}
 
-#if IS_ENABLED(CONFIG_APP_CRYPTO_BACKEND_CURVE25519)
-	if (prov_accum_len > 0U && strncmp(line, "prov", 4) != 0) {
-		prov_accum_abort();
-	}
-#endif
-
     if (strncmp(line, "wdg", 3) == 0) {
         line += 3;
 		while (isspace((unsigned char)*line)) {
@@ -330,7 +576,7 @@ static void handle_line(const char *line)
 		}
 
 		if (strncmp(line, "clear", 5) == 0) {
-			clear_override();
+			(void)clear_override();
 			return;
 		}
 
@@ -347,34 +593,211 @@ static void handle_line(const char *line)
 			return;
 		}
 
-		apply_timeout((uint32_t)val);
+		(void)apply_timeout((uint32_t)val);
 		return;
 	}
 
-#if IS_ENABLED(CONFIG_APP_CRYPTO_BACKEND_CURVE25519)
-	if (strncmp(line, "prov", 4) == 0) {
-		prov_accum_reset();
-		prov_accum_append(line);
-		if (prov_command_complete(prov_accum)) {
-			handle_provision_command(prov_accum + 4);
-			prov_accum_reset();
+#if IS_ENABLED(CONFIG_APP_PERSIST_WEAR_TELEMETRY)
+	if (strncmp(line, "persist?", 8) == 0) {
+		persist_state_log_wear();
+		return;
+	}
+#endif
+
+#if IS_ENABLED(CONFIG_APP_HEALTH_JITTER_STATS)
+	if (strncmp(line, "health", 6) == 0) {
+		const char *args = line + 6;
+
+		while (isspace((unsigned char)*args)) {
+			args++;
+		}
+		if (strncmp(args, "stats", 5) == 0) {
+			supervisor_log_health_stats();
+			return;
 		}
+	}
+#endif
+
+#if IS_ENABLED(CONFIG_APP_FLIGHT_RECORDER)
+	if (strncmp(line, "flight?", 7) == 0) {
+		flight_recorder_dump();
 		return;
 	}
+#endif
 
-	if (prov_accum_len > 0U) {
-		prov_accum_append(line);
-		if (prov_command_complete(prov_accum)) {
-			handle_provision_command(prov_accum + 4);
-			prov_accum_reset();
+#if IS_ENABLED(CONFIG_APP_EVENT_LOG)
+	if (strncmp(line, "evlog?", 6) == 0) {
+		event_log_dump();
+		return;
+	}
+#endif
+
+#if IS_ENABLED(CONFIG_APP_CRYPTO_REKEY)
+	if (strncmp(line, "rekey", 5) == 0) {
+		int rc = app_crypto_request_rekey();
+		if (rc != 0) {
+			LOG_EVT(WRN, "UART_CMD", "REKEY_REJECTED", "rc=%d", rc);
+		} else {
+			LOG_EVT_SIMPLE(INF, "UART_CMD", "REKEY_QUEUED");
 		}
 		return;
 	}
 #endif
 
+#if IS_ENABLED(CONFIG_APP_CRYPTO_BACKEND_CURVE25519)
+	if (strcmp(line, "prov") == 0) {
+		/* "prov <args>" never gets here, see prov_line_started(). */
+		LOG_EVT(WRN, "PROVISION", "UNKNOWN_TARGET", "at=0");
+		return;
+	}
+#endif
+
 	LOG_EVT(WRN, "UART_CMD", "UNKNOWN", "cmd=%s", line);
 }
 
+/* ISR only. False when the ring is full. */
+static bool rx_put(uint8_t ch)
+{
+	if (rx_wr - (uint32_t)atomic_get(&rx_tail) >= RX_RING_SIZE) {
+		return false;
+	}
+
+	rx_ring[rx_wr & (RX_RING_SIZE - 1U)] = ch;
+	rx_wr++;
+	return true;
+}
+
+static void rx_publish(atomic_t *count)
+{
+	atomic_set(&rx_head, (atomic_val_t)rx_wr);
+	atomic_inc(count);
+	k_sem_give(&rx_line_sem);
+}
+
+#if IS_ENABLED(CONFIG_APP_UART_FRAMES)
+/* ISR only. Frames are stored raw from SOF on and published once the CRC
+ * has arrived; the thread checks it. Returns false for text bytes.
+ */
+static bool rx_store_frame(uint8_t ch)
+{
+	uint32_t head = (uint32_t)atomic_get(&rx_head);
+	uint32_t now = k_uptime_get_32();
+
+	if (rx_state != RX_TEXT && now - rx_frame_ms > UART_FRAME_GAP_MS) {
+		/* The sender stalled mid-frame: forget it and resync on SOF. */
+		if (!rx_frame_dropping) {
+			atomic_add(&rx_dropped, (atomic_val_t)(rx_wr - head));
+		}
+		rx_wr = head;
+		rx_state = RX_TEXT;
+	}
+
+	switch (rx_state) {
+	case RX_TEXT:
+		if (ch != UART_FRAME_SOF) {
+			return false;
+		}
+		/* SOF never occurs in text, so a partial line before it is noise. */
+		atomic_add(&rx_dropped, (atomic_val_t)(rx_wr - head));
+		rx_wr = head;
+		rx_discarding = false;
+		rx_frame_dropping = false;
+		rx_state = RX_FRAME_LEN;
+		break;
+	case RX_FRAME_LEN:
+		/* A bad length is still published so the thread can NAK it. */
+		rx_frame_left = ch + UART_FRAME_CRC_LEN;
+		rx_state = uart_frame_body_len_valid(ch) ? RX_FRAME_BODY : RX_TEXT;
+		break;
+	case RX_FRAME_BODY:
+		if (--rx_frame_left == 0U) {
+			rx_state = RX_TEXT;
+		}
+		break;
+	}
+	rx_frame_ms = now;
+
+	if (!rx_frame_dropping && !rx_put(ch)) {
+		/* Drop the whole frame, as for lines. */
+		atomic_add(&rx_dropped, (atomic_val_t)(rx_wr - head));
+		atomic_inc(&rx_overruns);
+		rx_wr = head;
+		rx_frame_dropping = true;
+	}
+
+	if (rx_frame_dropping) {
+		atomic_inc(&rx_dropped);
+	} else if (rx_state == RX_TEXT) {
+		rx_publish(&rx_frames);
+	}
+	return true;
+}
+#endif
+
+static void rx_store(uint8_t ch)
+{
+#if IS_ENABLED(CONFIG_APP_UART_FRAMES)
+	if (rx_store_frame(ch)) {
+		return;
+	}
+#endif
+
+	uint32_t head = (uint32_t)atomic_get(&rx_head);
+	bool eol = (ch == '\r') || (ch == '\n');
+
+	if (rx_discarding) {
+		atomic_inc(&rx_dropped);
+		rx_discarding = !eol;
+		return;
+	}
+
+	if (eol) {
+		if (rx_wr == head) {
+			/* Blank line, or the second half of CR LF. */
+			return;
+		}
+		ch = '\n';
+	}
+
+	if (!rx_put(ch)) {
+		/* Drop the whole line: a command missing some of its bytes can
+		 * still parse (wdg 1500 -> wdg 150).
+		 */
+		atomic_add(&rx_dropped, (atomic_val_t)(rx_wr - head + 1U));
+		atomic_inc(&rx_overruns);
+		rx_wr = head;
+		rx_discarding = !eol;
+		return;
+	}
+
+	if (eol) {
+		rx_publish(&rx_lines);
+	}
+}
+
+static void rx_isr(const struct device *dev, void *user_data)
+{
+	ARG_UNUSED(user_data);
+
+	if (!uart_irq_update(dev)) {
+		return;
+	}
+
+	while (uart_irq_rx_ready(dev)) {
+		uint8_t chunk[8];
+		int n = uart_fifo_read(dev, chunk, sizeof(chunk));
+
+		if (n <= 0) {
+			break;
+		}
+
+		atomic_add(&rx_bytes, n);
+		for (int i = 0; i < n; i++) {
+			rx_store(chunk[i]);
+		}
+	}
+}
+
 static void command_thread(void *p1, void *p2, void *p3)
 {
 	ARG_UNUSED(p1);
@@ -390,46 +813,97 @@ static void command_thread(void *p1, void *p2, void *p3)
 		"fallback=%s", cmd_safe_mode_active ? "yes" : "no");
 
 	while (1) {
-		uint8_t ch;
-		int rc = uart_poll_in(uart_dev, &ch);
-		if (rc != 0) {
-			k_sleep(K_MSEC(20));
-			continue;
-		}
+		(void)k_sem_take(&rx_line_sem, K_FOREVER);
+
+		uint32_t head = (uint32_t)atomic_get(&rx_head);
+		uint32_t tail = (uint32_t)atomic_get(&rx_tail);
 
-		LOG_DBG("uart_cmd ch=0x%02x (%c)",
-			ch, isprint(ch) ? ch : '.');
-		if (ch == '\r' || ch == '\n') {
-			if (len > 0U) {
+		while (tail != head) {
+			uint8_t ch = rx_take(tail);
+
+			tail++;
+#if IS_ENABLED(CONFIG_APP_UART_FRAMES)
+			if (len == 0U && ch == UART_FRAME_SOF) {
+				tail = take_frame(tail, (uint8_t *)buffer, sizeof(buffer));
+				continue;
+			}
+#endif
+#if IS_ENABLED(CONFIG_APP_CRYPTO_BACKEND_CURVE25519)
+			if (prov.state != PROV_IDLE) {
+				/* Key material: not buffered, not echoed. */
+				atomic_set(&rx_tail, (atomic_val_t)tail);
+				if (ch == '\n') {
+					prov_end();
+				} else {
+					prov_feed((char)ch);
+				}
+				continue;
+			}
+#endif
+			LOG_DBG("uart_cmd ch=0x%02x (%c)",
+				ch, isprint(ch) ? ch : '.');
+			if (ch == '\n') {
 				buffer[len] = '\0';
+				/* Hand the space back before parsing: commands may block. */
+				atomic_set(&rx_tail, (atomic_val_t)tail);
 				handle_line(buffer);
 				len = 0U;
+				continue;
 			}
-			continue;
-		}
 
-		if (len < sizeof(buffer) - 1U) {
-			buffer[len++] = (char)ch;
+			if (len < sizeof(buffer) - 1U) {
+				buffer[len++] = (char)ch;
+			}
+#if IS_ENABLED(CONFIG_APP_CRYPTO_BACKEND_CURVE25519)
+			if (prov_line_started(buffer, len)) {
+				prov_begin();
+				len = 0U;
+			}
+#endif
 		}
 	}
 }
 
+void uart_commands_get_rx_stats(struct uart_commands_rx_stats *out)
+{
+	out->bytes = (uint32_t)atomic_get(&rx_bytes);
+	out->lines = (uint32_t)atomic_get(&rx_lines);
+	out->dropped = (uint32_t)atomic_get(&rx_dropped);
+	out->overruns = (uint32_t)atomic_get(&rx_overruns);
+#if IS_ENABLED(CONFIG_APP_UART_FRAMES)
+	out->frames = (uint32_t)atomic_get(&rx_frames);
+#else
+	out->frames = 0U;
+#endif
+}
+
 void uart_commands_start(bool safe_mode_active)
 {
 	cmd_safe_mode_active = safe_mode_active;
 
-	uart_dev = DEVICE_DT_GET(DT_CHOSEN(zephyr_console));
+	uart_dev = DEVICE_DT_GET(CMD_UART_NODE);
 	if (!device_is_ready(uart_dev)) {
 		LOG_ERR("Console UART not ready; disabling command handler");
 		return;
 	}
 
+	/* The log backend may already own this UART's interrupt. */
+	int rc = log_tx_attach_rx(uart_dev, rx_isr);
+	if (rc == -ENODEV) {
+		rc = uart_irq_callback_user_data_set(uart_dev, rx_isr, NULL);
+	}
+	if (rc != 0) {
+		LOG_ERR("UART RX interrupt unavailable (%d); disabling command handler", rc);
+		return;
+	}
+
 	LOG_INF("uart_cmd thread starting (safe_mode=%s)",
 		cmd_safe_mode_active ? "yes" : "no");
 
 	k_thread_create(&cmd_thread, cmd_stack, K_THREAD_STACK_SIZEOF(cmd_stack),
 			command_thread, NULL, NULL, NULL, CMD_THREAD_PRIORITY, 0,
 			K_NO_WAIT);
+	uart_irq_rx_enable(uart_dev);
 }
 
 #else /* CONFIG_APP_ENABLE_UART_COMMANDS */
@@ -439,4 +913,9 @@ void uart_commands_start(bool safe_mode_active)
 	ARG_UNUSED(safe_mode_active);
 }
 
+void uart_commands_get_rx_stats(struct uart_commands_rx_stats *out)
+{
+	*out = (struct uart_commands_rx_stats){ 0 };
+}
+
 #endif
@@ -2,7 +2,18 @@
 #define UART_COMMANDS_H
 
 #include <stdbool.h>
+#include <stdint.h>
+
+/* Receive counters since boot. */
+struct uart_commands_rx_stats {
+	uint32_t bytes; /* read from the UART, dropped ones included */
+	uint32_t lines; /* complete lines handed to the parser */
+	uint32_t frames; /* binary frames handed to the parser, CRC unchecked */
+	uint32_t dropped; /* bytes discarded: RX ring full or stale partial input */
+	uint32_t overruns; /* lines or frames lost to a full RX ring */
+};
 
 void uart_commands_start(bool safe_mode_active);
+void uart_commands_get_rx_stats(struct uart_commands_rx_stats *out);
 
 #endif /* UART_COMMANDS_H */
@@ -0,0 +1,62 @@
+#include "uart_frame.h"
+
+#include <errno.h>
+#include <string.h>
+
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/sys/crc.h>
+
+static uint16_t frame_crc(const uint8_t *buf)
+{
+	/* buf[1] is LEN; the CRC covers it and the body. */
+	return crc16_itu_t(0U, &buf[1], 1U + buf[1]);
+}
+
+int uart_frame_decode(const uint8_t *buf, size_t len, struct uart_frame *out)
+{
+	*out = (struct uart_frame){ 0 };
+
+	if (len < UART_FRAME_HDR_LEN || buf[0] != UART_FRAME_SOF) {
+		return -EMSGSIZE;
+	}
+
+	uint8_t body_len = buf[1];
+
+	if (!uart_frame_body_len_valid(body_len) ||
+	    len != UART_FRAME_HDR_LEN + body_len + UART_FRAME_CRC_LEN) {
+		return -EMSGSIZE;
+	}
+
+	out->op = buf[2];
+	out->seq = buf[3];
+	if (sys_get_le16(&buf[UART_FRAME_HDR_LEN + body_len]) != frame_crc(buf)) {
+		return -EBADMSG;
+	}
+
+	out->len = body_len - UART_FRAME_MIN_BODY;
+	out->payload = &buf[UART_FRAME_HDR_LEN + UART_FRAME_MIN_BODY];
+	return 0;
+}
+
+size_t uart_frame_encode_response(uint8_t op, uint8_t seq, uint8_t status,
+				  const uint8_t *payload, size_t payload_len,
+				  uint8_t *out, size_t out_size)
+{
+	size_t body_len = UART_FRAME_MIN_BODY + 1U + payload_len;
+	size_t total = UART_FRAME_HDR_LEN + body_len + UART_FRAME_CRC_LEN;
+
+	if (body_len > UART_FRAME_MAX_BODY || total > out_size) {
+		return 0U;
+	}
+
+	out[0] = UART_FRAME_SOF;
+	out[1] = (uint8_t)body_len;
+	out[2] = op | UART_FRAME_RESPONSE;
+	out[3] = seq;
+	out[4] = status;
+	if (payload_len != 0U) {
+		memcpy(&out[5], payload, payload_len);
+	}
+	sys_put_le16(frame_crc(out), &out[UART_FRAME_HDR_LEN + body_len]);
+	return total;
+}
@@ -0,0 +1,73 @@
+#ifndef UART_FRAME_H
+#define UART_FRAME_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* Binary command frames on the CLI UART (CONFIG_APP_UART_FRAMES):
+ *
+ *   SOF | LEN | OP | SEQ | payload | CRC16 (LE)
+ *
+ * LEN counts OP, SEQ and the payload. The CRC is CRC-16/XMODEM
+ * (crc16_itu_t, seed 0) over LEN through the end of the payload. A
+ * response echoes SEQ, sets UART_FRAME_RESPONSE in OP and puts a status
+ * byte in front of its payload. SOF never occurs in a text command, so
+ * frames and text lines can share the UART.
+ */
+#define UART_FRAME_SOF 0xA5U
+#define UART_FRAME_VERSION 1U
+#define UART_FRAME_RESPONSE 0x80U
+#define UART_FRAME_MIN_BODY 2U /* OP, SEQ */
+#define UART_FRAME_MAX_BODY 40U /* OP, SEQ, status, 32-byte key, slack */
+#define UART_FRAME_HDR_LEN 2U /* SOF, LEN */
+#define UART_FRAME_CRC_LEN 2U
+#define UART_FRAME_MAX_LEN (UART_FRAME_HDR_LEN + UART_FRAME_MAX_BODY + UART_FRAME_CRC_LEN)
+/* A sender that stalls this long mid-frame has given up on it. */
+#define UART_FRAME_GAP_MS 100U
+
+enum uart_frame_op {
+	UART_FRAME_OP_PING = 0x00,         /* -> version, max body */
+	UART_FRAME_OP_SET_SECRET = 0x01,   /* 32-byte Curve25519 scalar */
+	UART_FRAME_OP_SET_PEER = 0x02,     /* 32-byte Curve25519 peer key */
+	UART_FRAME_OP_READ_PUBKEY = 0x03,  /* -> 32-byte public key of the stored scalar */
+	UART_FRAME_OP_SET_OVERRIDE = 0x04, /* u32 LE watchdog override ms, 0 clears */
+};
+
+/* Response status; anything but OK is a NAK. */
+enum uart_frame_status {
+	UART_FRAME_OK = 0x00,
+	UART_FRAME_BAD_CRC = 0x01,
+	UART_FRAME_BAD_LEN = 0x02,
+	UART_FRAME_UNKNOWN_OP = 0x03,
+	UART_FRAME_BAD_ARG = 0x04,
+	UART_FRAME_UNSUPPORTED = 0x05,
+	UART_FRAME_STORE_FAILED = 0x06,
+};
+
+struct uart_frame {
+	uint8_t op;
+	uint8_t seq;
+	uint8_t len; /* payload bytes */
+	const uint8_t *payload;
+};
+
+static inline bool uart_frame_body_len_valid(uint8_t len)
+{
+	return len >= UART_FRAME_MIN_BODY && len <= UART_FRAME_MAX_BODY;
+}
+
+/* buf holds one frame starting at SOF. On success out->payload points into
+ * buf. Returns -EMSGSIZE for a bad length and -EBADMSG for a CRC mismatch;
+ * op and seq are filled in whenever they were received.
+ */
+int uart_frame_decode(const uint8_t *buf, size_t len, struct uart_frame *out);
+
+/* Builds a response to op/seq. Returns the frame length, or 0 when out is
+ * too small or the payload too long.
+ */
+size_t uart_frame_encode_response(uint8_t op, uint8_t seq, uint8_t status,
+				  const uint8_t *payload, size_t payload_len,
+				  uint8_t *out, size_t out_size);
+
+#endif /* UART_FRAME_H */
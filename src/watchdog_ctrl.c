@@ -7,23 +7,38 @@
 #include <zephyr/sys/time_units.h>
 #include <zephyr/sys/util.h>
 
-#if DT_NODE_HAS_COMPAT(DT_NODELABEL(iwdg), st_stm32_iwdg)
+#if IS_ENABLED(CONFIG_APP_WATCHDOG_SIM)
+#include <zephyr/sys/reboot.h>
+#elif DT_NODE_HAS_COMPAT(DT_NODELABEL(iwdg), st_stm32_iwdg)
 #include <stm32_ll_iwdg.h>
 #endif
 
+#include "log_utils.h"
+#include "prewatchdog.h"
 #include "watchdog_ctrl.h"
 
 LOG_MODULE_REGISTER(watchdog_ctrl, LOG_LEVEL_INF);
 
+/* Both the STM32 IWDG and its native_sim model expose the prescaler/reload
+ * registers, so both support a split (start/poll) retune.
+ */
+#if IS_ENABLED(CONFIG_APP_WATCHDOG_SIM) || DT_NODE_HAS_COMPAT(DT_NODELABEL(iwdg), st_stm32_iwdg)
+#define WATCHDOG_IWDG_REGS 1
+#else
+#define WATCHDOG_IWDG_REGS 0
+#endif
+
+#if !IS_ENABLED(CONFIG_APP_WATCHDOG_SIM)
 #define WDT_NODE DT_NODELABEL(iwdg)
 BUILD_ASSERT(DT_NODE_HAS_STATUS(WDT_NODE, okay), "IWDG node must be available");
 
 static const struct device *const wdt = DEVICE_DT_GET(WDT_NODE);
+#endif
 static atomic_t feed_enabled = ATOMIC_INIT(1);
 static int wdt_channel_id = -1;
 static uint32_t current_timeout_ms;
 
-#if DT_NODE_HAS_COMPAT(DT_NODELABEL(iwdg), st_stm32_iwdg)
+#if WATCHDOG_IWDG_REGS
 #ifndef LSI_VALUE
 #define LSI_VALUE 32000U
 #endif
@@ -33,6 +48,15 @@ static uint32_t current_timeout_ms;
 #define IWDG_PRESCALER_MAX 256U
 #define IWDG_SR_UPDATE_TIMEOUT_MS (6U * IWDG_PRESCALER_MAX * MSEC_PER_SEC / LSI_VALUE)
 
+/* Register update started by watchdog_ctrl_retune_start(); only the
+ * supervisor thread retunes, so no locking.
+ */
+static struct {
+	bool active;
+	uint32_t timeout_ms;
+	uint32_t start_ms;
+} retune;
+
 static int stm32_iwdg_compute(uint32_t timeout_ms, uint32_t *prescaler, uint32_t *reload)
 {
 	uint64_t timeout_us = (uint64_t)timeout_ms * USEC_PER_MSEC;
@@ -62,34 +86,162 @@ static int stm32_iwdg_compute(uint32_t timeout_ms, uint32_t *prescaler, uint32_t
 	*reload = value;
 	return 0;
 }
+#endif
 
-static int stm32_iwdg_retune_hw(uint32_t timeout_ms)
+#if IS_ENABLED(CONFIG_APP_WATCHDOG_SIM)
+/* Software model of the IWDG for native_sim: a down-counter clocked by LSI
+ * through the prescaler, PR/RLR writes that only take effect once the
+ * PVU/RVU status bits clear (five prescaled LSI cycles), and a cold reboot
+ * when the counter runs out. Accesses may come from the expiry timer, hence
+ * the spinlock.
+ */
+#define IWDG_SIM_UPDATE_CYCLES 5U
+
+static void iwdg_sim_expired(struct k_timer *timer);
+
+static K_TIMER_DEFINE(iwdg_sim_timer, iwdg_sim_expired, NULL);
+static struct k_spinlock iwdg_sim_lock;
+static struct {
+	uint32_t pr;
+	uint32_t rlr;
+	uint32_t next_pr;
+	uint32_t next_rlr;
+	int64_t sr_clear_ts; /* PVU/RVU set until this uptime; 0 when clear */
+	uint32_t expiries;
+} iwdg_sim;
+
+static uint32_t iwdg_sim_period_ms(uint32_t pr, uint32_t rlr)
 {
-	uint32_t prescaler = 0U;
-	uint32_t reload = 0U;
-	int rc = stm32_iwdg_compute(timeout_ms, &prescaler, &reload);
-	if (rc != 0) {
-		return rc;
+	uint64_t cycles = (uint64_t)(rlr + 1U) * (IWDG_PRESCALER_MIN << pr);
+
+	return (uint32_t)DIV_ROUND_UP(cycles * MSEC_PER_SEC, LSI_VALUE);
+}
+
+/* Caller holds iwdg_sim_lock. */
+static void iwdg_sim_sync(void)
+{
+	if (iwdg_sim.sr_clear_ts != 0 && k_uptime_get() >= iwdg_sim.sr_clear_ts) {
+		iwdg_sim.pr = iwdg_sim.next_pr;
+		iwdg_sim.rlr = iwdg_sim.next_rlr;
+		iwdg_sim.sr_clear_ts = 0;
 	}
+}
 
-	LL_IWDG_EnableWriteAccess(IWDG);
-	LL_IWDG_SetPrescaler(IWDG, prescaler);
-	LL_IWDG_SetReloadCounter(IWDG, reload);
+static void iwdg_sim_expired(struct k_timer *timer)
+{
+	ARG_UNUSED(timer);
 
-	uint32_t start = k_uptime_get_32();
-	while (LL_IWDG_IsReady(IWDG) == 0U) {
-		if ((k_uptime_get_32() - start) > IWDG_SR_UPDATE_TIMEOUT_MS) {
-			return -EAGAIN;
-		}
+	k_spinlock_key_t key = k_spin_lock(&iwdg_sim_lock);
+	uint32_t period_ms = iwdg_sim_period_ms(iwdg_sim.pr, iwdg_sim.rlr);
+
+	iwdg_sim.expiries++;
+	k_spin_unlock(&iwdg_sim_lock, key);
+
+	LOG_EVT(ERR, "WATCHDOG", "SIM_EXPIRED", "period_ms=%u", period_ms);
+	if (IS_ENABLED(CONFIG_APP_WATCHDOG_SIM_RESET)) {
+		sys_reboot(SYS_REBOOT_COLD);
 	}
+}
 
+static void iwdg_reload(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&iwdg_sim_lock);
+
+	iwdg_sim_sync();
+	k_timer_start(&iwdg_sim_timer, K_MSEC(iwdg_sim_period_ms(iwdg_sim.pr, iwdg_sim.rlr)),
+		      K_NO_WAIT);
+	k_spin_unlock(&iwdg_sim_lock, key);
+}
+
+static bool iwdg_is_ready(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&iwdg_sim_lock);
+
+	iwdg_sim_sync();
+	bool ready = iwdg_sim.sr_clear_ts == 0;
+
+	k_spin_unlock(&iwdg_sim_lock, key);
+	return ready;
+}
+
+static int iwdg_write_config(uint32_t prescaler, uint32_t reload)
+{
+	k_spinlock_key_t key = k_spin_lock(&iwdg_sim_lock);
+	int rc = 0;
+
+	iwdg_sim_sync();
+	if (iwdg_sim.sr_clear_ts != 0) {
+		rc = -EBUSY;
+	} else {
+		uint32_t divider = IWDG_PRESCALER_MIN << MAX(iwdg_sim.pr, prescaler);
+
+		iwdg_sim.next_pr = prescaler;
+		iwdg_sim.next_rlr = reload;
+		iwdg_sim.sr_clear_ts = k_uptime_get() +
+			DIV_ROUND_UP(IWDG_SIM_UPDATE_CYCLES * divider * MSEC_PER_SEC, LSI_VALUE);
+	}
+
+	k_spin_unlock(&iwdg_sim_lock, key);
+	return rc;
+}
+
+uint32_t watchdog_ctrl_sim_expiries(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&iwdg_sim_lock);
+	uint32_t expiries = iwdg_sim.expiries;
+
+	k_spin_unlock(&iwdg_sim_lock, key);
+	return expiries;
+}
+#elif DT_NODE_HAS_COMPAT(DT_NODELABEL(iwdg), st_stm32_iwdg)
+static void iwdg_reload(void)
+{
 	LL_IWDG_ReloadCounter(IWDG);
+}
+
+static bool iwdg_is_ready(void)
+{
+	return LL_IWDG_IsReady(IWDG) != 0U;
+}
+
+/* PR/RLR writes are ignored while a previous update is still in flight. */
+static int iwdg_write_config(uint32_t prescaler, uint32_t reload)
+{
+	LL_IWDG_EnableWriteAccess(IWDG);
+	if (!iwdg_is_ready()) {
+		return -EBUSY;
+	}
+
+	LL_IWDG_SetPrescaler(IWDG, prescaler);
+	LL_IWDG_SetReloadCounter(IWDG, reload);
 	return 0;
 }
 #endif
 
 int watchdog_ctrl_init(uint32_t timeout_ms)
 {
+#if IS_ENABLED(CONFIG_APP_WATCHDOG_SIM)
+	uint32_t prescaler = 0U;
+	uint32_t reload = 0U;
+	int rc = stm32_iwdg_compute(timeout_ms, &prescaler, &reload);
+
+	if (rc != 0) {
+		LOG_ERR("Failed to install watchdog timeout: %d", rc);
+		return rc;
+	}
+
+	k_spinlock_key_t key = k_spin_lock(&iwdg_sim_lock);
+
+	iwdg_sim.pr = prescaler;
+	iwdg_sim.rlr = reload;
+	iwdg_sim.sr_clear_ts = 0;
+	k_spin_unlock(&iwdg_sim_lock, key);
+
+	wdt_channel_id = 0;
+	retune.active = false;
+	LOG_INF("Simulated IWDG: prescaler /%u, reload %u",
+		IWDG_PRESCALER_MIN << prescaler, reload);
+#else
 	if (!device_is_ready(wdt)) {
 		LOG_ERR("Watchdog device not ready");
 		return -ENODEV;
@@ -119,9 +271,15 @@ int watchdog_ctrl_init(uint32_t timeout_ms)
 		LOG_ERR("Watchdog setup failed: %d", ret);
 		return ret;
 	}
+#endif
 
 	current_timeout_ms = timeout_ms;
-	return watchdog_ctrl_feed();
+	int rc_feed = watchdog_ctrl_feed();
+
+	if (rc_feed == 0) {
+		prewatchdog_start();
+	}
+	return rc_feed;
 }
 
 int watchdog_ctrl_feed(void)
@@ -134,7 +292,17 @@ int watchdog_ctrl_feed(void)
 		return -EBUSY;
 	}
 
-	return wdt_feed(wdt, wdt_channel_id);
+#if IS_ENABLED(CONFIG_APP_WATCHDOG_SIM)
+	iwdg_reload();
+	int rc = 0;
+#else
+	int rc = wdt_feed(wdt, wdt_channel_id);
+#endif
+
+	if (rc == 0) {
+		prewatchdog_feed();
+	}
+	return rc;
 }
 
 void watchdog_ctrl_set_enabled(bool enable)
@@ -154,7 +322,7 @@ bool watchdog_ctrl_is_enabled(void)
 	return atomic_get(&feed_enabled) != 0;
 }
 
-int watchdog_ctrl_retune(uint32_t timeout_ms)
+int watchdog_ctrl_retune_start(uint32_t timeout_ms)
 {
 	if (wdt_channel_id < 0) {
 		return -EAGAIN;
@@ -164,18 +332,61 @@ int watchdog_ctrl_retune(uint32_t timeout_ms)
 		return -EINVAL;
 	}
 
+#if WATCHDOG_IWDG_REGS
+	if (retune.active) {
+		return -EBUSY;
+	}
+
 	if (timeout_ms == current_timeout_ms) {
 		return 0;
 	}
 
-#if DT_NODE_HAS_COMPAT(DT_NODELABEL(iwdg), st_stm32_iwdg)
-	int rc = stm32_iwdg_retune_hw(timeout_ms);
-	if (rc == 0) {
-		current_timeout_ms = timeout_ms;
+	uint32_t prescaler = 0U;
+	uint32_t reload = 0U;
+	int rc = stm32_iwdg_compute(timeout_ms, &prescaler, &reload);
+	if (rc != 0) {
+		return rc;
 	}
-	return rc;
+
+	rc = iwdg_write_config(prescaler, reload);
+	if (rc != 0) {
+		return rc;
+	}
+
+	retune.active = true;
+	retune.timeout_ms = timeout_ms;
+	retune.start_ms = k_uptime_get_32();
+	return -EINPROGRESS;
+#else
+	if (timeout_ms == current_timeout_ms) {
+		return 0;
+	}
+	return -ENOTSUP;
+#endif
+}
+
+int watchdog_ctrl_retune_poll(void)
+{
+#if WATCHDOG_IWDG_REGS
+	if (!retune.active) {
+		return -EINVAL;
+	}
+
+	if (!iwdg_is_ready()) {
+		if ((k_uptime_get_32() - retune.start_ms) > IWDG_SR_UPDATE_TIMEOUT_MS) {
+			retune.active = false;
+			return -ETIMEDOUT;
+		}
+		return -EINPROGRESS;
+	}
+
+	/* Start the new period from a full counter. */
+	iwdg_reload();
+	prewatchdog_feed();
+	current_timeout_ms = retune.timeout_ms;
+	retune.active = false;
+	return 0;
 #else
-	ARG_UNUSED(timeout_ms);
 	return -ENOTSUP;
 #endif
 }
@@ -8,7 +8,20 @@ int watchdog_ctrl_init(uint32_t timeout_ms);
 int watchdog_ctrl_feed(void);
 void watchdog_ctrl_set_enabled(bool enable);
 bool watchdog_ctrl_is_enabled(void);
-int watchdog_ctrl_retune(uint32_t timeout_ms);
+/* Non-blocking retune. start returns 0 when the timeout already applies,
+ * -EINPROGRESS once the new prescaler/reload values are written, -EBUSY
+ * while a previous update is still in flight, or -ENOTSUP. Then call poll
+ * until it stops returning -EINPROGRESS: 0 means the new timeout is armed
+ * and the counter was reloaded, -ETIMEDOUT means the status register never
+ * cleared. The old timeout stays in force until then.
+ */
+int watchdog_ctrl_retune_start(uint32_t timeout_ms);
+int watchdog_ctrl_retune_poll(void);
 uint32_t watchdog_ctrl_get_timeout(void);
 
+#if defined(CONFIG_APP_WATCHDOG_SIM)
+/* Times the simulated IWDG ran out (native_sim only). */
+uint32_t watchdog_ctrl_sim_expiries(void);
+#endif
+
 #endif /* WATCHDOG_CTRL_H */
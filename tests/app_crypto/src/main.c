@@ -0,0 +1,173 @@
+#include <errno.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/ztest.h>
+
+#include "app_crypto.h"
+#include "persist_state.h"
+
+#define HOLDER_STACK_SIZE 1024
+/* Longer than the 1 ms retry budget in rekey_work_handler(). */
+#define RETRY_BUDGET_MS 150
+
+K_THREAD_STACK_DEFINE(holder_stack, HOLDER_STACK_SIZE);
+static struct k_thread holder_thread;
+static K_SEM_DEFINE(holder_pinned, 0, 1);
+static K_SEM_DEFINE(holder_done, 0, 1);
+static atomic_t holder_release;
+
+static void *app_crypto_suite_setup(void)
+{
+	int rc = app_crypto_init();
+
+	zassert_ok(rc, "crypto init failed (%d)", rc);
+	return NULL;
+}
+
+/* Every test starts from a fresh partition and a freshly derived session. */
+static void app_crypto_before(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	app_crypto_test_forget();
+	persist_state_test_reset();
+	zassert_ok(app_crypto_init(), NULL);
+}
+
+/* Lowest priority and never sleeps while pinned: it only gets the CPU when
+ * every other thread, the system workqueue included, is waiting.
+ */
+static void holder_entry(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	app_crypto_test_pin_session();
+	k_sem_give(&holder_pinned);
+	while (atomic_get(&holder_release) == 0) {
+		k_busy_wait(100);
+	}
+	app_crypto_test_unpin_session();
+	k_sem_give(&holder_done);
+}
+
+/* Polls message boundaries until a new session is swapped in. */
+static bool wait_for_swap(uint32_t before, uint32_t timeout_ms)
+{
+	for (uint32_t waited = 0U; waited < timeout_ms; waited++) {
+		app_crypto_message_boundary();
+		if (app_crypto_get_session_counter() != before) {
+			return true;
+		}
+		k_msleep(1);
+	}
+	return false;
+}
+
+ZTEST(app_crypto_suite, test_rekey_swaps_at_message_boundary)
+{
+	uint32_t before = app_crypto_get_session_counter();
+
+	zassert_true(before != 0U, NULL);
+	zassert_ok(app_crypto_request_rekey(), NULL);
+	zassert_equal(app_crypto_request_rekey(), -EALREADY, NULL);
+
+	/* Staged in the background, but only a boundary swaps it in. */
+	k_msleep(20);
+	zassert_equal(app_crypto_get_session_counter(), before, "swapped mid-message");
+
+	app_crypto_message_boundary();
+	zassert_equal(app_crypto_get_session_counter(), before + 1U, NULL);
+	zassert_ok(app_crypto_request_rekey(), "request not re-armed after the swap");
+}
+
+ZTEST(app_crypto_suite, test_rekey_waits_for_low_priority_holder)
+{
+	atomic_clear(&holder_release);
+	k_sem_reset(&holder_pinned);
+	k_sem_reset(&holder_done);
+	k_thread_create(&holder_thread, holder_stack, K_THREAD_STACK_SIZEOF(holder_stack),
+			holder_entry, NULL, NULL, NULL, K_LOWEST_APPLICATION_THREAD_PRIO, 0,
+			K_NO_WAIT);
+	zassert_ok(k_sem_take(&holder_pinned, K_MSEC(100)), NULL);
+
+	/* The first rekey fills the free slot; the holder keeps the old one. */
+	uint32_t before = app_crypto_get_session_counter();
+
+	zassert_ok(app_crypto_request_rekey(), NULL);
+	zassert_true(wait_for_swap(before, 200U), "first rekey did not complete");
+
+	/* The next one targets the pinned slot. A worker that spun on the
+	 * cooperative workqueue would starve the holder and hang here.
+	 */
+	before = app_crypto_get_session_counter();
+	zassert_ok(app_crypto_request_rekey(), NULL);
+	atomic_set(&holder_release, 1);
+
+	zassert_true(wait_for_swap(before, 200U), "rekey never completed");
+	zassert_equal(k_sem_count_get(&holder_done), 1U, "slot rewritten while pinned");
+	zassert_ok(k_thread_join(&holder_thread, K_MSEC(100)), NULL);
+}
+
+ZTEST(app_crypto_suite, test_rekey_outlasts_retry_budget_without_reusing_counter)
+{
+	/* Pin the current session, then move off it so it becomes the shadow. */
+	app_crypto_test_pin_session();
+
+	uint32_t before = app_crypto_get_session_counter();
+
+	zassert_ok(app_crypto_request_rekey(), NULL);
+	zassert_true(wait_for_swap(before, 200U), NULL);
+
+	uint32_t current = app_crypto_get_session_counter();
+
+	zassert_ok(app_crypto_request_rekey(), NULL);
+	k_msleep(RETRY_BUDGET_MS);
+	app_crypto_message_boundary();
+	zassert_equal(app_crypto_get_session_counter(), current, "pinned slot rewritten");
+	zassert_equal(app_crypto_request_rekey(), -EALREADY,
+		      "request dropped once the retries ran out");
+
+	/* Released late: the rekey still lands, on the very next counter. */
+	app_crypto_test_unpin_session();
+	zassert_true(wait_for_swap(current, 500U), "rekey not rescheduled");
+	zassert_equal(app_crypto_get_session_counter(), current + 1U,
+		      "a counter was drawn while waiting for the slot");
+}
+
+/* A reset drops the keys, and app_crypto_init() mounts persist_state before
+ * any key exists, as main() does.
+ */
+static void reboot_with_new_session_key(void)
+{
+	app_crypto_test_forget();
+	persist_state_test_reload();
+	zassert_ok(app_crypto_init(), NULL);
+}
+
+ZTEST(app_crypto_suite, test_counter_increases_across_reboot_after_rekey)
+{
+	uint32_t last = app_crypto_get_session_counter();
+
+	/* Rekey until the worker itself has had to persist a new lease. */
+	while (last <= CONFIG_APP_PERSIST_SESSION_LEASE) {
+		zassert_ok(app_crypto_request_rekey(), NULL);
+		zassert_true(wait_for_swap(last, 200U), NULL);
+		last = app_crypto_get_session_counter();
+	}
+
+	for (int boot = 0; boot < 2; boot++) {
+		reboot_with_new_session_key();
+
+		uint32_t now = app_crypto_get_session_counter();
+
+		zassert_true(now > last, "counter reused on boot %d (%u <= %u)", boot, now, last);
+		zassert_ok(app_crypto_request_rekey(), NULL);
+		zassert_true(wait_for_swap(now, 200U), NULL);
+		last = app_crypto_get_session_counter();
+	}
+}
+
+ZTEST_SUITE(app_crypto_suite, NULL, app_crypto_suite_setup, app_crypto_before, NULL, NULL);
@@ -0,0 +1,154 @@
+#include <zephyr/ztest.h>
+
+#include "event_log.h"
+
+#define TEST_QUEUE_DEPTH CONFIG_APP_EVENT_LOG_QUEUE_DEPTH
+/* Two 4 KB simulator sectors of 16-byte records (tests/common/native.overlay). */
+#define TEST_RING_SLOTS 512U
+
+struct walk_result {
+	uint32_t count;
+	uint32_t first_seq;
+	uint32_t last_seq;
+	uint32_t last_arg;
+	uint16_t last_boot;
+	uint16_t last_id;
+	bool ordered;
+};
+
+static void collect(const struct event_log_record *rec, void *user_data)
+{
+	struct walk_result *res = user_data;
+
+	if (res->count == 0U) {
+		res->first_seq = rec->seq;
+	} else if (rec->seq != res->last_seq + 1U) {
+		res->ordered = false;
+	}
+
+	res->last_seq = rec->seq;
+	res->last_arg = rec->arg;
+	res->last_boot = rec->boot;
+	res->last_id = rec->id;
+	res->count++;
+}
+
+static struct walk_result walk_all(void)
+{
+	struct walk_result res = { .ordered = true };
+	int rc = event_log_walk(collect, &res);
+
+	zassert_true(rc >= 0, "walk failed (%d)", rc);
+	zassert_equal((uint32_t)rc, res.count, NULL);
+	return res;
+}
+
+static void append_many(uint32_t count)
+{
+	for (uint32_t i = 0U; i < count; i++) {
+		event_log_append(EVENT_LOG_WATCHDOG_OVERRIDE, i);
+		if ((i % TEST_QUEUE_DEPTH) == (TEST_QUEUE_DEPTH - 1U)) {
+			event_log_flush();
+		}
+	}
+	event_log_flush();
+}
+
+static void *event_log_suite_setup(void)
+{
+	zassert_ok(event_log_init(), "event log init failed");
+	return NULL;
+}
+
+static void event_log_before(void *fixture)
+{
+	ARG_UNUSED(fixture);
+	event_log_test_erase();
+}
+
+ZTEST(event_log_suite, test_records_survive_reload_with_new_boot)
+{
+	event_log_append(EVENT_LOG_BOOT, 0x10U);
+	event_log_append(EVENT_LOG_SAFE_MODE_ENTER, 3U);
+	event_log_append(EVENT_LOG_RECOVERY_REBOOT, 1U);
+	event_log_flush();
+
+	/* Simulated reboot: only flash survives. */
+	event_log_test_reload();
+	event_log_append(EVENT_LOG_BOOT, 0x20U);
+	event_log_flush();
+
+	struct walk_result res = walk_all();
+
+	zassert_equal(res.count, 4U, "expected four records, got %u", res.count);
+	zassert_true(res.ordered, "records must be returned oldest first");
+	zassert_equal(res.first_seq, 1U, NULL);
+	zassert_equal(res.last_seq, 4U, NULL);
+	zassert_equal(res.last_id, EVENT_LOG_BOOT, NULL);
+	zassert_equal(res.last_arg, 0x20U, NULL);
+	zassert_equal(res.last_boot, 2U, "boot counter must advance on reload");
+}
+
+ZTEST(event_log_suite, test_ring_wrap_drops_oldest_sector)
+{
+	uint32_t total = TEST_RING_SLOTS + (TEST_RING_SLOTS / 4U);
+
+	append_many(total);
+	event_log_test_reload();
+
+	struct walk_result res = walk_all();
+
+	zassert_true(res.ordered, "wrapped log must stay in sequence order");
+	zassert_equal(res.last_seq, total, "newest record missing after wrap");
+	zassert_equal(res.last_arg, total - 1U, NULL);
+	zassert_true(res.count < TEST_RING_SLOTS, "one sector must be recycled");
+	zassert_true(res.first_seq > 1U, "oldest records must be dropped");
+
+	/* Appending after the reload continues the sequence. */
+	event_log_append(EVENT_LOG_BOOT, 0U);
+	event_log_flush();
+	res = walk_all();
+	zassert_equal(res.last_seq, total + 1U, NULL);
+}
+
+struct slow_walk {
+	struct walk_result outer;
+	int seen_during_walk;
+};
+
+/* On the first record, append one more and give the system workqueue time
+ * to write it, as a slow UART dump would.
+ */
+static void slow_collect(const struct event_log_record *rec, void *user_data)
+{
+	struct slow_walk *walk = user_data;
+
+	if (walk->outer.count == 0U) {
+		struct walk_result inner = { .ordered = true };
+
+		event_log_append(EVENT_LOG_BOOT, 0x30U);
+		k_msleep(20);
+		walk->seen_during_walk = event_log_walk(collect, &inner);
+	}
+	collect(rec, &walk->outer);
+}
+
+ZTEST(event_log_suite, test_walk_does_not_block_writer)
+{
+	struct slow_walk walk = { .outer = { .ordered = true } };
+
+	event_log_append(EVENT_LOG_BOOT, 0x10U);
+	event_log_append(EVENT_LOG_SAFE_MODE_ENTER, 3U);
+	event_log_append(EVENT_LOG_RECOVERY_REBOOT, 1U);
+	event_log_flush();
+
+	int rc = event_log_walk(slow_collect, &walk);
+
+	zassert_equal(walk.seen_during_walk, 4, "drain blocked by a running walk");
+	zassert_equal(rc, 3, "walk must stop at its snapshot");
+	zassert_equal(walk.outer.last_seq, 3U, NULL);
+	zassert_true(walk.outer.ordered, NULL);
+	zassert_equal(walk_all().count, 4U, NULL);
+}
+
+ZTEST_SUITE(event_log_suite, NULL, event_log_suite_setup, event_log_before, NULL, NULL);
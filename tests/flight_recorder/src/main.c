@@ -0,0 +1,114 @@
+#include <string.h>
+
+#include <zephyr/ztest.h>
+
+#include "flight_recorder.h"
+#include "log_utils.h"
+
+LOG_MODULE_REGISTER(flight_recorder_test, LOG_LEVEL_INF);
+
+#define TEST_ENTRIES CONFIG_APP_FLIGHT_RECORDER_ENTRIES
+
+struct walk_result {
+	uint32_t count;
+	uint32_t first_arg;
+	uint32_t last_arg;
+	uint32_t last_arg1;
+	const char *last_status;
+	bool ordered;
+};
+
+static void collect(const struct flight_event *ev, void *user_data)
+{
+	struct walk_result *res = user_data;
+
+	if (res->count == 0U) {
+		res->first_arg = ev->arg[0];
+	} else if (ev->arg[0] != res->last_arg + 1U) {
+		res->ordered = false;
+	}
+
+	res->last_arg = ev->arg[0];
+	res->last_arg1 = ev->arg[1];
+	res->last_status = ev->status;
+	res->count++;
+}
+
+static struct walk_result walk_all(void)
+{
+	struct walk_result res = { .ordered = true };
+
+	(void)flight_recorder_walk(collect, &res);
+	return res;
+}
+
+static void flight_fixture_reset(void *fixture)
+{
+	ARG_UNUSED(fixture);
+	/* Start every case from an armed, empty ring. */
+	(void)flight_recorder_test_reboot();
+}
+
+ZTEST(flight_recorder_suite, test_log_evt_records_tag_status_and_args)
+{
+	LOG_EVT_SIMPLE(INF, "TEST", "SIMPLE");
+	LOG_EVT(INF, "TEST", "ARGS", "a=%u,b=%d", 0U, -2);
+
+	struct walk_result res = walk_all();
+
+	zassert_equal(res.count, 2U, NULL);
+	zassert_str_equal(res.last_status, "ARGS", NULL);
+	zassert_equal(res.last_arg, 0U, NULL);
+	zassert_equal(res.last_arg1, (uint32_t)-2, NULL);
+}
+
+ZTEST(flight_recorder_suite, test_log_evt_evaluates_args_once)
+{
+	uint32_t next = 10U;
+	char name[] = "ARR";
+
+	LOG_EVT(INF, "TEST", "ONCE", "a=%u,b=%u,name=%s", next++, next++, name);
+
+	struct walk_result res = walk_all();
+
+	zassert_equal(next, 12U, "an argument was evaluated twice");
+	zassert_equal(res.count, 1U, NULL);
+	zassert_equal(res.last_arg, 10U, NULL);
+	zassert_equal(res.last_arg1, 11U, NULL);
+
+	LOG_EVT(INF, "TEST", "ONE", "a=%u", next++);
+	res = walk_all();
+	zassert_equal(next, 13U, NULL);
+	zassert_equal(res.last_arg, 12U, NULL);
+	zassert_equal(res.last_arg1, 0U, NULL);
+}
+
+ZTEST(flight_recorder_suite, test_ring_survives_reboot_and_keeps_newest)
+{
+	for (uint32_t i = 0U; i < TEST_ENTRIES + 3U; i++) {
+		LOG_EVT(INF, "TEST", "SEQ", "i=%u", i);
+	}
+
+	struct walk_result res = walk_all();
+
+	zassert_equal(res.count, TEST_ENTRIES, NULL);
+	zassert_equal(res.first_arg, 3U, "oldest entries must be overwritten first");
+	zassert_equal(res.last_arg, TEST_ENTRIES + 2U, NULL);
+	zassert_true(res.ordered, NULL);
+
+	/* The next boot dumps the previous ring once, then starts empty. */
+	zassert_equal(flight_recorder_test_reboot(), TEST_ENTRIES, NULL);
+	zassert_equal(walk_all().count, 0U, NULL);
+}
+
+ZTEST(flight_recorder_suite, test_torn_entry_is_skipped)
+{
+	for (uint32_t i = 0U; i < 4U; i++) {
+		LOG_EVT(INF, "TEST", "SEQ", "i=%u", i);
+	}
+
+	flight_recorder_test_corrupt(1U);
+	zassert_equal(flight_recorder_test_reboot(), 3, "corrupted entry must not be dumped");
+}
+
+ZTEST_SUITE(flight_recorder_suite, NULL, NULL, flight_fixture_reset, NULL, NULL);
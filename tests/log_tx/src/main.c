@@ -0,0 +1,228 @@
+#include <string.h>
+
+#include <zephyr/device.h>
+#include <zephyr/drivers/serial/uart_emul.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/ztest.h>
+
+#include "log_tx.h"
+
+LOG_MODULE_REGISTER(log_tx_test, LOG_LEVEL_INF);
+
+#define BURST_MSGS 4U
+#define FLOOD_MAX_MSGS 40U
+#define DRAIN_MS 50
+#define BAUD 115200U
+
+static const struct device *const emul = DEVICE_DT_GET(DT_CHOSEN(app_log_uart));
+static uint8_t captured[4096];
+
+/* Reads everything the backend handed to the UART; returns the length. */
+static size_t capture(void)
+{
+	size_t len = 0U;
+	uint32_t n;
+
+	do {
+		n = uart_emul_get_tx_data(emul, &captured[len], sizeof(captured) - 1U - len);
+		len += n;
+	} while (n != 0U && len < sizeof(captured) - 1U);
+	captured[len] = '\0';
+	return len;
+}
+
+static uint32_t count_lines(size_t len)
+{
+	uint32_t lines = 0U;
+
+	for (size_t i = 0U; i < len; i++) {
+		if (captured[i] == '\n') {
+			lines++;
+		}
+	}
+	return lines;
+}
+
+static void drain(void)
+{
+	for (int i = 0; i < DRAIN_MS && log_tx_pending(); i++) {
+		k_msleep(1);
+	}
+	zassert_false(log_tx_pending(), "ring did not drain");
+	k_msleep(1);
+}
+
+static void *log_tx_setup(void)
+{
+	zassert_true(device_is_ready(emul), NULL);
+	drain();
+	(void)capture();
+	return NULL;
+}
+
+static void log_tx_before(void *fixture)
+{
+	ARG_UNUSED(fixture);
+	drain();
+	(void)capture();
+}
+
+ZTEST(log_tx_suite, test_burst_is_queued_not_written)
+{
+	struct log_tx_stats before;
+	struct log_tx_stats after;
+
+	log_tx_get_stats(&before);
+
+	uint32_t start = k_cycle_get_32();
+
+	for (uint32_t i = 0U; i < BURST_MSGS; i++) {
+		LOG_INF("EVT,TEST,BURST,seq=%u,pad=0123456789abcdef", i);
+	}
+
+	uint32_t enqueue_us = k_cyc_to_us_floor32(k_cycle_get_32() - start);
+
+	log_tx_get_stats(&after);
+
+	uint32_t bytes = after.bytes - before.bytes;
+	uint32_t wire_us = (uint32_t)(((uint64_t)bytes * 10U * 1000000U) / BAUD);
+
+	/* The test thread has not yielded, so nothing can have drained yet. */
+	zassert_true(log_tx_pending(), NULL);
+	zassert_equal(after.msgs - before.msgs, BURST_MSGS, NULL);
+	zassert_equal(after.dropped_msgs, before.dropped_msgs, NULL);
+	TC_PRINT("burst: msgs=%u bytes=%u enqueue_us=%u wire_us=%u\n", BURST_MSGS, bytes,
+		 enqueue_us, wire_us);
+	zassert_true(enqueue_us < wire_us, "producer waited for the UART");
+
+	drain();
+
+	size_t len = capture();
+
+	zassert_equal(len, bytes, NULL);
+	zassert_equal(count_lines(len), BURST_MSGS, NULL);
+	zassert_not_null(strstr((const char *)captured, "EVT,TEST,BURST,seq=3"), NULL);
+}
+
+ZTEST(log_tx_suite, test_overflow_drops_whole_messages)
+{
+	struct log_tx_stats before;
+	struct log_tx_stats now;
+	uint32_t congested_at = UINT32_MAX;
+	uint32_t first_drop_at = UINT32_MAX;
+
+	log_tx_get_stats(&before);
+
+	for (uint32_t i = 0U; i < FLOOD_MAX_MSGS; i++) {
+		LOG_INF("EVT,TEST,FLOOD,seq=%u,pad=0123456789abcdef0123456789abcdef", i);
+		log_tx_get_stats(&now);
+		if (congested_at == UINT32_MAX && log_tx_congested()) {
+			congested_at = i;
+		}
+		if (first_drop_at == UINT32_MAX && now.dropped_msgs != before.dropped_msgs) {
+			first_drop_at = i;
+		}
+	}
+
+	TC_PRINT("flood: sent=%u queued=%u dropped=%u dropped_bytes=%u max_fill=%u "
+		 "congested_at=%u first_drop_at=%u\n",
+		 FLOOD_MAX_MSGS, now.msgs - before.msgs, now.dropped_msgs - before.dropped_msgs,
+		 now.dropped_bytes - before.dropped_bytes, now.max_fill, congested_at,
+		 first_drop_at);
+
+	zassert_true(first_drop_at != UINT32_MAX, "flood fit the ring");
+	/* Producers were told before anything was lost. */
+	zassert_true(congested_at < first_drop_at, NULL);
+	zassert_equal((now.msgs - before.msgs) + (now.dropped_msgs - before.dropped_msgs),
+		      FLOOD_MAX_MSGS, NULL);
+	zassert_true(now.dropped_bytes > before.dropped_bytes, NULL);
+	zassert_true(now.max_fill <= CONFIG_APP_LOG_TX_RING_SIZE, NULL);
+
+	drain();
+	zassert_false(log_tx_congested(), "backpressure did not clear");
+
+	LOG_INF("EVT,TEST,AFTER_FLOOD");
+	drain();
+
+	struct log_tx_stats after;
+	size_t len = capture();
+
+	log_tx_get_stats(&after);
+	/* Only whole lines reached the UART: the queued ones, the drop notice
+	 * and the line after it.
+	 */
+	zassert_equal(count_lines(len), after.msgs - before.msgs, NULL);
+	zassert_equal(len, after.bytes - before.bytes, NULL);
+
+	const char *notice = strstr((const char *)captured, "log messages dropped");
+	const char *last = strstr((const char *)captured, "EVT,TEST,AFTER_FLOOD");
+
+	zassert_not_null(notice, NULL);
+	zassert_not_null(last, NULL);
+	zassert_true(notice < last, NULL);
+}
+
+ZTEST(log_tx_suite, test_long_message_is_cut_whole)
+{
+	char pad[CONFIG_APP_LOG_TX_LINE_MAX + 1];
+	struct log_tx_stats before;
+	struct log_tx_stats after;
+
+	memset(pad, 'x', sizeof(pad) - 1U);
+	pad[sizeof(pad) - 1U] = '\0';
+
+	log_tx_get_stats(&before);
+	LOG_INF("EVT,TEST,LONG,pad=%s", pad);
+	LOG_INF("EVT,TEST,AFTER_LONG");
+	log_tx_get_stats(&after);
+	drain();
+
+	size_t len = capture();
+
+	zassert_equal(after.truncated - before.truncated, 1U, NULL);
+	zassert_equal(after.dropped_msgs, before.dropped_msgs, NULL);
+	zassert_equal(count_lines(len), 2U, NULL);
+	/* The cut line still ends the line, so the next one starts clean. */
+	zassert_equal(captured[CONFIG_APP_LOG_TX_LINE_MAX - 1U], '\n', NULL);
+
+	const char *next = strstr((const char *)captured, "EVT,TEST,AFTER_LONG");
+
+	zassert_not_null(next, NULL);
+	zassert_true(next > (const char *)&captured[CONFIG_APP_LOG_TX_LINE_MAX - 1U], NULL);
+}
+
+/* A producer that preempts the stage owner formats straight into the ring
+ * and must produce the same cut line.
+ */
+ZTEST(log_tx_suite, test_long_message_is_cut_whole_while_stage_held)
+{
+	char pad[CONFIG_APP_LOG_TX_LINE_MAX + 1];
+	struct log_tx_stats before;
+	struct log_tx_stats after;
+
+	memset(pad, 'x', sizeof(pad) - 1U);
+	pad[sizeof(pad) - 1U] = '\0';
+
+	log_tx_get_stats(&before);
+	log_tx_test_hold_stage(true);
+	LOG_INF("EVT,TEST,LONG,pad=%s", pad);
+	LOG_INF("EVT,TEST,AFTER_LONG");
+	log_tx_test_hold_stage(false);
+	log_tx_get_stats(&after);
+	drain();
+
+	size_t len = capture();
+
+	zassert_equal(after.truncated - before.truncated, 1U, NULL);
+	zassert_equal(after.msgs - before.msgs, 2U, NULL);
+	zassert_equal(count_lines(len), 2U, NULL);
+	zassert_equal(captured[CONFIG_APP_LOG_TX_LINE_MAX - 1U], '\n', NULL);
+
+	const char *next = strstr((const char *)captured, "EVT,TEST,AFTER_LONG");
+
+	zassert_not_null(next, NULL);
+	zassert_true(next > (const char *)&captured[CONFIG_APP_LOG_TX_LINE_MAX - 1U], NULL);
+}
+
+ZTEST_SUITE(log_tx_suite, NULL, log_tx_setup, log_tx_before, NULL, NULL);
@@ -0,0 +1,166 @@
+#include <zephyr/device.h>
+#include <zephyr/drivers/flash.h>
+#include <zephyr/kernel.h>
+#include <zephyr/storage/flash_map.h>
+#include <zephyr/ztest.h>
+
+#include "persist_backend.h"
+#include "safe_memory.h"
+#include "persist_state_priv.h"
+
+/* Replays the persist_state write pattern (boot record, session lease,
+ * watchdog override) against whichever backend is linked and reports
+ * mount time, write latency and erase volume as one BENCH line so the NVS
+ * and ZMS scenarios can be compared side by side.
+ */
+
+#define BENCH_BOOTS             200U
+#define BENCH_SESSIONS_PER_BOOT 40U
+#define BENCH_SESSION_LEASE     32U
+#define BENCH_WDT_EVERY         8U
+#define BENCH_OVERRIDE_EVERY    25U
+
+#define BENCH_ID_SESSION  5U
+#define BENCH_ID_WDT      6U
+#define BENCH_ID_TOTAL    7U
+#define BENCH_ID_OVERRIDE 8U
+
+#define STORAGE_PARTITION_NODE DT_NODELABEL(storage_partition)
+
+#define BENCH_RECORD_LEN sizeof(struct persist_field)
+
+struct bench_result {
+	uint32_t mounts;
+	uint32_t mount_us_total;
+	uint32_t mount_us_max;
+	uint32_t writes;
+	uint32_t write_us_total;
+	uint32_t write_us_max;
+	uint32_t bytes_written;
+	uint32_t gc_cycles;
+};
+
+static struct bench_result result;
+static uint32_t last_gc;
+static uint32_t write_seq;
+
+static void bench_track_gc(void)
+{
+	uint32_t gc = persist_backend_gc_count();
+
+	result.gc_cycles += gc - last_gc;
+	last_gc = gc;
+}
+
+static void bench_mount(void)
+{
+	const struct flash_area *fa = NULL;
+	struct flash_pages_info page_info;
+
+	int rc = flash_area_open(DT_FIXED_PARTITION_ID(STORAGE_PARTITION_NODE), &fa);
+	zassert_ok(rc, "flash_area_open failed (%d)", rc);
+	rc = flash_get_page_info_by_offs(fa->fa_dev, fa->fa_off, &page_info);
+	zassert_ok(rc, "page info failed (%d)", rc);
+
+	persist_backend_forget();
+	rc = persist_backend_configure(fa->fa_dev, fa->fa_off, page_info.size,
+				       fa->fa_size / page_info.size);
+	flash_area_close(fa);
+	zassert_ok(rc, "configure failed (%d)", rc);
+
+	uint32_t start = k_cycle_get_32();
+	rc = persist_backend_mount();
+	uint32_t us = k_cyc_to_us_floor32(k_cycle_get_32() - start);
+
+	zassert_ok(rc, "%s mount failed (%d)", persist_backend_name(), rc);
+	result.mounts++;
+	result.mount_us_total += us;
+	result.mount_us_max = MAX(result.mount_us_max, us);
+	last_gc = persist_backend_gc_count();
+}
+
+static void bench_write(uint32_t id, uint32_t value)
+{
+	uint8_t record[BENCH_RECORD_LEN];
+
+	/* Distinct bytes per write so the backend never deduplicates one. */
+	write_seq++;
+	for (size_t i = 0; i < sizeof(record); ++i) {
+		record[i] = (uint8_t)((write_seq * 131U) + (i * 17U) + value);
+	}
+
+	uint32_t start = k_cycle_get_32();
+	ssize_t written = persist_backend_write(id, record, sizeof(record));
+	uint32_t us = k_cyc_to_us_floor32(k_cycle_get_32() - start);
+
+	zassert_equal(written, (ssize_t)sizeof(record), "write id=%u failed (%d)", id,
+		      (int)written);
+	result.writes++;
+	result.bytes_written += (uint32_t)written;
+	result.write_us_total += us;
+	result.write_us_max = MAX(result.write_us_max, us);
+	bench_track_gc();
+}
+
+static void *persist_backend_suite_setup(void)
+{
+	bench_mount();
+	int rc = persist_backend_clear();
+	zassert_ok(rc, "clear failed (%d)", rc);
+	return NULL;
+}
+
+ZTEST(persist_backend_suite, test_boot_session_override_pattern)
+{
+	uint32_t consecutive = 0U;
+	uint32_t total = 0U;
+	uint32_t override_ms = 0U;
+	uint32_t high_water = 0U;
+
+	safe_memset(&result, sizeof(result), 0, sizeof(result));
+
+	for (uint32_t boot = 1U; boot <= BENCH_BOOTS; ++boot) {
+		bench_mount();
+
+		if ((boot % BENCH_WDT_EVERY) == 0U) {
+			consecutive++;
+			total++;
+			bench_write(BENCH_ID_WDT, consecutive);
+			bench_write(BENCH_ID_TOTAL, total);
+		} else if (consecutive != 0U) {
+			consecutive = 0U;
+			bench_write(BENCH_ID_WDT, consecutive);
+		}
+
+		/* Each boot starts a fresh lease; sessions inside the boot only
+		 * commit when the lease is exhausted.
+		 */
+		for (uint32_t s = 0U; s < BENCH_SESSIONS_PER_BOOT; ++s) {
+			if ((s % BENCH_SESSION_LEASE) == 0U) {
+				high_water += BENCH_SESSION_LEASE;
+				bench_write(BENCH_ID_SESSION, high_water);
+			}
+		}
+
+		if ((boot % BENCH_OVERRIDE_EVERY) == 0U) {
+			override_ms = (override_ms == 0U) ? 4000U : 0U;
+			bench_write(BENCH_ID_OVERRIDE, override_ms);
+		}
+	}
+
+	bench_mount();
+	uint8_t record[BENCH_RECORD_LEN];
+	ssize_t rc = persist_backend_read(BENCH_ID_SESSION, record, sizeof(record));
+	zassert_equal(rc, (ssize_t)sizeof(record), "session record lost (%d)", (int)rc);
+
+	TC_PRINT("BENCH,%s,mounts=%u,mount_avg_us=%u,mount_max_us=%u,writes=%u,"
+		 "write_avg_us=%u,write_max_us=%u,bytes_written=%u,gc=%u,bytes_erased=%u\n",
+		 persist_backend_name(), result.mounts, result.mount_us_total / result.mounts,
+		 result.mount_us_max, result.writes, result.write_us_total / result.writes,
+		 result.write_us_max, result.bytes_written, result.gc_cycles,
+		 result.gc_cycles * persist_backend_sector_size());
+
+	zassert_true(result.gc_cycles > 0U, "workload too small to exercise GC");
+}
+
+ZTEST_SUITE(persist_backend_suite, NULL, persist_backend_suite_setup, NULL, NULL, NULL);
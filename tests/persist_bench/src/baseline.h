@@ -0,0 +1,20 @@
+#ifndef PERSIST_BENCH_BASELINE_H
+#define PERSIST_BENCH_BASELINE_H
+
+/* Expected flash traffic for the persist_bench workload (prj.conf: NVS
+ * backend, write-through, two 4 KB simulator sectors). Both values are
+ * deterministic: they depend only on the workload, the record layout and
+ * NVS allocation, never on host timing. The suite fails when a run exceeds
+ * them; after an intentional storage-layer change, paste the values from
+ * the printed BASELINE line here in the same commit.
+ *
+ * Ratios are in thousandths (milli) of a byte per logical update. The
+ * current values come from 666 updates (600 session leases, 60 override
+ * changes, six watchdog-counter updates) writing 671 plain 8-byte field
+ * records. With the schema marker that is 672 NVS entries of 16 B, which
+ * roll the 4 KB sector twice.
+ */
+#define BASELINE_WRITTEN_PER_UPDATE_MILLI 8060U  /* 5368 B / 666 */
+#define BASELINE_ERASED_PER_UPDATE_MILLI  12300U /* 2 x 4096 B / 666 */
+
+#endif /* PERSIST_BENCH_BASELINE_H */
@@ -0,0 +1,157 @@
+#include <stdlib.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+
+#include "app_crypto.h"
+#include "persist_state.h"
+
+#include "baseline.h"
+
+/* Drives persist_state through a scripted device life: repeated boots, a
+ * watchdog reset storm, session-key churn and override changes. Reports
+ * flash bytes written/erased per logical update, which are deterministic
+ * and gated by baseline.h, and latency percentiles, which depend on the
+ * host and are only reported.
+ */
+
+/* Enough boots to roll the NVS sector more than once. */
+#define BENCH_BOOTS             300U
+#define BENCH_STORM_FIRST       40U
+#define BENCH_STORM_LEN         5U
+#define BENCH_SESSIONS_PER_BOOT 40U
+#define BENCH_OVERRIDE_EVERY    5U
+
+#define BENCH_MAX_CALLS (BENCH_BOOTS * (BENCH_SESSIONS_PER_BOOT + 4U))
+
+static uint32_t call_us[BENCH_MAX_CALLS];
+static uint32_t call_count;
+static uint32_t mount_us[BENCH_BOOTS];
+static uint32_t mount_count;
+
+static int cmp_u32(const void *a, const void *b)
+{
+	uint32_t lhs = *(const uint32_t *)a;
+	uint32_t rhs = *(const uint32_t *)b;
+
+	return (lhs > rhs) - (lhs < rhs);
+}
+
+static uint32_t percentile(uint32_t *samples, uint32_t count, uint32_t pct)
+{
+	if (count == 0U) {
+		return 0U;
+	}
+
+	qsort(samples, count, sizeof(samples[0]), cmp_u32);
+	return samples[((count - 1U) * pct) / 100U];
+}
+
+static void check_ceiling(const char *name, uint32_t measured, uint32_t baseline)
+{
+	zassert_true(measured <= baseline, "%s regressed: %u > baseline %u", name, measured,
+		     baseline);
+	if (measured < baseline) {
+		TC_PRINT("%s improved: %u < baseline %u, update baseline.h\n", name, measured,
+			 baseline);
+	}
+}
+
+#define TIMED_CALL(expr)                                                            \
+	do {                                                                        \
+		uint32_t start_ = k_cycle_get_32();                                 \
+		expr;                                                               \
+		if (call_count < BENCH_MAX_CALLS) {                                 \
+			call_us[call_count++] =                                     \
+				k_cyc_to_us_floor32(k_cycle_get_32() - start_);     \
+		}                                                                   \
+	} while (0)
+
+static void bench_boot(bool watchdog_reset)
+{
+	persist_state_test_reload();
+
+	uint32_t start = k_cycle_get_32();
+	int rc = persist_state_init();
+
+	mount_us[mount_count++] = k_cyc_to_us_floor32(k_cycle_get_32() - start);
+	zassert_ok(rc, "mount failed (%d)", rc);
+
+	TIMED_CALL(persist_state_record_boot(watchdog_reset));
+}
+
+static void *persist_bench_suite_setup(void)
+{
+	int rc = app_crypto_init();
+
+	zassert_ok(rc, "AES helper init failed (%d)", rc);
+	return NULL;
+}
+
+ZTEST(persist_bench_suite, test_device_life_write_amplification)
+{
+	struct persist_state_stats stats;
+	uint32_t override_ms = 0U;
+
+	persist_state_test_reset();
+	call_count = 0U;
+	mount_count = 0U;
+
+	for (uint32_t boot = 0U; boot < BENCH_BOOTS; ++boot) {
+		bool storm = (boot >= BENCH_STORM_FIRST) &&
+			     (boot < BENCH_STORM_FIRST + BENCH_STORM_LEN);
+
+		bench_boot(storm);
+
+		/* Each encrypted sample or rekey pulls a fresh session counter. */
+		for (uint32_t s = 0U; s < BENCH_SESSIONS_PER_BOOT; ++s) {
+			TIMED_CALL((void)persist_state_next_session_counter());
+		}
+
+		if ((boot % BENCH_OVERRIDE_EVERY) == 0U) {
+			int rc;
+
+			override_ms = (override_ms == 4000U) ? 2500U : 4000U;
+			TIMED_CALL(rc = persist_state_set_watchdog_override(override_ms));
+			zassert_ok(rc, NULL);
+		}
+
+		TIMED_CALL((void)persist_state_get_consecutive_watchdog());
+	}
+
+	persist_state_get_stats(&stats);
+	zassert_true(stats.updates > 0U, NULL);
+	zassert_equal(stats.write_failures, 0U, NULL);
+
+	uint32_t sector_size = 0U;
+	struct persist_state_wear wear;
+
+	if (persist_state_get_wear(&wear) == 0) {
+		sector_size = wear.sector_size;
+	} else {
+		/* Tests always run on the 4 KB-page flash simulator. */
+		sector_size = 4096U;
+	}
+
+	uint32_t written_milli = (uint32_t)(((uint64_t)stats.bytes_written * 1000U) /
+					    stats.updates);
+	uint32_t erased_milli = (uint32_t)(((uint64_t)stats.gc_cycles * sector_size * 1000U) /
+					   stats.updates);
+	uint32_t call_p50 = percentile(call_us, call_count, 50U);
+	uint32_t call_p99 = percentile(call_us, call_count, 99U);
+	uint32_t mount_p50 = percentile(mount_us, mount_count, 50U);
+	uint32_t mount_p99 = percentile(mount_us, mount_count, 99U);
+
+	TC_PRINT("BENCH,persist_state,updates=%u,writes=%u,bytes=%u,gc=%u,calls=%u,boots=%u\n",
+		 stats.updates, stats.writes, stats.bytes_written, stats.gc_cycles,
+		 call_count, mount_count);
+	TC_PRINT("BASELINE,written_milli=%u,erased_milli=%u\n", written_milli, erased_milli);
+	/* Report only: simulated flash time plus whatever the host adds. */
+	TC_PRINT("LATENCY,call_p50_us=%u,call_p99_us=%u,mount_p50_us=%u,mount_p99_us=%u\n",
+		 call_p50, call_p99, mount_p50, mount_p99);
+
+	check_ceiling("written/update", written_milli, BASELINE_WRITTEN_PER_UPDATE_MILLI);
+	check_ceiling("erased/update", erased_milli, BASELINE_ERASED_PER_UPDATE_MILLI);
+}
+
+ZTEST_SUITE(persist_bench_suite, NULL, persist_bench_suite_setup, NULL, NULL, NULL);
@@ -1,8 +1,11 @@
+#include <errno.h>
 #include <string.h>
 
 #include <zephyr/ztest.h>
 
 #include "app_crypto.h"
+#include "persist_backend.h"
+#include "persist_state.h"
 #include "persist_state_priv.h"
 #include "persist_state_test.h"
 
@@ -44,4 +47,459 @@ ZTEST(persist_state_suite, test_plain_copy_helper)
 	zassert_equal(memcmp(&copied, &baseline, sizeof(baseline)), 0, "blob copy mismatch");
 }
 
+ZTEST(persist_state_suite, test_session_lease_monotonic_across_reload)
+{
+	persist_state_test_reset();
+
+	uint32_t first = persist_state_next_session_counter();
+	uint32_t second = persist_state_next_session_counter();
+
+	zassert_equal(first, 1U, "first session counter should be 1");
+	zassert_equal(second, first + 1U, "counters inside a lease must be sequential");
+
+	/* Simulated reset: RAM lease is lost, only the high-water mark survives. */
+	persist_state_test_reload();
+
+	uint32_t after_reload = persist_state_next_session_counter();
+	zassert_true(after_reload > second, "counter went backwards (%u <= %u)",
+		     after_reload, second);
+	zassert_equal(after_reload, CONFIG_APP_PERSIST_SESSION_LEASE + 1U,
+		      "reload should resume after the persisted lease");
+}
+
+ZTEST(persist_state_suite, test_session_lease_write_failure_issues_nothing)
+{
+	persist_state_test_reset();
+	zassert_ok(persist_state_init(), NULL);
+
+	persist_state_test_fail_writes(-EIO);
+	zassert_equal(persist_state_next_session_counter(), 0U,
+		      "counter issued from a lease that never reached flash");
+	zassert_equal(persist_state_next_session_counter(), 0U, NULL);
+
+	/* The failed lease is rolled back, not skipped over in RAM only. */
+	persist_state_test_fail_writes(0);
+	zassert_equal(persist_state_next_session_counter(), 1U, NULL);
+
+	persist_state_test_reload();
+	zassert_equal(persist_state_next_session_counter(),
+		      CONFIG_APP_PERSIST_SESSION_LEASE + 1U,
+		      "reload should resume after the lease that was persisted");
+}
+
+/* A real reset loses the session key too, and main() mounts persist_state
+ * through app_crypto_init() before any key exists.
+ */
+static void reboot_with_new_session_key(void)
+{
+	app_crypto_test_forget();
+	persist_state_test_reload();
+	zassert_ok(app_crypto_init(), NULL);
+	zassert_ok(persist_state_init(), NULL);
+}
+
+ZTEST(persist_state_suite, test_fields_survive_reboot_with_new_session_key)
+{
+	persist_state_test_reset();
+	zassert_ok(persist_state_init(), NULL);
+	persist_state_record_boot(true);
+	persist_state_record_boot(true);
+	zassert_ok(persist_state_set_watchdog_override(2750U), NULL);
+
+	uint32_t issued = persist_state_next_session_counter();
+
+	zassert_ok(persist_state_flush(), NULL);
+
+	for (int boot = 0; boot < 2; boot++) {
+		reboot_with_new_session_key();
+		zassert_equal(persist_state_get_consecutive_watchdog(), 2U,
+			      "watchdog count lost on boot %d", boot);
+		zassert_equal(persist_state_get_total_watchdog(), 2U, NULL);
+		zassert_equal(persist_state_get_watchdog_override(), 2750U, NULL);
+
+		uint32_t next = persist_state_next_session_counter();
+
+		zassert_true(next > issued, "session counter reused (%u <= %u)", next, issued);
+		issued = next;
+	}
+}
+
+ZTEST(persist_state_suite, test_legacy_blob_migrates_to_field_records)
+{
+	struct persist_blob legacy;
+
+	persist_state_test_reset();
+	persist_state_test_init_blob(&legacy, 2U, 7U, 2500U);
+	legacy.session_counter = 40U;
+	persist_state_test_write_legacy_blob(&legacy);
+
+	persist_state_test_reload();
+	zassert_ok(persist_state_init(), NULL);
+	zassert_equal(persist_state_get_consecutive_watchdog(), 2U, NULL);
+	zassert_equal(persist_state_get_total_watchdog(), 7U, NULL);
+	zassert_equal(persist_state_get_watchdog_override(), 2500U, NULL);
+	zassert_true(persist_state_next_session_counter() > 40U,
+		     "session counter must resume above the migrated value");
+
+	/* Second mount reads the field records; the legacy blob is gone. */
+	zassert_ok(persist_state_set_watchdog_override(3000U), NULL);
+	zassert_ok(persist_state_flush(), NULL);
+	persist_state_test_reload();
+	zassert_ok(persist_state_init(), NULL);
+	zassert_equal(persist_state_get_total_watchdog(), 7U, NULL);
+	zassert_equal(persist_state_get_watchdog_override(), 3000U, NULL);
+}
+
+ZTEST(persist_state_suite, test_gc_deferred_until_watchdog_feed)
+{
+	struct persist_state_stats stats = {0};
+	uint32_t override_ms = 1000U;
+
+	if (!IS_ENABLED(CONFIG_APP_PERSIST_GC_SCHEDULING) ||
+	    IS_ENABLED(CONFIG_APP_PERSIST_WRITE_BEHIND)) {
+		ztest_test_skip();
+	}
+
+	persist_state_test_reset();
+	zassert_ok(persist_state_init(), NULL);
+
+	/* A feed whose deadline is already too close for an erase. */
+	persist_state_watchdog_fed(1U);
+	k_msleep(5);
+
+	for (int i = 0; i < 400 && stats.gc_deferred == 0U; i++) {
+		override_ms++;
+		zassert_ok(persist_state_set_watchdog_override(override_ms), NULL);
+		persist_state_get_stats(&stats);
+	}
+
+	zassert_true(stats.gc_deferred > 0U, "sector never filled up");
+	zassert_equal(stats.gc_cycles, 0U, "GC ran outside the feed window");
+	zassert_equal(persist_state_get_watchdog_override(), override_ms, NULL);
+
+	/* A fresh feed opens the window; the work item commits and GCs. */
+	persist_state_watchdog_fed(10000U);
+	k_msleep(50);
+	persist_state_get_stats(&stats);
+	zassert_true(stats.gc_cycles > 0U, "deferred commit did not run");
+	zassert_true(stats.gc_min_margin_ms > 0, NULL);
+
+	persist_state_test_reload();
+	zassert_ok(persist_state_init(), NULL);
+	zassert_equal(persist_state_get_watchdog_override(), override_ms, NULL);
+}
+
+ZTEST(persist_state_suite, test_compaction_survives_reboot_with_new_session_key)
+{
+	uint32_t override_ms = 1000U;
+
+	if (!IS_ENABLED(CONFIG_APP_PERSIST_GC_SCHEDULING) ||
+	    IS_ENABLED(CONFIG_APP_PERSIST_WRITE_BEHIND)) {
+		ztest_test_skip();
+	}
+
+	persist_state_test_reset();
+	zassert_ok(persist_state_init(), NULL);
+	persist_state_record_boot(true);
+
+	uint32_t issued = persist_state_next_session_counter();
+
+	/* Walk the write sector into the headroom the compactor keeps. */
+	while (persist_backend_fits_in_sector(CONFIG_APP_PERSIST_GC_HEADROOM)) {
+		zassert_true(override_ms < 2000U, "sector never filled up");
+		zassert_ok(persist_state_set_watchdog_override(++override_ms), NULL);
+	}
+
+	uint32_t gc = persist_backend_gc_count();
+
+	persist_state_watchdog_fed(10000U);
+	k_msleep(50);
+	zassert_not_equal(persist_backend_gc_count(), gc, "compaction did not run");
+
+	reboot_with_new_session_key();
+	zassert_equal(persist_state_get_consecutive_watchdog(), 1U,
+		      "schema marker unreadable after compaction");
+	zassert_equal(persist_state_get_watchdog_override(), override_ms, NULL);
+	zassert_true(persist_state_next_session_counter() > issued, "session counter reused");
+}
+
+ZTEST(persist_state_suite, test_wear_rollup_survives_reload)
+{
+	struct persist_state_wear wear;
+
+	/* Write-behind coalesces the loop into a handful of commits. */
+	if (!IS_ENABLED(CONFIG_APP_PERSIST_WEAR_TELEMETRY) ||
+	    IS_ENABLED(CONFIG_APP_PERSIST_WRITE_BEHIND)) {
+		ztest_test_skip();
+	}
+
+	persist_state_test_reset();
+	zassert_ok(persist_state_init(), NULL);
+
+	/* Enough override changes to fill a 4 KB sector at least once. */
+	for (uint32_t i = 0U; i < 300U; i++) {
+		zassert_ok(persist_state_set_watchdog_override(1000U + i), NULL);
+	}
+
+	zassert_ok(persist_state_get_wear(&wear), NULL);
+	zassert_true(wear.lifetime_erases > 0U, "no GC observed");
+	zassert_true(wear.lifetime_writes >= 300U, NULL);
+	zassert_true(wear.free_bytes > 0, NULL);
+
+	uint32_t erases = wear.lifetime_erases;
+
+	zassert_ok(persist_state_flush(), NULL);
+	persist_state_test_reload();
+	zassert_ok(persist_state_init(), NULL);
+	zassert_ok(persist_state_get_wear(&wear), NULL);
+	zassert_equal(wear.lifetime_erases, erases, "rollup lost across reload");
+}
+
+ZTEST(persist_state_suite, test_flush_saves_wear_rollup_only_when_stale)
+{
+	struct persist_state_wear before;
+	struct persist_state_wear after;
+
+	if (!IS_ENABLED(CONFIG_APP_PERSIST_WEAR_TELEMETRY)) {
+		ztest_test_skip();
+	}
+
+	persist_state_test_reset();
+	zassert_ok(persist_state_init(), NULL);
+	zassert_ok(persist_state_get_wear(&before), NULL);
+	zassert_ok(persist_state_flush(), NULL);
+	zassert_ok(persist_state_flush(), NULL);
+	zassert_ok(persist_state_get_wear(&after), NULL);
+	zassert_equal(after.lifetime_writes, before.lifetime_writes,
+		      "idle flush rewrote the wear rollup");
+
+	for (uint32_t i = 0U; i < CONFIG_APP_PERSIST_WEAR_SAVE_WRITES; i++) {
+		zassert_ok(persist_state_set_watchdog_override(1000U + i), NULL);
+		zassert_ok(persist_state_flush(), NULL);
+	}
+
+	persist_state_test_reload();
+	zassert_ok(persist_state_init(), NULL);
+	zassert_ok(persist_state_get_wear(&after), NULL);
+	zassert_true(after.lifetime_writes >= CONFIG_APP_PERSIST_WEAR_SAVE_WRITES,
+		     "rollup not saved once past the threshold (%u)", after.lifetime_writes);
+}
+
+ZTEST(persist_state_suite, test_task_faults_cached_and_committed)
+{
+	struct persist_state_stats before;
+	struct persist_state_stats now;
+
+	persist_state_test_reset();
+	zassert_ok(persist_state_init(), NULL);
+	zassert_equal(persist_state_get_task_faults(1U), 0U, NULL);
+
+	persist_state_get_stats(&before);
+	zassert_true(persist_state_note_task_fault(1U) >= 0, NULL);
+	zassert_true(persist_state_note_task_fault(1U) >= 0, NULL);
+	zassert_equal(persist_state_note_task_fault(CONFIG_APP_SUPERVISOR_MAX_TASKS), -EINVAL,
+		      NULL);
+	zassert_equal(persist_state_get_task_faults(1U), 2U, NULL);
+	zassert_equal(persist_state_get_task_faults(0U), 0U, NULL);
+	persist_state_get_stats(&now);
+	zassert_equal(now.updates - before.updates, 2U, "faults bypassed the update path");
+
+	zassert_ok(persist_state_flush(), NULL);
+	persist_state_test_reload();
+	zassert_ok(persist_state_init(), NULL);
+	zassert_equal(persist_state_get_task_faults(1U), 2U, "fault count lost across reload");
+}
+
+ZTEST(persist_state_suite, test_escalation_cached_and_committed)
+{
+	struct persist_state_escalation in = {
+		.stage = 2U,
+		.task_mask = 0x5U,
+		.elapsed_ms = 1234U,
+	};
+	struct persist_state_escalation out;
+	struct persist_state_stats before;
+	struct persist_state_stats now;
+
+	persist_state_test_reset();
+	zassert_ok(persist_state_init(), NULL);
+
+	persist_state_get_stats(&before);
+	zassert_ok(persist_state_set_escalation(&in), NULL);
+	zassert_ok(persist_state_set_escalation(&in), NULL);
+	persist_state_get_stats(&now);
+	zassert_equal(now.updates - before.updates, 1U, "unchanged incident was rewritten");
+
+	persist_state_get_escalation(&out);
+	zassert_equal(out.stage, 2U, NULL);
+	zassert_equal(out.task_mask, 0x5U, NULL);
+	zassert_equal(out.elapsed_ms, 1234U, NULL);
+
+	/* The reboot rungs flush before rebooting. */
+	zassert_ok(persist_state_flush(), NULL);
+	persist_state_test_reload();
+	zassert_ok(persist_state_init(), NULL);
+	persist_state_get_escalation(&out);
+	zassert_equal(out.stage, 2U, "incident lost across reload");
+	zassert_equal(out.elapsed_ms, 1234U, NULL);
+}
+
+#if IS_ENABLED(CONFIG_APP_PERSIST_WRITE_BEHIND)
+#define SETTLE_MS CONFIG_APP_PERSIST_FLUSH_SETTLE_MS
+#else
+#define SETTLE_MS 0
+#endif
+
+ZTEST(persist_state_suite, test_write_behind_burst_is_one_commit)
+{
+	struct persist_state_stats before;
+	struct persist_state_stats now;
+
+	if (!IS_ENABLED(CONFIG_APP_PERSIST_WRITE_BEHIND)) {
+		ztest_test_skip();
+	}
+
+	persist_state_test_reset();
+	zassert_ok(persist_state_init(), NULL);
+	persist_state_get_stats(&before);
+
+	for (uint32_t i = 0U; i < 10U; i++) {
+		zassert_ok(persist_state_set_watchdog_override(2000U + i), NULL);
+	}
+
+	/* Cached and published at once, not yet on flash. */
+	zassert_equal(persist_state_get_watchdog_override(), 2009U, NULL);
+	k_msleep(SETTLE_MS / 2);
+	persist_state_get_stats(&now);
+	zassert_equal(now.updates - before.updates, 10U, NULL);
+	zassert_equal(now.writes, before.writes, "committed before the settle time");
+
+	k_msleep(SETTLE_MS + 50);
+	persist_state_get_stats(&now);
+	zassert_equal(now.writes - before.writes, 1U, "burst did not land as one commit");
+
+	persist_state_test_reload();
+	zassert_ok(persist_state_init(), NULL);
+	zassert_equal(persist_state_get_watchdog_override(), 2009U, NULL);
+}
+
+ZTEST(persist_state_suite, test_write_behind_flush_commits_now)
+{
+	struct persist_state_stats before;
+	struct persist_state_stats now;
+
+	if (!IS_ENABLED(CONFIG_APP_PERSIST_WRITE_BEHIND)) {
+		ztest_test_skip();
+	}
+
+	persist_state_test_reset();
+	zassert_ok(persist_state_init(), NULL);
+	persist_state_get_stats(&before);
+
+	zassert_ok(persist_state_set_watchdog_override(4000U), NULL);
+	zassert_ok(persist_state_flush(), NULL);
+	persist_state_get_stats(&now);
+	zassert_equal(now.writes - before.writes, 1U, "flush did not commit immediately");
+
+	/* The flush thread wakes to find nothing left to write. */
+	k_msleep(SETTLE_MS + 50);
+	persist_state_get_stats(&now);
+	zassert_equal(now.writes - before.writes, 1U, NULL);
+
+	persist_state_test_reload();
+	zassert_ok(persist_state_init(), NULL);
+	zassert_equal(persist_state_get_watchdog_override(), 4000U, NULL);
+}
+
+ZTEST(persist_state_suite, test_write_behind_reports_background_failure)
+{
+	if (!IS_ENABLED(CONFIG_APP_PERSIST_WRITE_BEHIND)) {
+		ztest_test_skip();
+	}
+
+	persist_state_test_reset();
+	zassert_ok(persist_state_init(), NULL);
+
+	/* Accepted into the cache; the flush thread's commit then fails. */
+	persist_state_test_fail_writes(-EIO);
+	zassert_ok(persist_state_set_watchdog_override(4000U), NULL);
+	k_msleep(SETTLE_MS + 50);
+
+	zassert_equal(persist_state_set_watchdog_override(4500U), -EIO,
+		      "background failure reported as success");
+	zassert_equal(persist_state_flush(), -EIO, NULL);
+
+	persist_state_test_fail_writes(0);
+	zassert_ok(persist_state_flush(), NULL);
+	zassert_ok(persist_state_set_watchdog_override(5000U), "error reported twice");
+	zassert_ok(persist_state_flush(), NULL);
+
+	persist_state_test_reload();
+	zassert_ok(persist_state_init(), NULL);
+	zassert_equal(persist_state_get_watchdog_override(), 5000U, NULL);
+}
+
+ZTEST(persist_state_suite, test_warm_reboot_restores_from_retained_cache)
+{
+	if (!IS_ENABLED(CONFIG_APP_PERSIST_WARM_CACHE)) {
+		ztest_test_skip();
+	}
+
+	persist_state_test_reset();
+	zassert_ok(persist_state_init(), NULL);
+	zassert_ok(persist_state_set_watchdog_override(3500U), NULL);
+
+	uint32_t issued = persist_state_next_session_counter();
+
+	zassert_ok(persist_state_prepare_warm_reboot(), NULL);
+
+	/* Armed warm boot: state and lease position come from retained RAM. */
+	persist_state_test_reload();
+	zassert_ok(persist_state_init(), NULL);
+	zassert_equal(persist_state_get_watchdog_override(), 3500U, NULL);
+	zassert_equal(persist_state_next_session_counter(), issued + 1U,
+		      "warm boot should continue the cached lease");
+
+	/* The cache is consumed; an unarmed reset falls back to flash. */
+	persist_state_test_reload();
+	zassert_ok(persist_state_init(), NULL);
+	zassert_equal(persist_state_get_watchdog_override(), 3500U, NULL);
+	zassert_true(persist_state_next_session_counter() > issued + 1U,
+		     "cold load must skip past the persisted lease");
+}
+
+ZTEST(persist_state_suite, test_warm_boot_crypto_init_skips_mount)
+{
+	if (!IS_ENABLED(CONFIG_APP_PERSIST_WARM_CACHE) ||
+	    !IS_ENABLED(CONFIG_APP_CRYPTO_BACKEND_CURVE25519)) {
+		ztest_test_skip();
+	}
+
+	persist_state_test_reset();
+	app_crypto_test_forget();
+	zassert_ok(app_crypto_init(), NULL);
+	zassert_ok(persist_state_set_watchdog_override(3100U), NULL);
+
+	uint32_t counter = app_crypto_get_session_counter();
+
+	zassert_ok(persist_state_prepare_warm_reboot(), NULL);
+
+	/* main() order, with flash gone: only the handover can serve it. */
+	app_crypto_test_forget();
+	persist_state_test_reload();
+	persist_state_test_fail_mount(-EIO);
+	zassert_ok(app_crypto_init(), "warm boot still needed the mount");
+	zassert_equal(app_crypto_get_session_counter(), counter + 1U,
+		      "warm boot should continue the cached lease");
+	zassert_equal(persist_state_get_watchdog_override(), 3100U, NULL);
+
+	/* Consumed: a second boot without a handover must mount again. */
+	app_crypto_test_forget();
+	persist_state_test_reload();
+	zassert_not_equal(app_crypto_init(), 0, "scalar served without a handover");
+	persist_state_test_fail_mount(0);
+	zassert_ok(app_crypto_init(), NULL);
+	zassert_true(app_crypto_get_session_counter() > counter + 1U, NULL);
+}
+
 ZTEST_SUITE(persist_state_suite, NULL, persist_state_suite_setup, NULL, NULL, NULL);
@@ -0,0 +1,251 @@
+#include <errno.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/reboot.h>
+#include <zephyr/ztest.h>
+
+#include "persist_state.h"
+#include "recovery.h"
+#include "recovery_test.h"
+
+extern struct persist_state_escalation stub_escalation;
+extern uint32_t stub_warm_prepares;
+extern uint32_t stub_flushes;
+
+#define TEST_TASK_MASK BIT(1)
+/* Simulated time for each rung to bring the heartbeat back. */
+#define RESTART_HEAL_MS 10
+#define REINIT_HEAL_MS 40
+#define BOOT_MS 150
+#define INCIDENTS_PER_STAGE 3
+#define INCIDENT_LIMIT_MS 3000
+/* Polls the registered reboot hook needs before it reports completion. */
+#define SLOW_HOOK_POLLS 3U
+
+/* Lowest rung that clears the simulated fault. */
+static enum recovery_stage cure_stage;
+static int reboots[2]; /* warm, cold */
+static bool hook_stuck;
+/* Thread the last action ran on. */
+static k_tid_t action_thread;
+
+static void heal_handler(struct k_work *work)
+{
+	ARG_UNUSED(work);
+	recovery_report_healthy();
+}
+static K_WORK_DELAYABLE_DEFINE(heal_work, heal_handler);
+
+static int fake_restart(void)
+{
+	action_thread = k_current_get();
+	if (cure_stage == RECOVERY_STAGE_RESTART) {
+		k_work_schedule(&heal_work, K_MSEC(RESTART_HEAL_MS));
+	}
+	return 0;
+}
+
+static int fake_reinit(void)
+{
+	action_thread = k_current_get();
+	if (cure_stage <= RECOVERY_STAGE_REINIT) {
+		k_work_schedule(&heal_work, K_MSEC(REINIT_HEAL_MS));
+	}
+	return 0;
+}
+
+/* Runs on the recovery thread in place of sys_reboot(): pick the incident
+ * up from the stub record, spend a boot, then report what the supervisor
+ * would see after its boot grace.
+ */
+static void fake_reboot(int type)
+{
+	enum recovery_stage stage = (type == SYS_REBOOT_COLD) ?
+				    RECOVERY_STAGE_COLD_REBOOT : RECOVERY_STAGE_WARM_REBOOT;
+
+	reboots[(type == SYS_REBOOT_COLD) ? 1 : 0]++;
+	recovery_test_reboot();
+	k_msleep(BOOT_MS);
+	if (stub_escalation.stage == RECOVERY_STAGE_NONE) {
+		/* Not a ladder reboot: nothing to report. */
+		return;
+	}
+	if (cure_stage <= stage) {
+		recovery_report_healthy();
+	} else {
+		recovery_report_task_fault(TEST_TASK_MASK);
+	}
+}
+
+static int slow_hook_step(enum recovery_reason reason, int reboot_type, uint32_t call)
+{
+	ARG_UNUSED(reason);
+	ARG_UNUSED(reboot_type);
+	return (hook_stuck || call < SLOW_HOOK_POLLS) ? -EINPROGRESS : 0;
+}
+
+static const struct recovery_reboot_hook slow_hook = { "slow", slow_hook_step };
+
+static uint32_t mean_ms(const struct recovery_stage_stats *st)
+{
+	return (st->recovered == 0U) ? 0U : st->total_ms / st->recovered;
+}
+
+/* Inject one fault, wait until the ladder reports recovery at the expected
+ * rung, then let the stable window close the incident.
+ */
+static void run_incident(enum recovery_stage stage)
+{
+	struct recovery_stage_stats before;
+	struct recovery_stage_stats after;
+
+	cure_stage = stage;
+	recovery_get_stage_stats(stage, &before);
+	recovery_report_task_fault(TEST_TASK_MASK);
+
+	int64_t limit = k_uptime_get() + INCIDENT_LIMIT_MS;
+
+	do {
+		k_msleep(10);
+		recovery_get_stage_stats(stage, &after);
+	} while (after.recovered == before.recovered && k_uptime_get() < limit);
+
+	zassert_equal(after.recovered, before.recovered + 1U, "stage %d did not recover", stage);
+	k_msleep(CONFIG_APP_RECOVERY_STABLE_MS + 50);
+	zassert_equal(stub_escalation.stage, RECOVERY_STAGE_NONE, "incident left open");
+}
+
+static void *recovery_setup(void)
+{
+	recovery_register_actions(TEST_TASK_MASK, fake_restart, fake_reinit);
+	recovery_test_set_reboot_hook(fake_reboot);
+	(void)recovery_register_reboot_hook(&slow_hook);
+	recovery_start();
+	return NULL;
+}
+
+ZTEST(recovery_suite, test_mttr_per_stage)
+{
+	static const char *const names[] = { "", "restart", "reinit", "warm", "cold" };
+	struct recovery_stage_stats base[RECOVERY_STAGE_COUNT];
+	struct recovery_stage_stats st[RECOVERY_STAGE_COUNT];
+	int warm_before = reboots[0];
+	int cold_before = reboots[1];
+	uint32_t prepares_before = stub_warm_prepares;
+	uint32_t flushes_before = stub_flushes;
+
+	for (int stage = RECOVERY_STAGE_RESTART; stage < RECOVERY_STAGE_COUNT; stage++) {
+		recovery_get_stage_stats((enum recovery_stage)stage, &base[stage]);
+	}
+
+	for (int stage = RECOVERY_STAGE_RESTART; stage < RECOVERY_STAGE_COUNT; stage++) {
+		for (int i = 0; i < INCIDENTS_PER_STAGE; i++) {
+			run_incident((enum recovery_stage)stage);
+		}
+	}
+
+	for (int stage = RECOVERY_STAGE_RESTART; stage < RECOVERY_STAGE_COUNT; stage++) {
+		recovery_get_stage_stats((enum recovery_stage)stage, &st[stage]);
+		/* Only this test's incidents. */
+		st[stage].attempts -= base[stage].attempts;
+		st[stage].recovered -= base[stage].recovered;
+		st[stage].total_ms -= base[stage].total_ms;
+		TC_PRINT("stage=%s attempts=%u recovered=%u mttr_mean_ms=%u max_ms=%u\n",
+			 names[stage], st[stage].attempts, st[stage].recovered,
+			 mean_ms(&st[stage]), st[stage].max_ms);
+		zassert_equal(st[stage].recovered, INCIDENTS_PER_STAGE, NULL);
+	}
+
+	/* Each rung costs the failed windows below it plus its own latency. */
+	zassert_true(mean_ms(&st[RECOVERY_STAGE_RESTART]) <
+		     mean_ms(&st[RECOVERY_STAGE_REINIT]), NULL);
+	zassert_true(mean_ms(&st[RECOVERY_STAGE_REINIT]) <
+		     mean_ms(&st[RECOVERY_STAGE_WARM_REBOOT]), NULL);
+	zassert_true(mean_ms(&st[RECOVERY_STAGE_WARM_REBOOT]) <
+		     mean_ms(&st[RECOVERY_STAGE_COLD_REBOOT]), NULL);
+	zassert_true(mean_ms(&st[RECOVERY_STAGE_RESTART]) >= RESTART_HEAL_MS, NULL);
+	zassert_true(mean_ms(&st[RECOVERY_STAGE_REINIT]) >=
+		     CONFIG_APP_RECOVERY_STAGE_TIMEOUT_MS + REINIT_HEAL_MS, NULL);
+	zassert_true(mean_ms(&st[RECOVERY_STAGE_WARM_REBOOT]) >=
+		     2 * CONFIG_APP_RECOVERY_STAGE_TIMEOUT_MS + BOOT_MS, NULL);
+
+	/* Warm rungs hand the cache over; cold ones only flush. */
+	zassert_equal(reboots[0] - warm_before, 2 * INCIDENTS_PER_STAGE, NULL);
+	zassert_equal(reboots[1] - cold_before, INCIDENTS_PER_STAGE, NULL);
+	zassert_equal(stub_warm_prepares - prepares_before, 2U * INCIDENTS_PER_STAGE, NULL);
+	zassert_equal(stub_flushes - flushes_before, INCIDENTS_PER_STAGE, NULL);
+}
+
+static void wait_for_warm_reboot(int before)
+{
+	int64_t limit = k_uptime_get() + INCIDENT_LIMIT_MS;
+
+	while (reboots[0] == before && k_uptime_get() < limit) {
+		k_msleep(5);
+	}
+	zassert_equal(reboots[0], before + 1, "no reboot");
+	/* Let fake_reboot() finish its simulated boot. */
+	k_msleep(BOOT_MS + 20);
+}
+
+ZTEST(recovery_suite, test_reboot_prep_waits_only_for_hooks)
+{
+	struct recovery_reboot_prep prep;
+	int before = reboots[0];
+
+	/* Chain: reason, slow hook, persist. */
+	recovery_request(RECOVERY_REASON_MANUAL_TRIGGER);
+	wait_for_warm_reboot(before);
+	recovery_test_last_reboot_prep(&prep);
+	TC_PRINT("reboot prep: hooks_ms=%u drain_ms=%u (deadline %u ms)\n", prep.hooks_ms,
+		 prep.drain_ms, CONFIG_APP_RECOVERY_REBOOT_DEADLINE_MS);
+	zassert_equal(prep.late_mask, 0U, NULL);
+	zassert_equal(prep.failed_mask, 0U, NULL);
+	zassert_true(prep.hooks_ms < CONFIG_APP_RECOVERY_REBOOT_DEADLINE_MS / 2U,
+		     "reboot waited longer than its hooks needed");
+
+	/* A hook that never completes is cut off at the deadline. */
+	hook_stuck = true;
+	before = reboots[0];
+	recovery_request(RECOVERY_REASON_MANUAL_TRIGGER);
+	wait_for_warm_reboot(before);
+	hook_stuck = false;
+	recovery_test_last_reboot_prep(&prep);
+	TC_PRINT("stuck hook: hooks_ms=%u late=0x%x\n", prep.hooks_ms, prep.late_mask);
+	zassert_equal(prep.late_mask, BIT(1), NULL);
+	zassert_true(prep.hooks_ms >= CONFIG_APP_RECOVERY_REBOOT_DEADLINE_MS, NULL);
+	zassert_true(prep.hooks_ms < CONFIG_APP_RECOVERY_REBOOT_DEADLINE_MS + 20U, NULL);
+}
+
+ZTEST(recovery_suite, test_relapse_resumes_next_rung)
+{
+	struct recovery_stage_stats reinit_before;
+	struct recovery_stage_stats reinit_after;
+
+	run_incident(RECOVERY_STAGE_RESTART);
+	recovery_get_stage_stats(RECOVERY_STAGE_REINIT, &reinit_before);
+
+	/* Cured by a restart, then stale again inside the stable window. */
+	cure_stage = RECOVERY_STAGE_RESTART;
+	recovery_report_task_fault(TEST_TASK_MASK);
+	k_msleep(RESTART_HEAL_MS + 20);
+	zassert_equal(stub_escalation.stage, RECOVERY_STAGE_RESTART, NULL);
+	zassert_true(recovery_holds_watchdog() == false, "hold must end on recovery");
+
+	recovery_report_task_fault(TEST_TASK_MASK);
+	k_msleep(10);
+	zassert_equal(stub_escalation.stage, RECOVERY_STAGE_REINIT, "relapse must move up");
+	zassert_equal(action_thread, &k_sys_work_q.thread,
+		      "actions must run on the workqueue, not the recovery stack");
+	zassert_true(recovery_holds_watchdog(), "in-place rung must hold the watchdog");
+
+	k_msleep(REINIT_HEAL_MS + 20);
+	recovery_get_stage_stats(RECOVERY_STAGE_REINIT, &reinit_after);
+	zassert_equal(reinit_after.recovered, reinit_before.recovered + 1U, NULL);
+	zassert_equal(reinit_after.attempts, reinit_before.attempts + 1U, NULL);
+
+	k_msleep(CONFIG_APP_RECOVERY_STABLE_MS + 50);
+	zassert_equal(stub_escalation.stage, RECOVERY_STAGE_NONE, NULL);
+}
+
+ZTEST_SUITE(recovery_suite, NULL, recovery_setup, NULL, NULL, NULL);
@@ -0,0 +1,34 @@
+#include <zephyr/kernel.h>
+#include <zephyr/sys/util.h>
+
+#include "persist_state.h"
+
+/* In-RAM stand-in for the NVS escalation record; survives
+ * recovery_test_reboot() the way flash survives a reset.
+ */
+struct persist_state_escalation stub_escalation;
+uint32_t stub_warm_prepares;
+uint32_t stub_flushes;
+
+int persist_state_set_escalation(const struct persist_state_escalation *in)
+{
+	stub_escalation = *in;
+	return 0;
+}
+
+void persist_state_get_escalation(struct persist_state_escalation *out)
+{
+	*out = stub_escalation;
+}
+
+int persist_state_prepare_warm_reboot(void)
+{
+	stub_warm_prepares++;
+	return 0;
+}
+
+int persist_state_flush(void)
+{
+	stub_flushes++;
+	return 0;
+}
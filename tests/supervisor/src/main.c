@@ -1,10 +1,42 @@
+#include <errno.h>
+
+#include <zephyr/sys/atomic.h>
 #include <zephyr/ztest.h>
 
+#include "supervisor.h"
 #include "supervisor_test.h"
 
+/* Supervisor timing in CONFIG_ZTEST builds (see src/supervisor.c). */
+#define TEST_PERIOD_MS 50
+#define TEST_BOOT_GRACE_MS 150
+#define TEST_HEARTBEAT_MS 20
+
+extern atomic_t stub_feed_count;
+extern atomic_t stub_recovery_count;
+extern int64_t stub_recovery_ts;
+extern atomic_t stub_retune_timeout_ms;
+extern atomic_t stub_wdt_timeout_ms;
+extern atomic_t stub_retune_busy_polls;
+extern atomic_t stub_retune_poll_count;
+
 static void supervisor_fixture_reset(void)
 {
 	supervisor_test_set_last_seen(0U, 0U);
+	atomic_set(&stub_wdt_timeout_ms, 0);
+	atomic_set(&stub_retune_busy_polls, 0);
+	atomic_set(&stub_retune_poll_count, 0);
+}
+
+static uint32_t count_feeds_over(uint32_t window_ms)
+{
+	int64_t start = k_uptime_get();
+
+	atomic_set(&stub_feed_count, 0);
+	while ((k_uptime_get() - start) < window_ms) {
+		supervisor_notify_system_alive();
+		k_msleep(TEST_HEARTBEAT_MS / 2);
+	}
+	return (uint32_t)atomic_get(&stub_feed_count);
 }
 
 ZTEST(supervisor_suite, test_led_and_hb_fresh)
@@ -47,4 +79,198 @@ ZTEST(supervisor_suite, test_heartbeat_stale)
 	zassert_true(snapshot.led_ok, "LED is still healthy");
 }
 
+ZTEST(supervisor_suite, test_heartbeat_expiry_detection_latency)
+{
+	atomic_set(&stub_feed_count, 0);
+	atomic_set(&stub_recovery_count, 0);
+	supervisor_test_reset();
+
+	int64_t start = k_uptime_get();
+
+	supervisor_start(1000U, 0U, false);
+
+	/* Healthy phase past boot grace: producers only store timestamps. */
+	while ((k_uptime_get() - start) < (TEST_BOOT_GRACE_MS + 1000)) {
+		supervisor_notify_system_alive();
+		k_msleep(TEST_HEARTBEAT_MS);
+	}
+	supervisor_notify_system_alive();
+	int64_t last_beat = k_uptime_get();
+	uint32_t wakeups = supervisor_test_wakeups();
+	uint32_t feeds = (uint32_t)atomic_get(&stub_feed_count);
+
+	zassert_equal(atomic_get(&stub_recovery_count), 0, "healthy phase must not escalate");
+	zassert_true(feeds > 0U, "watchdog was never fed");
+	/* Heartbeats must not wake the supervisor: only feeds, grace end and
+	 * the initial retune do.
+	 */
+	zassert_true(wakeups <= feeds + 3U, "wakeups=%u feeds=%u", wakeups, feeds);
+
+	/* Stop the heartbeat and wait well past the stale threshold. */
+	int64_t limit = last_beat + CONFIG_APP_HEALTH_SYS_STALE_MS + (4 * TEST_PERIOD_MS);
+
+	while (atomic_get(&stub_recovery_count) == 0 && k_uptime_get() < limit) {
+		k_msleep(1);
+	}
+
+	zassert_true(atomic_get(&stub_recovery_count) > 0, "stale heartbeat not detected");
+
+	int64_t latency = stub_recovery_ts - (last_beat + CONFIG_APP_HEALTH_SYS_STALE_MS);
+
+	TC_PRINT("detection latency %lld ms past stale threshold (poll period %d ms)\n",
+		 (long long)latency, TEST_PERIOD_MS);
+	zassert_true(latency >= 0, "escalated before the heartbeat went stale");
+	zassert_true(latency <= 15, "detection latency %lld ms", (long long)latency);
+
+	supervisor_test_reset();
+}
+
+ZTEST(supervisor_suite, test_registered_task_expiry_escalates)
+{
+	const uint32_t stale_ms = 300U;
+
+	atomic_set(&stub_recovery_count, 0);
+	supervisor_test_reset();
+
+	int worker = supervisor_register_task("worker", stale_ms);
+	int spare = supervisor_register_task("spare", stale_ms);
+
+	zassert_true(worker >= 0 && spare >= 0, "registration failed (%d, %d)", worker, spare);
+	zassert_not_equal(worker, spare, NULL);
+	zassert_equal(supervisor_register_task("overflow", stale_ms), -ENOMEM,
+		      "registry must be bounded by CONFIG_APP_SUPERVISOR_MAX_TASKS");
+
+	int64_t start = k_uptime_get();
+
+	supervisor_start(1000U, 0U, false);
+	while ((k_uptime_get() - start) < (TEST_BOOT_GRACE_MS + 500)) {
+		supervisor_notify_system_alive();
+		supervisor_task_alive(worker);
+		supervisor_task_alive(spare);
+		k_msleep(TEST_HEARTBEAT_MS);
+	}
+	zassert_equal(atomic_get(&stub_recovery_count), 0, "healthy phase must not escalate");
+
+	/* Only the worker stops checking in. */
+	supervisor_task_alive(worker);
+	int64_t last_beat = k_uptime_get();
+	int64_t limit = last_beat + stale_ms + (4 * TEST_PERIOD_MS);
+
+	while (atomic_get(&stub_recovery_count) == 0 && k_uptime_get() < limit) {
+		supervisor_notify_system_alive();
+		supervisor_task_alive(spare);
+		k_msleep(TEST_HEARTBEAT_MS / 2);
+	}
+
+	zassert_true(atomic_get(&stub_recovery_count) > 0, "stale worker not detected");
+
+	int64_t latency = stub_recovery_ts - (last_beat + stale_ms);
+
+	zassert_true(latency >= 0 && latency <= 15, "worker detection latency %lld ms",
+		     (long long)latency);
+
+	supervisor_test_reset();
+}
+
+ZTEST(supervisor_suite, test_watchdog_target_published_to_thread)
+{
+	supervisor_test_reset();
+	supervisor_start(1000U, 0U, false);
+	zassert_equal(supervisor_get_watchdog_target(), 1000U, NULL);
+
+	/* Each request is visible to readers as soon as the call returns. */
+	for (uint32_t target = 1100U; target <= 1500U; target += 100U) {
+		zassert_ok(supervisor_request_watchdog_target(target, true), NULL);
+		zassert_equal(supervisor_get_watchdog_target(), target, NULL);
+	}
+
+	/* The thread wakes on the request and applies the latest generation. */
+	for (int i = 0; i < 10 && atomic_get(&stub_retune_timeout_ms) != 1500; i++) {
+		supervisor_notify_system_alive();
+		k_msleep(1);
+	}
+	zassert_equal(atomic_get(&stub_retune_timeout_ms), 1500, "latest target not applied");
+
+	supervisor_test_reset();
+}
+
+ZTEST(supervisor_suite, test_feed_interval_follows_timeout)
+{
+	supervisor_test_reset();
+	atomic_set(&stub_wdt_timeout_ms, 2000);
+
+	/* Retunes to 100 ms right away: feed every 40 ms at the default 40 %. */
+	supervisor_start(100U, 0U, false);
+	(void)count_feeds_over(TEST_BOOT_GRACE_MS);
+
+	uint32_t interval = (100U * CONFIG_APP_WATCHDOG_FEED_PERCENT) / 100U;
+	uint32_t feeds = count_feeds_over(20U * interval);
+
+	zassert_within(feeds, 20U, 1U, "tight timeout: %u feeds in %u intervals", feeds, 20U);
+
+	/* A long override re-plans to a sparse cadence on retune. */
+	zassert_ok(supervisor_request_watchdog_target(1000U, true), NULL);
+	k_msleep(1);
+	interval = (1000U * CONFIG_APP_WATCHDOG_FEED_PERCENT) / 100U;
+	feeds = count_feeds_over(3U * interval);
+	zassert_within(feeds, 3U, 1U, "long timeout: %u feeds in 3 intervals", feeds);
+
+	supervisor_test_reset();
+}
+
+ZTEST(supervisor_suite, test_retune_polls_without_blocking)
+{
+	supervisor_test_reset();
+	atomic_set(&stub_wdt_timeout_ms, 2000);
+	atomic_set(&stub_retune_busy_polls, 4);
+
+	int64_t start = k_uptime_get();
+
+	supervisor_start(100U, 0U, false);
+	/* The heartbeat keeps running while the update is in flight. */
+	while (atomic_get(&stub_wdt_timeout_ms) != 100) {
+		zassert_true((k_uptime_get() - start) < TEST_BOOT_GRACE_MS,
+			     "retune never completed");
+		supervisor_notify_system_alive();
+		k_msleep(1);
+	}
+
+	TC_PRINT("retune completed after %u polls in %lld ms\n",
+		 (uint32_t)atomic_get(&stub_retune_poll_count),
+		 (long long)(k_uptime_get() - start));
+	zassert_equal(atomic_get(&stub_retune_poll_count), 4, NULL);
+	zassert_equal(supervisor_get_watchdog_target(), 100U, NULL);
+
+	supervisor_test_reset();
+}
+
+ZTEST(supervisor_suite, test_heartbeat_jitter_histogram)
+{
+	struct supervisor_jitter_snapshot snap;
+
+	supervisor_test_reset();
+	/* A zero timestamp means "never seen"; the first beat only stamps. */
+	supervisor_notify_system_alive();
+	for (int i = 0; i < 10; i++) {
+		k_msleep(TEST_HEARTBEAT_MS);
+		supervisor_notify_system_alive();
+	}
+	k_msleep(3 * TEST_HEARTBEAT_MS);
+	supervisor_notify_system_alive();
+
+	zassert_ok(supervisor_test_jitter(0, &snap), NULL);
+	TC_PRINT("jitter: samples=%u p50=%u p99=%u max=%u\n", snap.samples, snap.p50_ms,
+		 snap.p99_ms, snap.max_ms);
+	zassert_equal(snap.samples, 11U, NULL);
+	/* 20 ms falls in the [16, 31] bucket. */
+	zassert_between_inclusive(snap.p50_ms, 16U, 31U, NULL);
+	zassert_between_inclusive(snap.max_ms, 3U * TEST_HEARTBEAT_MS, 3U * TEST_HEARTBEAT_MS + 5U,
+				  NULL);
+	zassert_equal(snap.p99_ms, snap.max_ms, "p99 must land in the outlier's bucket");
+	zassert_ok(supervisor_test_jitter(1, &snap), NULL);
+	zassert_equal(snap.samples, 0U, "LED slot never checked in");
+
+	supervisor_test_reset();
+}
+
 ZTEST_SUITE(supervisor_suite, NULL, NULL, supervisor_fixture_reset, supervisor_fixture_reset, NULL);
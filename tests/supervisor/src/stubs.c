@@ -1,9 +1,24 @@
+#include <errno.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/atomic.h>
 #include <zephyr/sys/util.h>
 
 #include "persist_state.h"
 #include "recovery.h"
 #include "watchdog_ctrl.h"
 
+/* Observed by tests/supervisor/src/main.c. */
+atomic_t stub_feed_count = ATOMIC_INIT(0);
+atomic_t stub_recovery_count = ATOMIC_INIT(0);
+int64_t stub_recovery_ts;
+atomic_t stub_retune_timeout_ms = ATOMIC_INIT(0);
+atomic_t stub_wdt_timeout_ms = ATOMIC_INIT(0);
+/* Polls a retune stays in flight; 0 completes it in retune_start(). */
+atomic_t stub_retune_busy_polls = ATOMIC_INIT(0);
+atomic_t stub_retune_poll_count = ATOMIC_INIT(0);
+static atomic_t stub_retune_left = ATOMIC_INIT(0);
+
 int watchdog_ctrl_init(uint32_t timeout_ms)
 {
 	ARG_UNUSED(timeout_ms);
@@ -12,6 +27,7 @@ int watchdog_ctrl_init(uint32_t timeout_ms)
 
 int watchdog_ctrl_feed(void)
 {
+	(void)atomic_inc(&stub_feed_count);
 	return 0;
 }
 
@@ -25,22 +41,72 @@ bool watchdog_ctrl_is_enabled(void)
 	return true;
 }
 
-int watchdog_ctrl_retune(uint32_t timeout_ms)
+int watchdog_ctrl_retune_start(uint32_t timeout_ms)
 {
-	ARG_UNUSED(timeout_ms);
+	atomic_set(&stub_retune_timeout_ms, (atomic_val_t)timeout_ms);
+	if (atomic_get(&stub_retune_busy_polls) > 0) {
+		atomic_set(&stub_retune_left, atomic_get(&stub_retune_busy_polls));
+		return -EINPROGRESS;
+	}
+	atomic_set(&stub_wdt_timeout_ms, (atomic_val_t)timeout_ms);
+	return 0;
+}
+
+int watchdog_ctrl_retune_poll(void)
+{
+	(void)atomic_inc(&stub_retune_poll_count);
+	if (atomic_dec(&stub_retune_left) > 1) {
+		return -EINPROGRESS;
+	}
+	atomic_set(&stub_wdt_timeout_ms, atomic_get(&stub_retune_timeout_ms));
 	return 0;
 }
 
 uint32_t watchdog_ctrl_get_timeout(void)
 {
-	return 0U;
+	return (uint32_t)atomic_get(&stub_wdt_timeout_ms);
 }
 
 void persist_state_clear_watchdog_counter(void)
 {
 }
 
+void persist_state_watchdog_fed(uint32_t timeout_ms)
+{
+	ARG_UNUSED(timeout_ms);
+}
+
+int persist_state_note_task_fault(uint8_t slot)
+{
+	ARG_UNUSED(slot);
+	return 1;
+}
+
+uint32_t persist_state_get_task_faults(uint8_t slot)
+{
+	ARG_UNUSED(slot);
+	return 0U;
+}
+
 void recovery_request(enum recovery_reason reason)
 {
 	ARG_UNUSED(reason);
+	if (atomic_inc(&stub_recovery_count) == 0) {
+		stub_recovery_ts = k_uptime_get();
+	}
+}
+
+void recovery_report_task_fault(uint32_t stale_mask)
+{
+	ARG_UNUSED(stale_mask);
+	recovery_request(RECOVERY_REASON_HEALTH_FAULT);
+}
+
+void recovery_report_healthy(void)
+{
+}
+
+bool recovery_holds_watchdog(void)
+{
+	return false;
 }
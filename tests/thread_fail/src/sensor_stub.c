@@ -6,6 +6,7 @@
 
 #include "app_crypto.h"
 #include "log_utils.h"
+#include "sensor_hts221.h"
 #include "supervisor.h"
 
 LOG_MODULE_REGISTER(sensor_stub, LOG_LEVEL_INF);
@@ -145,3 +146,20 @@ int sensor_hts221_start(bool safe_mode_active)
     k_work_schedule(&stub_work, K_NO_WAIT);
     return 0;
 }
+
+/* Restarting the work item only re-runs the wedged handler; a reinit
+ * resets the stub so the ladder's reinit rung is what clears the hang.
+ */
+int sensor_hts221_restart(void)
+{
+	int rc = k_work_reschedule(&stub_work, K_NO_WAIT);
+
+	return (rc < 0) ? rc : 0;
+}
+
+int sensor_hts221_reinit(void)
+{
+	(void)k_work_cancel_delayable(&stub_work);
+	stub_running = false;
+	return sensor_hts221_start(false);
+}
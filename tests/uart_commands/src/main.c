@@ -0,0 +1,357 @@
+#include <string.h>
+
+#include <zephyr/device.h>
+#include <zephyr/drivers/serial/uart_emul.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/sys/crc.h>
+#include <zephyr/ztest.h>
+
+#include "curve25519_ref10.h"
+#include "uart_commands.h"
+#include "uart_frame.h"
+
+extern uint32_t stub_override_calls;
+extern uint32_t stub_override_last;
+extern uint32_t stub_override_sum;
+extern uint8_t stub_secret[CURVE25519_KEY_SIZE];
+extern uint8_t stub_peer[CURVE25519_KEY_SIZE];
+extern uint32_t stub_secret_calls;
+extern uint32_t stub_peer_calls;
+
+#define TEST_LINE "wdg 1234\r\n"
+#define TEST_LINE_MS 1234U
+#define TEST_LINE_LEN (sizeof(TEST_LINE) - 1U)
+/* As stored in the ring: CR LF collapses to one terminator. */
+#define TEST_LINE_STORED (TEST_LINE_LEN - 1U)
+
+/* One line per millisecond is ~10 kB/s, just under 115200 baud. */
+#define PACED_LINES 200U
+/* Three ring's worth in a single burst. */
+#define BURST_LINES ((3U * CONFIG_APP_UART_RX_RING_SIZE) / TEST_LINE_LEN)
+#define DRAIN_LIMIT_MS 1000
+
+static const struct device *const emul = DEVICE_DT_GET(DT_CHOSEN(app_command_uart));
+
+static void put_rx(const char *data, size_t len)
+{
+	uint32_t put = uart_emul_put_rx_data(emul, (const uint8_t *)data, len);
+
+	zassert_equal(put, len, "emulator FIFO full");
+}
+
+/* Wait until the parser has applied `target` overrides; returns ms waited. */
+static int64_t wait_for_overrides(uint32_t target)
+{
+	int64_t start = k_uptime_get();
+
+	while (stub_override_calls < target && k_uptime_get() - start < DRAIN_LIMIT_MS) {
+		k_msleep(1);
+	}
+	return k_uptime_get() - start;
+}
+
+static size_t build_frame(uint8_t op, uint8_t seq, const uint8_t *payload, size_t len,
+			  uint8_t *out)
+{
+	out[0] = UART_FRAME_SOF;
+	out[1] = (uint8_t)(UART_FRAME_MIN_BODY + len);
+	out[2] = op;
+	out[3] = seq;
+	if (len != 0U) {
+		memcpy(&out[4], payload, len);
+	}
+	sys_put_le16(crc16_itu_t(0U, &out[1], 1U + out[1]), &out[4 + len]);
+	return UART_FRAME_HDR_LEN + out[1] + UART_FRAME_CRC_LEN;
+}
+
+/* Waits for one response frame on the emulator's TX side; returns its
+ * status, with the payload copied to payload if non-NULL.
+ */
+static int read_response(uint8_t op, uint8_t seq, uint8_t *payload, size_t *payload_len)
+{
+	uint8_t resp[UART_FRAME_MAX_LEN];
+	size_t len = 0U;
+	int64_t start = k_uptime_get();
+
+	while (k_uptime_get() - start < DRAIN_LIMIT_MS) {
+		len += uart_emul_get_tx_data(emul, &resp[len], sizeof(resp) - len);
+		if (len >= UART_FRAME_HDR_LEN &&
+		    len >= UART_FRAME_HDR_LEN + resp[1] + UART_FRAME_CRC_LEN) {
+			break;
+		}
+		k_msleep(1);
+	}
+
+	struct uart_frame frame;
+
+	zassert_true(len > UART_FRAME_HDR_LEN, "no response");
+	zassert_equal(uart_frame_decode(resp, len, &frame), 0, "response does not decode");
+	zassert_equal(frame.op, op | UART_FRAME_RESPONSE, NULL);
+	zassert_equal(frame.seq, seq, NULL);
+	zassert_true(frame.len >= 1U, "response without status");
+	if (payload != NULL) {
+		memcpy(payload, &frame.payload[1], frame.len - 1U);
+		*payload_len = frame.len - 1U;
+	}
+	return frame.payload[0];
+}
+
+static void *uart_commands_setup(void)
+{
+	zassert_true(device_is_ready(emul), NULL);
+	uart_commands_start(false);
+	/* Let the command thread reach its first wait. */
+	k_msleep(10);
+	return NULL;
+}
+
+ZTEST(uart_commands_suite, test_paced_lines_throughput)
+{
+	struct uart_commands_rx_stats before;
+	struct uart_commands_rx_stats after;
+	uint32_t calls = stub_override_calls;
+
+	uart_commands_get_rx_stats(&before);
+
+	int64_t start = k_uptime_get();
+
+	for (uint32_t i = 0U; i < PACED_LINES; i++) {
+		put_rx(TEST_LINE, TEST_LINE_LEN);
+		k_msleep(1);
+	}
+	uint32_t tail_ms = (uint32_t)wait_for_overrides(calls + PACED_LINES);
+	uint32_t elapsed_ms = MAX((uint32_t)(k_uptime_get() - start), 1U);
+
+	uart_commands_get_rx_stats(&after);
+
+	uint32_t bytes = after.bytes - before.bytes;
+
+	TC_PRINT("paced: lines=%u bytes=%u elapsed_ms=%u bytes_per_s=%u tail_ms=%u dropped=%u\n",
+		 after.lines - before.lines, bytes, elapsed_ms, (bytes * 1000U) / elapsed_ms,
+		 tail_ms, after.dropped - before.dropped);
+
+	zassert_equal(stub_override_calls - calls, PACED_LINES, NULL);
+	zassert_equal(bytes, PACED_LINES * TEST_LINE_LEN, NULL);
+	zassert_equal(after.lines - before.lines, PACED_LINES, NULL);
+	zassert_equal(after.dropped, before.dropped, NULL);
+	zassert_equal(after.overruns, before.overruns, NULL);
+}
+
+ZTEST(uart_commands_suite, test_burst_drops_whole_lines)
+{
+	static char burst[BURST_LINES * TEST_LINE_LEN];
+	struct uart_commands_rx_stats before;
+	struct uart_commands_rx_stats after;
+	uint32_t calls = stub_override_calls;
+	uint32_t sum = stub_override_sum;
+
+	for (uint32_t i = 0U; i < BURST_LINES; i++) {
+		memcpy(&burst[i * TEST_LINE_LEN], TEST_LINE, TEST_LINE_LEN);
+	}
+
+	uart_commands_get_rx_stats(&before);
+	put_rx(burst, sizeof(burst));
+	k_msleep(50);
+	uart_commands_get_rx_stats(&after);
+
+	uint32_t lines = after.lines - before.lines;
+	uint32_t overruns = after.overruns - before.overruns;
+	uint32_t dropped = after.dropped - before.dropped;
+
+	TC_PRINT("burst: sent_lines=%u ring=%u lines=%u overruns=%u dropped=%u\n",
+		 (uint32_t)BURST_LINES, CONFIG_APP_UART_RX_RING_SIZE, lines, overruns,
+		 dropped);
+
+	zassert_true(overruns > 0U, "burst fit the ring");
+	zassert_equal(lines + overruns, BURST_LINES, NULL);
+	/* Each lost line is counted up to its CR; the LF is a blank line. */
+	zassert_equal(dropped, overruns * TEST_LINE_STORED, NULL);
+	/* Only whole commands reach the parser. */
+	zassert_equal(stub_override_calls - calls, lines, NULL);
+	zassert_equal(stub_override_sum - sum, lines * TEST_LINE_MS, NULL);
+
+	/* The next line after the burst goes through untouched. */
+	put_rx("wdg 2345\r\n", 10U);
+	(void)wait_for_overrides(calls + lines + 1U);
+	zassert_equal(stub_override_last, 2345U, NULL);
+}
+
+ZTEST(uart_commands_suite, test_frame_ack_and_nak)
+{
+	uint8_t frame[UART_FRAME_MAX_LEN];
+	uint8_t payload[UART_FRAME_MAX_BODY];
+	uint8_t arg[4];
+	size_t payload_len = 0U;
+	size_t len;
+
+	uart_emul_flush_tx_data(emul);
+
+	len = build_frame(UART_FRAME_OP_PING, 1U, NULL, 0U, frame);
+	put_rx((const char *)frame, len);
+	zassert_equal(read_response(UART_FRAME_OP_PING, 1U, payload, &payload_len),
+		      UART_FRAME_OK, NULL);
+	zassert_equal(payload_len, 2U, NULL);
+	zassert_equal(payload[0], UART_FRAME_VERSION, NULL);
+
+	uint32_t calls = stub_override_calls;
+
+	sys_put_le32(1500U, arg);
+	len = build_frame(UART_FRAME_OP_SET_OVERRIDE, 2U, arg, sizeof(arg), frame);
+	put_rx((const char *)frame, len);
+	zassert_equal(read_response(UART_FRAME_OP_SET_OVERRIDE, 2U, NULL, NULL), UART_FRAME_OK,
+		      NULL);
+	zassert_equal(stub_override_calls, calls + 1U, NULL);
+	zassert_equal(stub_override_last, 1500U, NULL);
+
+	/* Out of range: NAKed, nothing stored. */
+	sys_put_le32(50U, arg);
+	len = build_frame(UART_FRAME_OP_SET_OVERRIDE, 3U, arg, sizeof(arg), frame);
+	put_rx((const char *)frame, len);
+	zassert_equal(read_response(UART_FRAME_OP_SET_OVERRIDE, 3U, NULL, NULL),
+		      UART_FRAME_BAD_ARG, NULL);
+	zassert_equal(stub_override_calls, calls + 1U, NULL);
+
+	/* Key opcodes need the Curve25519 backend. */
+	memset(payload, 0x42, CURVE25519_KEY_SIZE);
+	len = build_frame(UART_FRAME_OP_SET_SECRET, 4U, payload, CURVE25519_KEY_SIZE, frame);
+	put_rx((const char *)frame, len);
+	zassert_equal(read_response(UART_FRAME_OP_SET_SECRET, 4U, NULL, NULL),
+		      IS_ENABLED(CONFIG_APP_CRYPTO_BACKEND_CURVE25519) ? UART_FRAME_OK
+								    : UART_FRAME_UNSUPPORTED,
+		      NULL);
+
+	len = build_frame(0x7EU, 5U, NULL, 0U, frame);
+	put_rx((const char *)frame, len);
+	zassert_equal(read_response(0x7EU, 5U, NULL, NULL), UART_FRAME_UNKNOWN_OP, NULL);
+}
+
+ZTEST(uart_commands_suite, test_frame_crc_and_resync)
+{
+	uint8_t frame[UART_FRAME_MAX_LEN];
+	uint8_t arg[4];
+	struct uart_commands_rx_stats before;
+	struct uart_commands_rx_stats after;
+	uint32_t calls = stub_override_calls;
+	size_t len;
+
+	uart_emul_flush_tx_data(emul);
+	uart_commands_get_rx_stats(&before);
+
+	/* A damaged frame is NAKed and not acted on. */
+	sys_put_le32(2500U, arg);
+	len = build_frame(UART_FRAME_OP_SET_OVERRIDE, 9U, arg, sizeof(arg), frame);
+	frame[4] ^= 0x01U;
+	put_rx((const char *)frame, len);
+	zassert_equal(read_response(UART_FRAME_OP_SET_OVERRIDE, 9U, NULL, NULL),
+		      UART_FRAME_BAD_CRC, NULL);
+	zassert_equal(stub_override_calls, calls, NULL);
+
+	/* SOF cuts a partial text line short; the frame still goes through,
+	 * and the line after it is parsed as usual.
+	 */
+	put_rx("wdg 77", 6U);
+	frame[4] ^= 0x01U;
+	put_rx((const char *)frame, len);
+	zassert_equal(read_response(UART_FRAME_OP_SET_OVERRIDE, 9U, NULL, NULL), UART_FRAME_OK,
+		      NULL);
+	zassert_equal(stub_override_last, 2500U, NULL);
+
+	put_rx("wdg 3456\r\n", 10U);
+	(void)wait_for_overrides(calls + 2U);
+	zassert_equal(stub_override_last, 3456U, NULL);
+
+	uart_commands_get_rx_stats(&after);
+	zassert_equal(after.frames - before.frames, 2U, NULL);
+	zassert_equal(after.lines - before.lines, 1U, NULL);
+	zassert_equal(after.dropped - before.dropped, 6U, "partial line not counted");
+	zassert_equal(after.overruns, before.overruns, NULL);
+}
+
+/* RFC 7748 section 6.1, Alice. */
+static const uint8_t alice_secret[CURVE25519_KEY_SIZE] = {
+	0x77, 0x07, 0x6d, 0x0a, 0x73, 0x18, 0xa5, 0x7d, 0x3c, 0x16, 0xc1, 0x72, 0x51, 0xb2, 0x66, 0x45,
+	0xdf, 0x4c, 0x2f, 0x87, 0xeb, 0xc0, 0x99, 0x2a, 0xb1, 0x77, 0xfb, 0xa5, 0x1d, 0xb9, 0x2c, 0x2a,
+};
+static const uint8_t alice_public[CURVE25519_KEY_SIZE] = {
+	0x85, 0x20, 0xf0, 0x09, 0x89, 0x30, 0xa7, 0x54, 0x74, 0x8b, 0x7d, 0xdc, 0xb4, 0x3e, 0xf7, 0x5a,
+	0x0d, 0xbf, 0x3a, 0x0d, 0x26, 0x38, 0x1a, 0xf4, 0xeb, 0xa4, 0xa9, 0x8e, 0xaa, 0x9b, 0x4e, 0x6a,
+};
+
+ZTEST(uart_commands_suite, test_frame_read_pubkey)
+{
+	uint8_t frame[UART_FRAME_MAX_LEN];
+	uint8_t payload[UART_FRAME_MAX_BODY];
+	size_t payload_len = 0U;
+	size_t len;
+
+	if (!IS_ENABLED(CONFIG_APP_CRYPTO_BACKEND_CURVE25519)) {
+		ztest_test_skip();
+	}
+
+	uart_emul_flush_tx_data(emul);
+
+	len = build_frame(UART_FRAME_OP_SET_SECRET, 20U, alice_secret, sizeof(alice_secret),
+			  frame);
+	put_rx((const char *)frame, len);
+	zassert_equal(read_response(UART_FRAME_OP_SET_SECRET, 20U, NULL, NULL), UART_FRAME_OK,
+		      NULL);
+
+	len = build_frame(UART_FRAME_OP_READ_PUBKEY, 21U, NULL, 0U, frame);
+	put_rx((const char *)frame, len);
+	zassert_equal(read_response(UART_FRAME_OP_READ_PUBKEY, 21U, payload, &payload_len),
+		      UART_FRAME_OK, NULL);
+	zassert_equal(payload_len, CURVE25519_KEY_SIZE, NULL);
+	zassert_mem_equal(payload, alice_public, CURVE25519_KEY_SIZE, NULL);
+}
+
+static void wait_for_keys(uint32_t secrets, uint32_t peers)
+{
+	int64_t start = k_uptime_get();
+
+	while ((stub_secret_calls < secrets || stub_peer_calls < peers) &&
+	       k_uptime_get() - start < DRAIN_LIMIT_MS) {
+		k_msleep(1);
+	}
+}
+
+ZTEST(uart_commands_suite, test_prov_line_streams)
+{
+	static const char line[] =
+		"  prov curve 77076d0a7318a57d3c16c17251b26645df4c2f87ebc0992ab177fba51db92c2a "
+		"8520F0098930A754748B7DDCB43EF75A0DBF3A0D26381AF4EBA4A98EAA9B4E6A\r\n";
+	uint32_t secrets = stub_secret_calls;
+	uint32_t peers = stub_peer_calls;
+	uint32_t calls = stub_override_calls;
+
+	if (!IS_ENABLED(CONFIG_APP_CRYPTO_BACKEND_CURVE25519)) {
+		ztest_test_skip();
+	}
+
+	/* Longer than the command buffer: decoded on the fly, never held. */
+	put_rx(line, sizeof(line) - 1U);
+	wait_for_keys(secrets + 1U, peers + 1U);
+	zassert_equal(stub_secret_calls, secrets + 1U, NULL);
+	zassert_equal(stub_peer_calls, peers + 1U, NULL);
+	zassert_mem_equal(stub_secret, alice_secret, CURVE25519_KEY_SIZE, NULL);
+	zassert_mem_equal(stub_peer, alice_public, CURVE25519_KEY_SIZE, NULL);
+
+	/* One digit short, then a bad digit: nothing is stored. */
+	put_rx("prov curve 77076d0a7318a57d3c16c17251b26645df4c2f87ebc0992ab177fba51db92c2\r\n",
+	       76U);
+	put_rx("prov curve 77076d0a7318a57d3c16c17251b26645df4c2f87ebc0992ab177fba51db92c2g\r\n",
+	       77U);
+	/* A scalar on its own is stored without touching the peer. */
+	put_rx("prov curve 00112233445566778899aabbccddeeff00112233445566778899aabbccddeeff\r\n",
+	       77U);
+	put_rx("wdg 4321\r\n", 10U);
+	(void)wait_for_overrides(calls + 1U);
+
+	zassert_equal(stub_override_last, 4321U, "line after prov not parsed");
+	zassert_equal(stub_secret_calls, secrets + 2U, NULL);
+	zassert_equal(stub_peer_calls, peers + 1U, NULL);
+	zassert_equal(stub_secret[0], 0x00U, NULL);
+	zassert_equal(stub_secret[31], 0xffU, NULL);
+}
+
+ZTEST_SUITE(uart_commands_suite, NULL, uart_commands_setup, NULL, NULL, NULL);
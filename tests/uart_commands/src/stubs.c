@@ -0,0 +1,89 @@
+#include <errno.h>
+#include <string.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/util.h>
+
+#include "persist_state.h"
+#include "supervisor.h"
+#include "watchdog_ctrl.h"
+
+/* Every `wdg <ms>` the parser accepts ends up here. */
+uint32_t stub_override_calls;
+uint32_t stub_override_last;
+uint32_t stub_override_sum;
+
+int persist_state_set_watchdog_override(uint32_t timeout_ms)
+{
+	stub_override_last = timeout_ms;
+	stub_override_sum += timeout_ms;
+	stub_override_calls++;
+	return 0;
+}
+
+/* Keys the parser stored; the AES-only image must answer "unsupported". */
+uint8_t stub_secret[CURVE25519_KEY_SIZE];
+uint8_t stub_peer[CURVE25519_KEY_SIZE];
+uint32_t stub_secret_calls;
+uint32_t stub_peer_calls;
+
+int persist_state_curve25519_set_secret(const uint8_t secret[CURVE25519_KEY_SIZE])
+{
+	if (!IS_ENABLED(CONFIG_APP_CRYPTO_BACKEND_CURVE25519)) {
+		return -ENOTSUP;
+	}
+	memcpy(stub_secret, secret, CURVE25519_KEY_SIZE);
+	stub_secret_calls++;
+	return 0;
+}
+
+int persist_state_curve25519_set_peer(const uint8_t peer[CURVE25519_KEY_SIZE])
+{
+	if (!IS_ENABLED(CONFIG_APP_CRYPTO_BACKEND_CURVE25519)) {
+		return -ENOTSUP;
+	}
+	memcpy(stub_peer, peer, CURVE25519_KEY_SIZE);
+	stub_peer_calls++;
+	return 0;
+}
+
+int persist_state_curve25519_get_secret(uint8_t out[CURVE25519_KEY_SIZE])
+{
+	if (!IS_ENABLED(CONFIG_APP_CRYPTO_BACKEND_CURVE25519)) {
+		return -ENOTSUP;
+	}
+	memcpy(out, stub_secret, CURVE25519_KEY_SIZE);
+	return 0;
+}
+
+uint32_t persist_state_get_watchdog_override(void)
+{
+	return stub_override_last;
+}
+
+uint32_t persist_state_get_consecutive_watchdog(void)
+{
+	return 0U;
+}
+
+void persist_state_get_stats(struct persist_state_stats *out)
+{
+	*out = (struct persist_state_stats){ 0 };
+}
+
+int supervisor_request_watchdog_target(uint32_t timeout_ms, bool apply_immediately)
+{
+	ARG_UNUSED(timeout_ms);
+	ARG_UNUSED(apply_immediately);
+	return 0;
+}
+
+uint32_t supervisor_get_watchdog_target(void)
+{
+	return CONFIG_APP_WATCHDOG_STEADY_TIMEOUT_MS;
+}
+
+uint32_t watchdog_ctrl_get_timeout(void)
+{
+	return CONFIG_APP_WATCHDOG_STEADY_TIMEOUT_MS;
+}
@@ -23,12 +23,17 @@ bool watchdog_ctrl_is_enabled(void)
 	return true;
 }
 
-int watchdog_ctrl_retune(uint32_t timeout_ms)
+int watchdog_ctrl_retune_start(uint32_t timeout_ms)
 {
 	ARG_UNUSED(timeout_ms);
 	return 0;
 }
 
+int watchdog_ctrl_retune_poll(void)
+{
+	return 0;
+}
+
 uint32_t watchdog_ctrl_get_timeout(void)
 {
 	return 0U;
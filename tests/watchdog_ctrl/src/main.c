@@ -0,0 +1,111 @@
+#include <errno.h>
+
+#include <zephyr/ztest.h>
+
+#include "prewatchdog.h"
+#include "supervisor.h"
+#include "watchdog_ctrl.h"
+
+/* 200 ms at LSI 32 kHz: prescaler /4, reload 1599. */
+#define TEST_TIMEOUT_MS 200U
+/* 4 s needs prescaler /32, so the register update takes ~5 ms. */
+#define TEST_LONG_TIMEOUT_MS 4000U
+
+/* prewatchdog.c records heartbeat ages; no supervisor in this suite. */
+uint32_t supervisor_task_age_ms(int handle)
+{
+	ARG_UNUSED(handle);
+	return UINT32_MAX;
+}
+
+static void feed_for(uint32_t duration_ms, uint32_t period_ms)
+{
+	int64_t start = k_uptime_get();
+
+	while ((k_uptime_get() - start) < duration_ms) {
+		zassert_ok(watchdog_ctrl_feed(), NULL);
+		k_msleep(period_ms);
+	}
+}
+
+static void watchdog_fixture_reset(void *fixture)
+{
+	ARG_UNUSED(fixture);
+	watchdog_ctrl_set_enabled(true);
+	(void)watchdog_ctrl_init(TEST_TIMEOUT_MS);
+}
+
+ZTEST(watchdog_ctrl_suite, test_sim_expires_only_when_starved)
+{
+	uint32_t base = watchdog_ctrl_sim_expiries();
+
+	feed_for(3U * TEST_TIMEOUT_MS, TEST_TIMEOUT_MS / 4U);
+	zassert_equal(watchdog_ctrl_sim_expiries(), base, "fed watchdog expired");
+
+	/* Feeds are refused while disabled, so the counter runs out. */
+	watchdog_ctrl_set_enabled(false);
+	zassert_equal(watchdog_ctrl_feed(), -EBUSY, NULL);
+	k_msleep(TEST_TIMEOUT_MS + 10U);
+	zassert_equal(watchdog_ctrl_sim_expiries(), base + 1U, "starved watchdog did not expire");
+}
+
+ZTEST(watchdog_ctrl_suite, test_retune_is_split_into_start_and_poll)
+{
+	uint32_t base = watchdog_ctrl_sim_expiries();
+
+	zassert_equal(watchdog_ctrl_retune_poll(), -EINVAL, "nothing in flight");
+	zassert_ok(watchdog_ctrl_retune_start(TEST_TIMEOUT_MS), "same timeout is a no-op");
+
+	int64_t start = k_uptime_get();
+
+	zassert_equal(watchdog_ctrl_retune_start(TEST_LONG_TIMEOUT_MS), -EINPROGRESS, NULL);
+	zassert_equal(watchdog_ctrl_retune_start(TEST_LONG_TIMEOUT_MS), -EBUSY, NULL);
+	zassert_equal(watchdog_ctrl_retune_poll(), -EINPROGRESS, NULL);
+	zassert_equal(watchdog_ctrl_get_timeout(), TEST_TIMEOUT_MS, "old timeout stays armed");
+
+	int rc;
+
+	do {
+		/* Feeding keeps working while the update is in flight. */
+		zassert_ok(watchdog_ctrl_feed(), NULL);
+		k_msleep(1);
+		rc = watchdog_ctrl_retune_poll();
+	} while (rc == -EINPROGRESS);
+
+	TC_PRINT("retune to %u ms took %lld ms\n", TEST_LONG_TIMEOUT_MS,
+		 (long long)(k_uptime_get() - start));
+	zassert_ok(rc, NULL);
+	zassert_equal(watchdog_ctrl_get_timeout(), TEST_LONG_TIMEOUT_MS, NULL);
+
+	/* Well past the old period, still inside the new one. */
+	k_msleep(5U * TEST_TIMEOUT_MS);
+	zassert_equal(watchdog_ctrl_sim_expiries(), base, "new period not applied");
+}
+
+ZTEST(watchdog_ctrl_suite, test_prewatchdog_names_starving_thread)
+{
+	struct prewatchdog_test_snapshot snap;
+	uint32_t threshold = (TEST_TIMEOUT_MS * CONFIG_APP_PREWATCHDOG_PERCENT) / 100U;
+
+	k_thread_name_set(k_current_get(), "hog");
+	/* Spin without feeding: the timer fires while this thread runs. */
+	k_busy_wait((threshold + 10U) * USEC_PER_MSEC);
+
+	zassert_ok(prewatchdog_test_last(&snap), "no snapshot taken");
+	TC_PRINT("preempt: thread=%s feed_age_ms=%u threads=%u\n", snap.thread,
+		 snap.feed_age_ms, snap.thread_count);
+	zassert_str_equal(snap.thread, "hog", NULL);
+	zassert_between_inclusive(snap.feed_age_ms, threshold, TEST_TIMEOUT_MS - 1U, NULL);
+	zassert_false(snap.recovered, NULL);
+	/* The timer only captured the hog; the walk waits for the workqueue. */
+	zassert_equal(snap.thread_count, 1U, "threads walked from the timer");
+
+	/* A late feed before the IWDG fires marks the snapshot as recovered. */
+	feed_for(2U * threshold, TEST_TIMEOUT_MS / 4U);
+	zassert_ok(prewatchdog_test_last(&snap), NULL);
+	zassert_true(snap.recovered, NULL);
+	zassert_true(snap.thread_count > 1U, "thread walk never ran");
+	zassert_str_equal(snap.thread, "hog", NULL);
+}
+
+ZTEST_SUITE(watchdog_ctrl_suite, NULL, NULL, watchdog_fixture_reset, NULL, NULL);
@@ -1,5 +1,11 @@
 #!/usr/bin/env python3
-"""UART helper for provisioning Curve25519 scalars/peers."""
+"""UART helper for provisioning Curve25519 scalars/peers.
+
+By default the material goes out as binary frames (CONFIG_APP_UART_FRAMES,
+see docs/uart_commands.md): every request is ACKed or NAKed by the
+firmware, and the public key it derives is read back and checked. --text
+falls back to the 'prov curve' line and log scraping for older images.
+"""
 
 from __future__ import annotations
 
@@ -31,6 +37,27 @@ DEFAULT_STORE_PATH = Path.home() / ".helium_provision" / "curve_keys.json"
 READY_MARKERS = ("EVT,UART_CMD,READY", "EVT,APP,READY")
 ACK_MARKERS = ("EVT,PROVISION,CURVE25519_UPDATED",)
 
+# Binary frames: SOF | LEN | OP | SEQ | payload | CRC16 LE (src/uart_frame.h).
+FRAME_SOF = 0xA5
+FRAME_RESPONSE = 0x80
+FRAME_MAX_BODY = 40
+OP_PING = 0x00
+OP_SET_SECRET = 0x01
+OP_SET_PEER = 0x02
+OP_READ_PUBKEY = 0x03
+OP_SET_OVERRIDE = 0x04
+FRAME_STATUS = {
+    0x00: "ok",
+    0x01: "bad CRC",
+    0x02: "bad length",
+    0x03: "unknown opcode",
+    0x04: "bad argument",
+    0x05: "unsupported by this image",
+    0x06: "storage failure",
+}
+# NAKs worth resending: the request was damaged on the wire.
+FRAME_RETRY_STATUS = (0x01, 0x02)
+
 
 @dataclass
 class CurveMaterial:
@@ -134,7 +161,9 @@ def _interactive_generate(store_path: Path, should_store: bool) -> CurveMaterial
 
 
 def parse_args() -> argparse.Namespace:
-    parser = argparse.ArgumentParser(description="Send 'prov curve' over UART")
+    parser = argparse.ArgumentParser(
+        description="Provision Curve25519 material over UART (binary frames by default)"
+    )
     parser.add_argument("scalar", nargs="?", help="64-hex Curve25519 scalar")
     parser.add_argument("peer", nargs="?", help="Optional 64-hex peer public key")
     parser.add_argument("--scalar", dest="scalar_opt",
@@ -180,6 +209,42 @@ def parse_args() -> argparse.Namespace:
         type=Path,
         help="Send a raw command from this file instead of constructing 'prov curve …'.",
     )
+    parser.add_argument(
+        "--text",
+        action="store_true",
+        help="Send the ASCII 'prov curve …' line and scan the log for the result "
+             "instead of using binary frames (images without CONFIG_APP_UART_FRAMES).",
+    )
+    parser.add_argument(
+        "--override-ms",
+        type=int,
+        help="Also set the persistent watchdog override (binary frames only; "
+             "0 clears it).",
+    )
+    parser.add_argument(
+        "--no-verify",
+        dest="verify",
+        action="store_false",
+        help="Skip reading back the public key after a binary provisioning run.",
+    )
+    parser.add_argument(
+        "--frame-timeout",
+        type=float,
+        default=0.5,
+        help="Seconds to wait for each frame response (default: %(default)s).",
+    )
+    parser.add_argument(
+        "--retries",
+        type=int,
+        default=3,
+        help="Resends per frame on silence or a damaged request "
+             "(default: %(default)s).",
+    )
+    parser.add_argument(
+        "--verbose",
+        action="store_true",
+        help="Echo device log text seen between binary frames.",
+    )
     parser.add_argument(
         "--gdb-script",
         type=Path,
@@ -218,8 +283,8 @@ def parse_args() -> argparse.Namespace:
         "--wait",
         type=float,
         default=10.0,
-        help="Seconds to wait for device output (default: %(default)s). "
-             "Set to 0 to skip reading.",
+        help="Seconds to wait for device output in --text mode "
+             "(default: %(default)s). Set to 0 to skip reading.",
     )
     parser.add_argument(
         "--send-delay",
@@ -250,8 +315,8 @@ def parse_args() -> argparse.Namespace:
         "--ready-timeout",
         type=float,
         default=15.0,
-        help="Seconds to wait for UART ready markers when --wait-ready is enabled "
-             "(default: %(default)s).",
+        help="Seconds to wait for UART ready markers when --wait-ready is enabled, "
+             "or for a PING answer with binary frames (default: %(default)s).",
     )
     return parser.parse_args()
 
@@ -445,6 +510,201 @@ def _send_curve_command(
     )
 
 
+def _x25519_base(scalar: bytes) -> bytes:
+    """RFC 7748 X25519(scalar, 9): the public key the firmware should report."""
+    p = 2**255 - 19
+    k = bytearray(scalar)
+    k[0] &= 248
+    k[31] &= 127
+    k[31] |= 64
+    n = int.from_bytes(k, "little")
+    x1 = 9
+    x2, z2, x3, z3 = 1, 0, x1, 1
+    swap = 0
+    for t in reversed(range(255)):
+        bit = (n >> t) & 1
+        swap ^= bit
+        if swap:
+            x2, x3, z2, z3 = x3, x2, z3, z2
+        swap = bit
+        a = (x2 + z2) % p
+        aa = a * a % p
+        b = (x2 - z2) % p
+        bb = b * b % p
+        e = (aa - bb) % p
+        c = (x3 + z3) % p
+        d = (x3 - z3) % p
+        da = d * a % p
+        cb = c * b % p
+        x3 = (da + cb) ** 2 % p
+        z3 = x1 * (da - cb) ** 2 % p
+        x2 = aa * bb % p
+        z2 = e * (aa + 121665 * e) % p
+    if swap:
+        x2, z2 = x3, z3
+    return (x2 * pow(z2, p - 2, p) % p).to_bytes(CURVE_LEN, "little")
+
+
+def _frame_crc(data: bytes) -> int:
+    # CRC-16/XMODEM, same as crc16_itu_t(0, ...) on the target.
+    return binascii.crc_hqx(data, 0)
+
+
+def encode_frame(op: int, seq: int, payload: bytes = b"") -> bytes:
+    body = bytes((op, seq & 0xFF)) + payload
+    if len(body) > FRAME_MAX_BODY:
+        raise ValueError(f"frame body too long ({len(body)} bytes)")
+    covered = bytes((len(body),)) + body
+    return bytes((FRAME_SOF,)) + covered + _frame_crc(covered).to_bytes(2, "little")
+
+
+class FrameLink:
+    """Request/response over the CLI UART; log text around frames is skipped."""
+
+    def __init__(self, ser: serial.Serial, timeout: float, retries: int,
+                 verbose: bool) -> None:
+        self.ser = ser
+        self.timeout = timeout
+        self.retries = retries
+        self.verbose = verbose
+        self.seq = 0
+        self.rx = bytearray()
+
+    def _skip_text(self, count: int) -> None:
+        if count and self.verbose:
+            sys.stdout.write(self.rx[:count].decode(errors="ignore"))
+            sys.stdout.flush()
+        del self.rx[:count]
+
+    def _read_response(self, op: int, seq: int, deadline: float) -> tuple[int, bytes] | None:
+        while time.monotonic() < deadline:
+            chunk = self.ser.read(self.ser.in_waiting or 1)
+            if chunk:
+                self.rx += chunk
+            while True:
+                start = self.rx.find(FRAME_SOF)
+                if start < 0:
+                    self._skip_text(len(self.rx))
+                    break
+                self._skip_text(start)
+                if len(self.rx) < 2:
+                    break
+                body_len = self.rx[1]
+                if not 3 <= body_len <= FRAME_MAX_BODY:
+                    del self.rx[0]
+                    continue
+                total = 2 + body_len + 2
+                if len(self.rx) < total:
+                    break
+                frame = bytes(self.rx[:total])
+                crc = int.from_bytes(frame[-2:], "little")
+                if crc != _frame_crc(frame[1:-2]):
+                    # Not a frame after all, or a damaged one: resync past SOF.
+                    del self.rx[0]
+                    continue
+                del self.rx[:total]
+                if frame[2] == (op | FRAME_RESPONSE) and frame[3] == seq:
+                    return frame[4], frame[5:-2]
+        return None
+
+    def request(self, op: int, payload: bytes = b"", timeout: float | None = None
+                ) -> tuple[int, bytes] | None:
+        """Send until answered; returns (status, payload) or None on silence."""
+        reply = None
+        for _ in range(self.retries + 1):
+            self.seq = (self.seq + 1) & 0xFF
+            self.ser.write(encode_frame(op, self.seq, payload))
+            self.ser.flush()
+            reply = self._read_response(
+                op, self.seq, time.monotonic() + (timeout or self.timeout)
+            )
+            if reply is not None and reply[0] not in FRAME_RETRY_STATUS:
+                return reply
+        return reply
+
+
+def _frame_step(link: FrameLink, label: str, op: int, payload: bytes = b"") -> bytes | None:
+    start = time.monotonic()
+    reply = link.request(op, payload)
+    elapsed_ms = (time.monotonic() - start) * 1000.0
+    if reply is None:
+        print(f"error: {label}: no response", file=sys.stderr)
+        return None
+    status, data = reply
+    if status != 0:
+        reason = FRAME_STATUS.get(status, f"status {status}")
+        print(f"error: {label}: NAK ({reason})", file=sys.stderr)
+        return None
+    print(f"{label}: ACK ({elapsed_ms:.0f} ms)", file=sys.stderr)
+    return data
+
+
+def _wait_for_ping(link: FrameLink, timeout: float) -> bool:
+    """The firmware answers PING once its command thread runs."""
+    deadline = time.monotonic() + timeout
+    while True:
+        reply = link.request(OP_PING, timeout=0.25)
+        if reply is not None and reply[0] == 0:
+            version = reply[1][0] if reply[1] else 0
+            print(f"Device ready (frame protocol v{version})", file=sys.stderr)
+            return True
+        if time.monotonic() >= deadline:
+            return False
+
+
+def _provision_frames(
+    material: CurveMaterial,
+    device: str,
+    baud: int,
+    ready_timeout: float,
+    frame_timeout: float,
+    retries: int,
+    override_ms: int | None,
+    verify: bool,
+    verbose: bool,
+) -> bool:
+    start = time.monotonic()
+    print(f"Opening {device} @ {baud} baud…", file=sys.stderr)
+    with serial.Serial(device, baud, timeout=0.05) as ser:
+        ser.reset_input_buffer()
+        link = FrameLink(ser, timeout=frame_timeout, retries=retries, verbose=verbose)
+        if not _wait_for_ping(link, ready_timeout):
+            print(
+                "error: no PING answer; is this a provisioning build with "
+                "CONFIG_APP_UART_FRAMES=y? (--text uses the line protocol)",
+                file=sys.stderr,
+            )
+            return False
+
+        scalar = binascii.unhexlify(material.scalar)
+        if _frame_step(link, "set secret", OP_SET_SECRET, scalar) is None:
+            return False
+        if material.peer:
+            peer = binascii.unhexlify(material.peer)
+            if _frame_step(link, "set peer", OP_SET_PEER, peer) is None:
+                return False
+        if override_ms is not None:
+            value = override_ms.to_bytes(4, "little")
+            if _frame_step(link, "set override", OP_SET_OVERRIDE, value) is None:
+                return False
+        if verify:
+            public = _frame_step(link, "read public key", OP_READ_PUBKEY)
+            if public is None:
+                return False
+            expected = _x25519_base(scalar)
+            if public != expected:
+                print(
+                    f"error: device public key {public.hex()} does not match "
+                    f"expected {expected.hex()}",
+                    file=sys.stderr,
+                )
+                return False
+            print(f"Public key: {public.hex()}")
+
+    print(f"Provisioned in {time.monotonic() - start:.2f} s", file=sys.stderr)
+    return True
+
+
 def _python_gdb_block(symbol: str, label: str, hex_value: str) -> list[str]:
     return [
         "  python",
@@ -573,6 +833,9 @@ def main() -> int:
     else:
         store_path = args.store_path
 
+    if args.override_ms is not None and not 0 <= args.override_ms <= 0xFFFFFFFF:
+        raise SystemExit("error: --override-ms must fit in 32 bits.")
+
     if args.command_file is not None:
         if args.gdb_script is not None or args.gdb_run:
             raise SystemExit(
@@ -605,6 +868,20 @@ def main() -> int:
             )
         return 0
 
+    if not args.text and args.command_file is None:
+        ok = _provision_frames(
+            material,
+            device=args.device,
+            baud=args.baud,
+            ready_timeout=args.ready_timeout,
+            frame_timeout=args.frame_timeout,
+            retries=args.retries,
+            override_ms=args.override_ms,
+            verify=args.verify,
+            verbose=args.verbose,
+        )
+        return 0 if ok else 1
+
     _send_curve_command(
         material,
         device=args.device,